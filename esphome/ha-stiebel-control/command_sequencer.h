@@ -0,0 +1,175 @@
+/*
+ * CommandSequencer — ordered multi-signal write transactions, never blocking.
+ *
+ * No ESPHome dependencies. A transaction is a short list of writes that must
+ * reach the heat pump in order: the setpoints of an SG Ready transition, or
+ * hour, minute and second of the clock. The sequencer hands out one write at
+ * a time and moves on only once the readback of that write returned the
+ * written value. A write not confirmed within the step timeout is handed out
+ * again; once its attempts are used up the transaction fails and its
+ * remaining writes are dropped. The host sends the writes, feeds the values
+ * it receives back in and collects the results. Nothing here waits, so
+ * loop() never stalls. Storage is fixed; nothing allocates.
+ */
+
+#ifndef COMMAND_SEQUENCER_H
+#define COMMAND_SEQUENCER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "request_scheduler.h"
+
+// One write of a transaction
+struct SequenceStep {
+    uint16_t index;     // Elster index
+    uint16_t value;     // raw value to write, and to expect back
+    uint8_t member;     // CanMemberType of the addressed member
+    bool exact;         // only the written value confirms; else any value read back
+};
+
+struct CommandTransaction {
+    static constexpr uint8_t MAX_STEPS = 4;
+
+    const char* name;   // for logs and results; must outlive the transaction
+    SequenceStep steps[MAX_STEPS] = {};
+    uint8_t count = 0;
+
+    // Append a write. A running value such as the clock's seconds is not
+    // read back as written; pass exact = false for it. Returns false once
+    // MAX_STEPS are taken.
+    bool add(uint8_t member, uint16_t index, uint16_t value, bool exact = true) {
+        if (count >= MAX_STEPS)
+            return false;
+        steps[count++] = {index, value, member, exact};
+        return true;
+    }
+};
+
+// Outcome of a finished transaction
+struct SequenceResult {
+    const char* name;
+    bool ok;
+    uint8_t confirmed;      // steps confirmed
+    uint8_t count;          // steps in the transaction
+    uint32_t durationMs;    // from its first write to the last confirmation or the failure
+};
+
+// Runs up to N queued transactions one after the other
+template <size_t N>
+class CommandSequencer {
+public:
+    // A write is handed out up to `attempts` times, each waiting `stepTimeoutMs`
+    // for its confirmation. Drops all queued transactions.
+    void configure(uint32_t stepTimeoutMs, uint8_t attempts) {
+        stepTimeoutMs_ = stepTimeoutMs;
+        attempts_ = attempts > 0 ? attempts : 1;
+        head_ = 0;
+        size_ = 0;
+        resultCount_ = 0;
+    }
+
+    bool busy() const { return size_ > 0; }
+    size_t size() const { return size_; }
+
+    // Queue a transaction behind the running ones. Returns false if it has
+    // no steps or the queue is full.
+    bool submit(const CommandTransaction& transaction) {
+        if (transaction.count == 0 || size_ >= N)
+            return false;
+        Running& r = queue_[(head_ + size_) % N];
+        r.transaction = transaction;
+        r.step = 0;
+        r.attempts = 0;
+        r.waiting = false;
+        size_++;
+        return true;
+    }
+
+    // The write to send at `now`: the next step of the running transaction,
+    // or a step again whose confirmation timed out. Returns false while a
+    // write awaits its confirmation or nothing is queued.
+    bool nextWrite(uint32_t now, SequenceStep& out) {
+        while (size_ > 0) {
+            Running& r = queue_[head_];
+            if (r.waiting) {
+                if (!deadlineReached(now, r.sentMs + stepTimeoutMs_))
+                    return false;
+                if (r.attempts >= attempts_) {
+                    finish(false, now);
+                    continue;
+                }
+            }
+            if (r.step == 0 && r.attempts == 0)
+                r.startedMs = now;
+            r.attempts++;
+            r.waiting = true;
+            r.sentMs = now;
+            out = r.transaction.steps[r.step];
+            return true;
+        }
+        return false;
+    }
+
+    // A value of `index` from `member` arrived at `now`. It confirms the
+    // awaited step if it is the written value (any value for a step that is
+    // not exact); other values are ignored, as a poll sent before the write
+    // may still be answered with the old one.
+    void onValue(uint8_t member, uint16_t index, uint16_t value, uint32_t now) {
+        if (size_ == 0)
+            return;
+        Running& r = queue_[head_];
+        const SequenceStep& step = r.transaction.steps[r.step];
+        if (!r.waiting || step.member != member || step.index != index || (step.exact && step.value != value))
+            return;
+        r.step++;
+        r.attempts = 0;
+        r.waiting = false;
+        if (r.step >= r.transaction.count)
+            finish(true, now);
+    }
+
+    // Take the oldest result not taken yet. Returns false if there is none.
+    bool takeResult(SequenceResult& out) {
+        if (resultCount_ == 0)
+            return false;
+        out = results_[0];
+        for (size_t i = 1; i < resultCount_; i++)
+            results_[i - 1] = results_[i];
+        resultCount_--;
+        return true;
+    }
+
+private:
+    struct Running {
+        CommandTransaction transaction;
+        uint32_t startedMs;
+        uint32_t sentMs;
+        uint8_t step;       // step awaiting its confirmation or next to send
+        uint8_t attempts;   // sends of that step
+        bool waiting;       // sent and not confirmed yet
+    };
+
+    // Record the result of the running transaction and start the next one.
+    // With all result slots taken the oldest result is dropped.
+    void finish(bool ok, uint32_t now) {
+        const Running& r = queue_[head_];
+        if (resultCount_ >= N) {
+            SequenceResult dropped;
+            takeResult(dropped);
+        }
+        results_[resultCount_++] = {r.transaction.name, ok, r.step, r.transaction.count, now - r.startedMs};
+        head_ = (head_ + 1) % N;
+        size_--;
+    }
+
+    Running queue_[N] = {};
+    SequenceResult results_[N] = {};
+    size_t head_ = 0;
+    size_t size_ = 0;
+    size_t resultCount_ = 0;
+    uint32_t stepTimeoutMs_ = 0;
+    uint8_t attempts_ = 1;
+};
+
+#endif // COMMAND_SEQUENCER_H
@@ -15,8 +15,109 @@
 // Delay after boot before starting signal requests (milliseconds)
 #define STARTUP_DELAY_MS 30000
 
-// Maximum number of requests to send per iteration (rate limiting)
-#define MAX_REQUESTS_PER_ITERATION 1
+// Request budget: read requests per second the request manager may send.
+// Each request is answered by one response frame, so the bus carries about
+// twice as many frames. A 20 kbit/s Elster bus carries roughly 150 frames/s.
+#define REQUEST_BUDGET_FRAMES_PER_SEC 10
+
+// Minimum gap between two request frames (milliseconds)
+#define REQUEST_MIN_GAP_MS 20
+
+// Adaptive request budget: once per window the measured bus utilisation
+// (all frames seen and sent) halves the budget above BUS_LOAD_HIGH_PERCENT or
+// at BUS_LOAD_ARB_LOST_LIMIT lost arbitrations, and raises it by one frame
+// per second below BUS_LOAD_LOW_PERCENT. REQUEST_BUDGET_FRAMES_PER_SEC is
+// the start value.
+#define CAN_BIT_RATE 20000
+#define BUS_LOAD_WINDOW_MS 1000
+#define BUS_LOAD_HIGH_PERCENT 50
+#define BUS_LOAD_LOW_PERCENT 30
+#define BUS_LOAD_ARB_LOST_LIMIT 3
+#define REQUEST_BUDGET_MIN_FRAMES_PER_SEC 2
+#define REQUEST_BUDGET_MAX_FRAMES_PER_SEC 30
+
+// Response timeout of a read request (milliseconds). An unanswered request is
+// sent again up to REQUEST_MAX_RETRIES times before it counts as timed out.
+// At most REQUEST_TRACKER_SIZE requests are awaited at the same time.
+#define REQUEST_TIMEOUT_MS 2000
+#define REQUEST_MAX_RETRIES 1
+#define REQUEST_TRACKER_SIZE 32
+
+// Signals requested from all members (cm_other) are learned per member: once
+// each member was asked more than RESPONDER_LEARN_PROBES times, only the ones
+// that returned a valid value keep their interval, the others are re-probed
+// every RESPONDER_REPROBE_INTERVAL seconds. A signal no member answered in
+// RESPONDER_LEARN_ROUNDS such rounds is re-probed on all of them at that rate.
+// The learned members of up to RESPONDER_MAP_SIZE signals are kept in NVS.
+#define RESPONDER_LEARN_PROBES 5
+#define RESPONDER_LEARN_ROUNDS 3
+#define RESPONDER_REPROBE_INTERVAL FREQ_60MIN
+#define RESPONDER_MAP_SIZE 48
+
+// A slot whose last QUARANTINE_MISSES requests stayed unanswered or returned
+// no value (0x8000) is quarantined: each further miss doubles its interval,
+// up to QUARANTINE_MAX_INTERVAL seconds. The first valid value restores it.
+#define QUARANTINE_MISSES 3
+#define QUARANTINE_MAX_INTERVAL (6 * FREQ_60MIN)
+
+// Signals per poll group (pollGroup in signalRequests); rows beyond it are
+// polled on their own
+#define POLL_GROUP_MAX_SIGNALS 6
+
+// Transmit lanes, served in this order: writes (HA /set, SG Ready), their
+// confirming readbacks, periodic polls, background probes (members that do
+// not answer a cm_other signal, quarantined slots). Every lane has its own
+// budget in frames per second; all share the request budget and gap above,
+// so a write waits at most one frame interval of it however full the poll
+// table is. Up to TX_QUEUE_SIZE writes or one-off reads wait per lane. A write
+// whose readback has not arrived after COMMAND_CONFIRM_TIMEOUT_MS is unconfirmed.
+#define TX_LANE_COMMAND_FRAMES_PER_SEC 5
+#define TX_LANE_CONFIRM_FRAMES_PER_SEC 5
+#define TX_LANE_POLL_FRAMES_PER_SEC REQUEST_BUDGET_MAX_FRAMES_PER_SEC
+#define TX_LANE_PROBE_FRAMES_PER_SEC 1
+#define TX_QUEUE_SIZE 16
+#define COMMAND_CONFIRM_TIMEOUT_MS 5000
+
+// Writes that belong together (an SG Ready transition, the date/time buttons)
+// run as a transaction: each write is sent once the previous one was read back
+// with its value. A write not confirmed within SEQUENCE_STEP_TIMEOUT_MS is sent
+// again, up to SEQUENCE_STEP_ATTEMPTS times in all; then the transaction fails
+// and its remaining writes are dropped. Up to SEQUENCE_QUEUE_SIZE transactions
+// wait in order.
+#define SEQUENCE_STEP_TIMEOUT_MS COMMAND_CONFIRM_TIMEOUT_MS
+#define SEQUENCE_STEP_ATTEMPTS 2
+#define SEQUENCE_QUEUE_SIZE 4
+
+// Size of the buffer MQTT discovery payloads are built in (bytes). A payload
+// that does not fit is logged and not published.
+#define DISCOVERY_PAYLOAD_SIZE 1024
+
+// Size of the buffer the request period report of all schedule slots is built
+// in (bytes, about 55 per slot). Slots beyond it are left out and the report
+// is flagged truncated.
+#define REQUEST_PERIODS_PAYLOAD_SIZE 3072
+
+// The UID, state topic and discovery topic of every published signal are
+// formatted once and kept in blocks of this many bytes (about 8 signals each)
+#define SIGNAL_NAME_BLOCK_SIZE 1024
+
+// A discovery republish (every 15 minutes, when Home Assistant announces its
+// start on homeassistant/status, on heatingpump/republish_discoveries) walks
+// every known entity and publishes at most DISCOVERY_REPUBLISH_PER_SEC
+// discovery configs per second. Its progress goes to
+// heatingpump/discovery_republish/state every DISCOVERY_REPUBLISH_PROGRESS_MS.
+#define DISCOVERY_REPUBLISH_PER_SEC 5
+#define DISCOVERY_REPUBLISH_PROGRESS_MS 1000
+
+// A received value is published only if it differs from the last published
+// state of its entity: temperatures by more than STATE_DEADBAND_TEMPERATURE
+// (in K), all other signals by more than STATE_DEADBAND_DEFAULT (0 = any
+// change). A row of signalRequests can set its own deadband. An unchanged
+// value is still published once its entity was silent for
+// STATE_HEARTBEAT_INTERVAL seconds.
+#define STATE_DEADBAND_TEMPERATURE 0.1f
+#define STATE_DEADBAND_DEFAULT 0.0f
+#define STATE_HEARTBEAT_INTERVAL FREQ_10MIN
 
 // ============================================================================
 // TIMING INTERVALS (for use in signalRequests table)
@@ -54,6 +155,9 @@
 // CAN diagnostic sensors update frequency (ESP32-S3 / TWAI only)
 #define CALC_CAN_DIAG_FREQUENCY FREQ_30S
 
+// Achieved vs. configured request period diagnostics update frequency
+#define CALC_REQUEST_PERIOD_FREQUENCY FREQ_5MIN
+
 // ============================================================================
 // COP CALCULATION SETTINGS
 // ============================================================================
@@ -37,7 +37,7 @@
 
   #define High(A)     (sizeof(A)/sizeof(A[0]) - 1)
 
-static const char * ElsterTypeStr[] =
+static constexpr const char * ElsterTypeStr[] =
 {
   "et_default",
   "et_dec_val",
@@ -58,6 +58,9 @@ static const char * ElsterTypeStr[] =
   "et_dev_id"
 };
 
+// Source row as maintained in ElsterTableRows below. Only evaluated at compile
+// time: KElsterTable.cpp splits it into the compact ElsterIndex rows and the
+// sparse ElsterMetadata table, so the wide rows never end up in the image.
 typedef struct
 {
   const char * Name;
@@ -77,8 +80,31 @@ typedef struct
   // Flags
   bool isBlacklisted;           // true = skip all processing
   bool hasMetadata;             // true = use struct metadata, false = use defaults
+} ElsterTableRow;
+
+// Runtime row: only the fields needed to decode a frame. 12 bytes on ESP32.
+typedef struct
+{
+  const char * Name;
+  unsigned short Index;
+  unsigned char Type;
+  bool isBlacklisted;           // true = skip all processing
+  unsigned short metadataSlot;  // 0 = no metadata, see GetElsterMetadata()
 } ElsterIndex;
 
+// Home Assistant metadata of rows with hasMetadata set (field meaning as above)
+typedef struct
+{
+  const char * friendlyName;
+  const char * haComponent;
+  const char * haDeviceClass;
+  const char * unit;
+  const char * stateClass;
+  const char * icon;
+  const char * payloadOn;
+  const char * payloadOff;
+} ElsterMetadata;
+
 typedef enum
 {
   // Die Reihenfolge muss mit ElsterTypeStr übereinstimmen!
@@ -107,7 +133,7 @@ typedef struct
   const char * Name;
 } ErrorIndex;
 
-static const ElsterIndex ElsterTable[] =
+static constexpr ElsterTableRow ElsterTableRows[] =
 {
 //  Name                                                 Index   Type
 //  Struktur-Definition in KElsterTable.h 
@@ -3793,7 +3819,13 @@ static const ElsterIndex ElsterTable[] =
   { "INFOBLOCK_6", 0xfe07, 0, "Infoblock 6", NULL, NULL, NULL, NULL, NULL, NULL, NULL, false, false },
 };
 
-static const ErrorIndex ErrorList[] =
+// The compact runtime table, ElsterTableCount rows in ElsterTableRows order,
+// INDEX_NOT_FOUND first. Defined once in KElsterTable.cpp: every row, or only
+// the model's signal set when the build defines ELSTER_SIGNAL_SET.
+extern const ElsterIndex * const ElsterTable;
+extern const unsigned ElsterTableCount;
+
+static constexpr ErrorIndex ErrorList[] =
 {
   { 0x0002, "Schuetz klebt"},
   { 0x0003, "ERR HD-SENSOR"},
@@ -3821,7 +3853,7 @@ static const ErrorIndex ErrorList[] =
   { 0x0021, "KEINE LEISTUNG"}
 };
 
-static const ErrorIndex BetriebsartList[] =
+static constexpr ErrorIndex BetriebsartList[] =
 {
   { 0x0000, "Notbetrieb" },
   { 0x0100, "Bereitschaft" }, 
@@ -18,43 +18,511 @@
  */
 
 
+#include <math.h>
 #include <string.h>
-#include <unordered_map>
-#include <string>
 #include "NUtils.h"
 #include "KElsterTable.h"
 #include "ElsterTable.h"
 
-// Lazy-initialized caches for O(1) lookups after first access
-static std::unordered_map<unsigned short, const ElsterIndex*> indexCache;
-static std::unordered_map<std::string, const ElsterIndex*> nameCache;
+// Per-model signal set: when the build defines ELSTER_SIGNAL_SET (a header
+// name, see signal_set_wpl13e.h), the runtime table only keeps the rows named
+// in ElsterSignalSet. Without it every row of ElsterTableRows is kept.
+#if defined(ELSTER_SIGNAL_SET)
+  #include ELSTER_SIGNAL_SET
+#endif
 
+static constexpr unsigned cElsterSourceRows = High(ElsterTableRows) + 1;
+
+static constexpr int CompareNames(const char * a, const char * b)
+{
+  while (*a && *a == *b)
+  {
+    a++;
+    b++;
+  }
+  return (unsigned char) *a - (unsigned char) *b;
+}
+
+// Heapsort of table positions: O(n log n) keeps the compile-time evaluation
+// well inside the compiler's constexpr operation limits.
+template <typename Less>
+static constexpr void SiftDown(unsigned short * pos, unsigned root, unsigned end, Less less)
+{
+  while (2*root + 1 < end)
+  {
+    unsigned child = 2*root + 1;
+    if (child + 1 < end && less(pos[child], pos[child + 1]))
+      child++;
+    if (!less(pos[root], pos[child]))
+      return;
+    unsigned short tmp = pos[root];
+    pos[root] = pos[child];
+    pos[child] = tmp;
+    root = child;
+  }
+}
+
+template <typename Less>
+static constexpr void SortPositions(unsigned short * pos, unsigned count, Less less)
+{
+  for (unsigned i = count / 2; i-- > 0; )
+    SiftDown(pos, i, count, less);
+  for (unsigned end = count; end-- > 1; )
+  {
+    unsigned short tmp = pos[0];
+    pos[0] = pos[end];
+    pos[end] = tmp;
+    SiftDown(pos, 0, end, less);
+  }
+}
+
+struct ElsterRowSelection
+{
+  bool Keep[cElsterSourceRows];
+  unsigned Count;
+};
+
+static constexpr ElsterRowSelection SelectElsterRows()
+{
+  ElsterRowSelection sel {};
+  for (unsigned i = 0; i < cElsterSourceRows; i++)
+  {
+  #if defined(ELSTER_SIGNAL_SET)
+    // INDEX_NOT_FOUND is always kept: it is the "not found" result.
+    bool keep = i == 0;
+    for (const char * name : ElsterSignalSet)
+      if (!keep && !CompareNames(name, ElsterTableRows[i].Name))
+        keep = true;
+  #else
+    bool keep = true;
+  #endif
+    sel.Keep[i] = keep;
+    if (keep)
+      sel.Count++;
+  }
+  return sel;
+}
+
+static constexpr ElsterRowSelection ElsterSelection = SelectElsterRows();
+static constexpr unsigned cElsterRowCount = ElsterSelection.Count;
+
+#if defined(ELSTER_SIGNAL_SET)
+static constexpr bool AllSignalsKnown()
+{
+  for (const char * name : ElsterSignalSet)
+  {
+    bool found = false;
+    for (unsigned i = 0; i < cElsterSourceRows && !found; i++)
+      found = !CompareNames(name, ElsterTableRows[i].Name);
+    if (!found)
+      return false;
+  }
+  return true;
+}
+
+static_assert(AllSignalsKnown(), "ElsterSignalSet names a signal that is not in ElsterTableRows");
+#endif
+
+// Hot/cold split: ElsterTableRows is only read at compile time. Decoding needs
+// Name, Index, Type and the blacklist flag of every row, the Home Assistant
+// metadata is needed by a few dozen rows and only for discovery. The compact
+// rows go into ElsterData.Rows, the metadata of rows with hasMetadata set into
+// ElsterData.Metadata, referenced by a 16 bit slot. Slot 0 means "no metadata".
+static constexpr unsigned CountElsterMetadata()
+{
+  unsigned count = 1;
+  for (unsigned i = 0; i < cElsterSourceRows; i++)
+    if (ElsterSelection.Keep[i] && ElsterTableRows[i].hasMetadata)
+      count++;
+  return count;
+}
+
+static constexpr unsigned cElsterMetadataCount = CountElsterMetadata();
+static_assert(cElsterMetadataCount <= 0xffff, "metadata slots must fit into 16 bits");
+
+struct ElsterTableData
+{
+  ElsterIndex Rows[cElsterRowCount];
+  ElsterMetadata Metadata[cElsterMetadataCount];
+};
+
+static constexpr ElsterTableData BuildElsterTableData()
+{
+  ElsterTableData data {};
+  unsigned next = 0;
+  unsigned nextMeta = 1;
+  for (unsigned i = 0; i < cElsterSourceRows; i++)
+  {
+    if (!ElsterSelection.Keep[i])
+      continue;
+
+    const ElsterTableRow & src = ElsterTableRows[i];
+    ElsterIndex & row = data.Rows[next++];
+    row.Name = src.Name;
+    row.Index = src.Index;
+    row.Type = src.Type;
+    row.isBlacklisted = src.isBlacklisted;
+    if (src.hasMetadata)
+    {
+      ElsterMetadata & meta = data.Metadata[nextMeta];
+      meta.friendlyName = src.friendlyName;
+      meta.haComponent = src.haComponent;
+      meta.haDeviceClass = src.haDeviceClass;
+      meta.unit = src.unit;
+      meta.stateClass = src.stateClass;
+      meta.icon = src.icon;
+      meta.payloadOn = src.payloadOn;
+      meta.payloadOff = src.payloadOff;
+      row.metadataSlot = (unsigned short) nextMeta++;
+    }
+  }
+  return data;
+}
+
+static constexpr ElsterTableData ElsterData = BuildElsterTableData();
+
+const ElsterIndex * const ElsterTable = ElsterData.Rows;
+const unsigned ElsterTableCount = cElsterRowCount;
+
+// Index lookup: two-level page table, built at compile time and kept in flash.
+// The high byte of an Elster index selects a page through ElsterPageDir, the
+// low byte selects the ElsterTable position within that page. Position 0 is
+// INDEX_NOT_FOUND, so unused slots need no extra marker. Only the pages that
+// actually occur in ElsterTable are stored.
+static constexpr unsigned char cNoPage = 0xff;
+
+static constexpr unsigned CountElsterPages()
+{
+  bool used[256] = {};
+  unsigned count = 0;
+  for (unsigned i = 0; i < cElsterRowCount; i++)
+  {
+    unsigned page = ElsterData.Rows[i].Index >> 8;
+    if (!used[page])
+    {
+      used[page] = true;
+      count++;
+    }
+  }
+  return count;
+}
+
+static constexpr unsigned cElsterPageCount = CountElsterPages();
+static_assert(cElsterPageCount < cNoPage, "too many index pages for an 8 bit page directory");
+static_assert(cElsterSourceRows <= 0xffff, "ElsterTable positions must fit into 16 bits");
+
+struct ElsterIndexPages
+{
+  unsigned char Dir[256];
+  unsigned short Slot[cElsterPageCount][256];
+};
+
+static constexpr ElsterIndexPages BuildElsterIndexPages()
+{
+  ElsterIndexPages pages {};
+  for (unsigned page = 0; page < 256; page++)
+    pages.Dir[page] = cNoPage;
+
+  unsigned next = 0;
+  for (unsigned i = 0; i < cElsterRowCount; i++)
+  {
+    unsigned short Index = ElsterData.Rows[i].Index;
+    unsigned page = Index >> 8;
+    if (pages.Dir[page] == cNoPage)
+      pages.Dir[page] = (unsigned char) next++;
+
+    // Same result as a linear scan: the first row with a given index wins,
+    // and index 0x0000 always resolves to the INDEX_NOT_FOUND row.
+    unsigned short & slot = pages.Slot[pages.Dir[page]][Index & 0xff];
+    if (i > 0 && Index != ElsterData.Rows[0].Index && slot == 0)
+      slot = (unsigned short) i;
+  }
+  return pages;
+}
+
+static constexpr ElsterIndexPages ElsterPages = BuildElsterIndexPages();
+
+#if defined(ELSTER_SIGNAL_SET)
+// Type fallback for rows outside the signal set: frames for them still decode
+// with the right type, but resolve to a blacklisted "UNLISTED" row, so they
+// are logged and never published. Rows of type et_default need no entry,
+// INDEX_NOT_FOUND decodes them the same way. Sorted by index, first row wins.
+static constexpr bool UnlistedLess(unsigned short a, unsigned short b)
+{
+  return ElsterTableRows[a].Index < ElsterTableRows[b].Index ||
+         (ElsterTableRows[a].Index == ElsterTableRows[b].Index && a < b);
+}
+
+struct ElsterUnlistedOrder
+{
+  unsigned short Pos[cElsterSourceRows];
+  unsigned Count;
+};
+
+static constexpr ElsterUnlistedOrder BuildElsterUnlistedOrder()
+{
+  ElsterUnlistedOrder order {};
+  for (unsigned i = 0; i < cElsterSourceRows; i++)
+    if (!ElsterSelection.Keep[i])
+      order.Pos[order.Count++] = (unsigned short) i;
+  SortPositions(order.Pos, order.Count, UnlistedLess);
+
+  unsigned count = 0;
+  for (unsigned n = 0; n < order.Count; n++)
+  {
+    const ElsterTableRow & row = ElsterTableRows[order.Pos[n]];
+    if (n > 0 && ElsterTableRows[order.Pos[n - 1]].Index == row.Index)
+      continue;
+    unsigned char page = ElsterPages.Dir[row.Index >> 8];
+    if (row.Type == et_default || (page != cNoPage && ElsterPages.Slot[page][row.Index & 0xff]))
+      continue;
+    order.Pos[count++] = order.Pos[n];
+  }
+  order.Count = count;
+  return order;
+}
+
+static constexpr ElsterUnlistedOrder ElsterUnlisted = BuildElsterUnlistedOrder();
+static constexpr unsigned cElsterTypeMapCount = ElsterUnlisted.Count > 0 ? ElsterUnlisted.Count : 1;
+
+// One blacklisted UNLISTED row per unlisted index, sorted by index. Each keeps
+// the real index, so a response to it still matches its request.
+struct ElsterTypeMap
+{
+  ElsterIndex Unlisted[cElsterTypeMapCount];
+};
+
+static constexpr ElsterTypeMap BuildElsterTypeMap()
+{
+  ElsterTypeMap map {};
+  for (unsigned n = 0; n < ElsterUnlisted.Count; n++)
+  {
+    const ElsterTableRow & row = ElsterTableRows[ElsterUnlisted.Pos[n]];
+    map.Unlisted[n].Name = "UNLISTED";
+    map.Unlisted[n].Index = row.Index;
+    map.Unlisted[n].Type = row.Type;
+    map.Unlisted[n].isBlacklisted = true;
+  }
+  return map;
+}
+
+static constexpr ElsterTypeMap ElsterTypes = BuildElsterTypeMap();
+
+static const ElsterIndex * GetUnlistedIndex(unsigned short Index)
+{
+  unsigned lo = 0;
+  unsigned hi = ElsterUnlisted.Count;
+  while (lo < hi)
+  {
+    unsigned mid = (lo + hi) / 2;
+    if (ElsterTypes.Unlisted[mid].Index < Index)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  if (lo < ElsterUnlisted.Count && ElsterTypes.Unlisted[lo].Index == Index)
+    return &ElsterTypes.Unlisted[lo];
+
+  return &ElsterTable[0];
+}
+#endif
+
+// Name lookup: ElsterTable positions sorted by name, built at compile time and
+// kept in flash. GetElsterIndex(const char *) binary searches it without
+// allocating and without a RAM cache. Equal names keep their table order, so
+// the first row with a given name wins just like with a linear scan.
+static constexpr bool NameLess(unsigned short a, unsigned short b)
+{
+  int cmp = CompareNames(ElsterData.Rows[a].Name, ElsterData.Rows[b].Name);
+  return cmp < 0 || (cmp == 0 && a < b);
+}
+
+struct ElsterNameOrder
+{
+  unsigned short Pos[cElsterRowCount];
+};
+
+static constexpr ElsterNameOrder BuildElsterNameOrder()
+{
+  ElsterNameOrder order {};
+  for (unsigned i = 0; i < cElsterRowCount; i++)
+    order.Pos[i] = (unsigned short) i;
+  SortPositions(order.Pos, cElsterRowCount, NameLess);
+  return order;
+}
+
+static constexpr ElsterNameOrder ElsterNames = BuildElsterNameOrder();
+
+// Error numbers: ErrorList indexed by number, built at compile time. The
+// numbers are small, so et_err_nr decodes with one array access. The first
+// entry with a given number wins, like with a linear scan.
+static constexpr unsigned CountErrorNames()
+{
+  unsigned count = 0;
+  for (const ErrorIndex & err : ErrorList)
+    if (err.Index >= count)
+      count = err.Index + 1u;
+  return count;
+}
+
+static constexpr unsigned cErrorNameCount = CountErrorNames();
+static_assert(cErrorNameCount <= 0x100, "ErrorList numbers must stay small for a direct table");
+
+struct ErrorNameTable
+{
+  const char * Name[cErrorNameCount];
+};
+
+static constexpr ErrorNameTable BuildErrorNames()
+{
+  ErrorNameTable table {};
+  for (const ErrorIndex & err : ErrorList)
+    if (!table.Name[err.Index])
+      table.Name[err.Index] = err.Name;
+  return table;
+}
+
+static constexpr ErrorNameTable ErrorNames = BuildErrorNames();
+
+// Betriebsart: decoding indexes BetriebsartList by the high byte, encoding
+// binary searches the names in sorted order. No name is a prefix of another,
+// so the only name that can start the input is the greatest name <= input.
+// Returns str behind prefix, NULL when str does not start with prefix.
+static constexpr const char * SkipPrefix(const char * prefix, const char * str)
+{
+  while (*prefix && *prefix == *str)
+  {
+    prefix++;
+    str++;
+  }
+  return *prefix ? nullptr : str;
+}
+
+static constexpr bool BetriebsartListValid()
+{
+  for (unsigned i = 0; i <= High(BetriebsartList); i++)
+  {
+    if (BetriebsartList[i].Index != i << 8)
+      return false;
+    for (unsigned k = 0; k <= High(BetriebsartList); k++)
+      if (k != i && SkipPrefix(BetriebsartList[i].Name, BetriebsartList[k].Name))
+        return false;
+  }
+  return true;
+}
+
+static_assert(BetriebsartListValid(), "BetriebsartList[i] needs index i << 8 and prefix-free names");
+
+static constexpr bool BetriebsartLess(unsigned short a, unsigned short b)
+{
+  return CompareNames(BetriebsartList[a].Name, BetriebsartList[b].Name) < 0;
+}
+
+struct BetriebsartNameOrder
+{
+  unsigned short Pos[High(BetriebsartList) + 1];
+};
+
+static constexpr BetriebsartNameOrder BuildBetriebsartNameOrder()
+{
+  BetriebsartNameOrder order {};
+  for (unsigned i = 0; i <= High(BetriebsartList); i++)
+    order.Pos[i] = (unsigned short) i;
+  SortPositions(order.Pos, High(BetriebsartList) + 1, BetriebsartLess);
+  return order;
+}
+
+static constexpr BetriebsartNameOrder BetriebsartNames = BuildBetriebsartNameOrder();
+
+// Type names: ElsterTypeStr positions sorted by name for GetElsterType.
+static constexpr bool TypeNameLess(unsigned short a, unsigned short b)
+{
+  return CompareNames(ElsterTypeStr[a], ElsterTypeStr[b]) < 0;
+}
+
+struct ElsterTypeNameOrder
+{
+  unsigned short Pos[High(ElsterTypeStr) + 1];
+};
+
+static constexpr ElsterTypeNameOrder BuildElsterTypeNameOrder()
+{
+  ElsterTypeNameOrder order {};
+  for (unsigned i = 0; i <= High(ElsterTypeStr); i++)
+    order.Pos[i] = (unsigned short) i;
+  SortPositions(order.Pos, High(ElsterTypeStr) + 1, TypeNameLess);
+  return order;
+}
+
+static constexpr ElsterTypeNameOrder ElsterTypeNames = BuildElsterTypeNameOrder();
+
+
+// Same text as sprintf(Val, "%.<Decimals>f", Value / 10^Decimals), but in
+// integer arithmetic: a 16 bit value scaled by 10, 100 or 1000 is exact in
+// decimal, so its digits can be written directly without soft-float double
+// math or the printf machinery. Returns the end of the string; at most 8
+// characters ("-3276.8", "-32.768", "65535") plus the terminator are written.
+static char * SetFixedValue(char * Val, long Value, unsigned Decimals)
+{
+  char buf[12];
+  char * p = buf + sizeof(buf);
+  unsigned long mag = Value < 0 ? 0ul - (unsigned long) Value : (unsigned long) Value;
+
+  for (unsigned i = 0; i < Decimals; i++)
+  {
+    *--p = (char) ('0' + mag % 10);
+    mag /= 10;
+  }
+  if (Decimals)
+    *--p = '.';
+  do
+  {
+    *--p = (char) ('0' + mag % 10);
+    mag /= 10;
+  } while (mag);
+  if (Value < 0)
+    *--p = '-';
+
+  unsigned len = (unsigned) (buf + sizeof(buf) - p);
+  memcpy(Val, p, len);
+  Val[len] = 0;
+  return Val + len;
+}
 
 void SetValueType(char * Val, unsigned char Type, unsigned short Value)
 {
+   // et_double_val and et_triple_val carry the raw unsigned value (there is no
+   // 0x8000 sentinel for them), formatted like sprintf("%.3f") / ("%.6f").
+   if (Type == et_double_val)
+     strcpy(SetFixedValue(Val, Value, 0), ".000");
+   else
+   if (Type == et_triple_val)
+     strcpy(SetFixedValue(Val, Value, 0), ".000000");
+   else
    if (Value == 0x8000)
      strcpy(Val, "-255");
    else
    switch (Type)
    {
      case et_byte:
-       sprintf(Val, "%d", (signed char)Value);
+       SetFixedValue(Val, (signed char)Value, 0);
        break;
 
      case et_dec_val:
-       sprintf(Val, "%.1f", ((double)((signed short)Value)) / 10.0);
+       SetFixedValue(Val, (signed short)Value, 1);
        break;
 
      case et_cent_val:
-       sprintf(Val, "%.2f", ((double)((signed short)Value)) / 100.0);
+       SetFixedValue(Val, (signed short)Value, 2);
        break;
 
      case et_mil_val:
-       sprintf(Val, "%.3f", ((double)((signed short)Value)) / 1000.0);
+       SetFixedValue(Val, (signed short)Value, 3);
        break;
 
      case et_little_endian:
-       sprintf(Val, "%d", (Value >> 8) + 256*(Value & 0xff));
+       SetFixedValue(Val, (Value >> 8) + 256*(Value & 0xff), 0);
        break;
        
      case et_little_bool:
@@ -105,7 +573,7 @@ void SetValueType(char * Val, unsigned char Type, unsigned short Value)
        if (Value >= 0x80)
          strcpy(Val, "--");
        else
-         sprintf(Val, "%d", Value + 1);
+         SetFixedValue(Val, Value + 1, 0);
        break;
 
      case et_dev_id:
@@ -113,24 +581,15 @@ void SetValueType(char * Val, unsigned char Type, unsigned short Value)
        break;
 
      case et_err_nr:
-     {
-       int idx = -1;
-       for (unsigned i = 0; i <= High(ErrorList); i++)
-         if (ErrorList[i].Index == Value)
-         {
-           idx = i;
-           break;
-         }
-       if (idx >= 0)
-         strcpy(Val, ErrorList[idx].Name);
+       if (Value < cErrorNameCount && ErrorNames.Name[Value])
+         strcpy(Val, ErrorNames.Name[Value]);
        else
          sprintf(Val, "ERR %d", Value);
        break;
-     }
 
      case et_default:
      default:
-       sprintf(Val, "%d", (signed short)Value);
+       SetFixedValue(Val, (signed short)Value, 0);
        break;
    }
 }
@@ -153,14 +612,105 @@ void SetDoubleType(char * Val, unsigned char Type, double Value)
   }
 }
 
+void DecodeElsterValue(ElsterValue & Val, unsigned char Type, unsigned short Raw)
+{
+  Val.Raw = Raw;
+  Val.Type = Type;
+  Val.Decimals = 0;
+  Val.hasNumber = true;
+  Val.Fixed = 0;
+  Val.Text[0] = 0;
+
+  // Same cases as SetValueType: Fixed / 10^Decimals is the number its text shows.
+  if (Type == et_double_val || Type == et_triple_val)
+    Val.Fixed = Raw;
+  else
+  if (Raw == 0x8000)
+    Val.Fixed = -255;
+  else
+  switch (Type)
+  {
+    case et_byte:
+      Val.Fixed = (signed char) Raw;
+      break;
+
+    case et_dec_val:
+    case et_cent_val:
+    case et_mil_val:
+      Val.Fixed = (signed short) Raw;
+      Val.Decimals = Type == et_dec_val ? 1 : Type == et_cent_val ? 2 : 3;
+      break;
+
+    case et_little_endian:
+      Val.Fixed = (Raw >> 8) + 256*(Raw & 0xff);
+      break;
+
+    case et_little_bool:
+    case et_bool:
+      if (Raw == (Type == et_bool ? 0x0001 : 0x0100))
+        Val.Fixed = 1;
+      else
+      if (Raw)
+        Val.hasNumber = false;
+      break;
+
+    case et_dev_nr:
+      if (Raw >= 0x80)
+        Val.hasNumber = false;
+      else
+        Val.Fixed = Raw + 1;
+      break;
+
+    case et_betriebsart:
+    case et_zeit:
+    case et_datum:
+    case et_time_domain:
+    case et_err_nr:
+    case et_dev_id:
+      Val.hasNumber = false;
+      break;
+
+    case et_default:
+    default:
+      Val.Fixed = (signed short) Raw;
+      break;
+  }
+}
+
+float ElsterValueToFloat(const ElsterValue & Val)
+{
+  static const float Scale[] = { 1.0f, 10.0f, 100.0f, 1000.0f };
+
+  if (!Val.hasNumber)
+    return NAN;
+  return (float) Val.Fixed / Scale[Val.Decimals];
+}
+
+const char * ElsterValueText(ElsterValue & Val)
+{
+  if (!Val.Text[0])
+    SetValueType(Val.Text, Val.Type, Val.Raw);
+  return Val.Text;
+}
+
 
 ElsterType GetElsterType(const char * str)
 {
   if (str)
   {
-    for (unsigned i = 0; i <= High(ElsterTypeStr); i++)
-      if (!strcmp(ElsterTypeStr[i], str))
-        return (ElsterType) i;
+    unsigned lo = 0;
+    unsigned hi = High(ElsterTypeStr) + 1;
+    while (lo < hi)
+    {
+      unsigned mid = (lo + hi) / 2;
+      int cmp = strcmp(ElsterTypeStr[ElsterTypeNames.Pos[mid]], str);
+      if (!cmp)
+        return (ElsterType) ElsterTypeNames.Pos[mid];
+      if (cmp < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
   }
   return et_default;
 }
@@ -175,51 +725,44 @@ const char * ElsterTypeToName(unsigned Type)
 
 const ElsterIndex * GetElsterIndex(unsigned short Index)
 {
-  // Check cache first - O(1) for subsequent lookups
-  auto it = indexCache.find(Index);
-  if (it != indexCache.end()) {
-    return it->second;
-  }
+  unsigned char page = ElsterPages.Dir[Index >> 8];
+  unsigned short pos = page == cNoPage ? 0 : ElsterPages.Slot[page][Index & 0xff];
+#if defined(ELSTER_SIGNAL_SET)
+  if (!pos)
+    return GetUnlistedIndex(Index);
+#endif
+  return &ElsterTable[pos];
+}
 
-  // Cache miss - do linear search O(n)
-  int i;
-  for (i = 0; i <= High(ElsterTable); i++) {
-    if (ElsterTable[i].Index == Index) {
-      const ElsterIndex* result = &ElsterTable[i];
-      indexCache[Index] = result;  // Cache for next time
-      return result;
-    }
+const ElsterIndex * GetElsterIndex(const char * str)
+{
+  if (!str)
+    return &ElsterTable[0];
+
+  // lower bound: first position whose name is not less than str
+  unsigned lo = 0;
+  unsigned hi = cElsterRowCount;
+  while (lo < hi)
+  {
+    unsigned mid = (lo + hi) / 2;
+    if (strcmp(ElsterTable[ElsterNames.Pos[mid]].Name, str) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
   }
 
-  // Not found - cache default and return
-  indexCache[Index] = &ElsterTable[0];
+  if (lo < cElsterRowCount && !strcmp(ElsterTable[ElsterNames.Pos[lo]].Name, str))
+    return &ElsterTable[ElsterNames.Pos[lo]];
+
   return &ElsterTable[0];
 }
 
-const ElsterIndex * GetElsterIndex(const char* str)
+const ElsterMetadata * GetElsterMetadata(const ElsterIndex * ei)
 {
-  // Convert to std::string for cache key
-  std::string key(str);
-  
-  // Check cache first - O(1) for subsequent lookups
-  auto it = nameCache.find(key);
-  if (it != nameCache.end()) {
-    return it->second;
-  }
-
-  // Cache miss - do linear search O(n)
-  int i;
-  for (i = 0; i <= High(ElsterTable); i++) {
-    if (!strcmp(ElsterTable[i].Name, str)) {
-      const ElsterIndex* result = &ElsterTable[i];
-      nameCache[key] = result;  // Cache for next time
-      return result;
-    }
-  }
+  if (!ei || !ei->metadataSlot)
+    return NULL;
 
-  // Not found - cache default and return
-  nameCache[key] = &ElsterTable[0];
-  return &ElsterTable[0];
+  return &ElsterData.Metadata[ei->metadataSlot];
 }
 
 static bool Get_Time(const char * & str, int & hour, int & min)
@@ -297,16 +840,27 @@ int TranslateString(const char * & str, unsigned char elster_type)
     }
     case et_betriebsart:
     {
-      int s = High(BetriebsartList);
-      for ( ; s >= 0; s--)
-        if (!strncmp(BetriebsartList[s].Name, str, strlen(BetriebsartList[s].Name)))
-          break;
+      unsigned lo = 0;
+      unsigned hi = High(BetriebsartList) + 1;
+      while (lo < hi)
+      {
+        unsigned mid = (lo + hi) / 2;
+        if (CompareNames(BetriebsartList[BetriebsartNames.Pos[mid]].Name, str) <= 0)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
       
-      if (s >= 0)
+      if (lo > 0)
       {
-        str += strlen(BetriebsartList[s].Name);
+        const ErrorIndex & s = BetriebsartList[BetriebsartNames.Pos[lo - 1]];
+        const char * end = SkipPrefix(s.Name, str);
+        if (end)
+        {
+          str = end;
         
-        return BetriebsartList[s].Index;
+          return s.Index;
+        }
       }
       break;
     }
@@ -25,8 +25,30 @@
 
   const ElsterIndex * GetElsterIndex(unsigned short Index);
   const ElsterIndex * GetElsterIndex(const char * str);
+  const ElsterMetadata * GetElsterMetadata(const ElsterIndex * ei);  // NULL = use type defaults
   ElsterType GetElsterType(const char * str);
+  // Val needs cElsterValueSize bytes: the longest text is "not used time domain"
+  static const unsigned cElsterValueSize = 24;
   void SetValueType(char * Val, unsigned char Type, unsigned short Value);
+
+  // Decoded value of one frame. Where the text is a number, the value is also
+  // kept as fixed-point number Fixed / 10^Decimals (bool types: on = 1, off = 0),
+  // so consumers need not parse the text. Text is formatted on first use by
+  // ElsterValueText, same as SetValueType.
+  typedef struct
+  {
+    unsigned short Raw;
+    unsigned char Type;
+    unsigned char Decimals;
+    bool hasNumber;
+    long Fixed;
+    char Text[cElsterValueSize];
+  } ElsterValue;
+
+  void DecodeElsterValue(ElsterValue & Val, unsigned char Type, unsigned short Raw);
+  float ElsterValueToFloat(const ElsterValue & Val);  // NAN without a number
+  const char * ElsterValueText(ElsterValue & Val);
+
   void SetDoubleType(char * Val, unsigned char Type, double Value);
   const char * ElsterTypeToName(unsigned Type);
   int TranslateString(const char * & str, unsigned char elster_type);
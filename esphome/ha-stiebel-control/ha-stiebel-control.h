@@ -26,12 +26,14 @@
 #include "config.h"
 #include "language_select.h"
 #include "sg_ready_controller.h"
+#include "request_scheduler.h"
+#include "command_sequencer.h"
+#include "json_writer.h"
+#include "string_arena.h"
+#include "state_filter.h"
 #include <driver/twai.h>
-#include <sstream>
-#include <iomanip>
-#include <set>
+#include <bitset>
 #include <map>
-#include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -39,33 +41,34 @@
 // CAN BUS MEMBER DEFINITIONS
 // ============================================================================
 
-typedef struct
+/**
+ * Simple struct for CAN ID bytes (avoids heap allocation)
+ */
+struct CanIdBytes {
+    uint8_t first;
+    uint8_t second;
+};
+
+/**
+ * Generate CAN read ID from member CAN ID
+ */
+constexpr CanIdBytes generate_read_id(unsigned short can_id)
 {
-    const char *Name;
-    uint32_t CanId;
-} CanMember;
+    return {static_cast<uint8_t>((((can_id & 0x780) / 8) & 0xF0) + 1), static_cast<uint8_t>(can_id & 7)};
+}
 
-static const CanMember CanMembers[] =
-    {
-        //  Name  CanId
-        {"KESSEL", 0x180},
-        {"ATEZ", 0x280},
-        {"BEDIENMODUL_1", 0x300},
-        {"BEDIENMODUL_2", 0x301},
-        {"BEDIENMODUL_3", 0x302},
-        {"BEDIENMODUL_4", 0x303},
-        {"RAUMFERNFUEHLER", 0x400},
-        {"MANAGER", 0x480},
-        {"HEIZMODUL", 0x500},
-        {"BUSKOPPLER", 0x580},
-        {"MISCHERMODUL_1", 0x600},
-        {"MISCHERMODUL_2", 0x601},
-        {"MISCHERMODUL_3", 0x602},
-        {"MISCHERMODUL_4", 0x603},
-        {"PC", 0x680},
-        {"FREMDGERAET", 0x700},
-        {"DCF_MODUL", 0x780},
-        {"OTHER", 0x000}};
+constexpr CanIdBytes generate_write_id(unsigned short can_id)
+{
+    return {static_cast<uint8_t>(((can_id & 0x780) / 8) & 0xF0), static_cast<uint8_t>(can_id & 7)};
+}
+
+/**
+ * Target ID bytes of a response to a read request from `can_id`
+ */
+constexpr CanIdBytes generate_response_id(unsigned short can_id)
+{
+    return {static_cast<uint8_t>((((can_id & 0x780) / 8) & 0xF0) + 2), static_cast<uint8_t>(can_id & 7)};
+}
 
 typedef enum
 {
@@ -90,6 +93,86 @@ typedef enum
     cm_other
 } CanMemberType;
 
+typedef struct
+{
+    const char *Name;
+    uint32_t CanId;
+    CanMemberType Member;
+    const char *FriendlyName; // Home Assistant device name
+    CanIdBytes ReadId;        // generate_read_id(CanId)
+    CanIdBytes WriteId;       // generate_write_id(CanId)
+} CanMember;
+
+constexpr CanMember makeCanMember(const char *name, uint32_t canId, CanMemberType member, const char *friendlyName)
+{
+    return {name, canId, member, friendlyName, generate_read_id(canId), generate_write_id(canId)};
+}
+
+static constexpr CanMember CanMembers[] =
+    {
+        //            Name  CanId  Member  FriendlyName
+        makeCanMember("KESSEL", 0x180, cm_kessel, "Kessel"),
+        makeCanMember("ATEZ", 0x280, cm_atez, "ATEZ"),
+        makeCanMember("BEDIENMODUL_1", 0x300, cm_bedienmodul_1, "BEDIENMODUL_1"),
+        makeCanMember("BEDIENMODUL_2", 0x301, cm_bedienmodul_2, "BEDIENMODUL_2"),
+        makeCanMember("BEDIENMODUL_3", 0x302, cm_bedienmodul_3, "BEDIENMODUL_3"),
+        makeCanMember("BEDIENMODUL_4", 0x303, cm_bedienmodul_4, "BEDIENMODUL_4"),
+        makeCanMember("RAUMFERNFUEHLER", 0x400, cm_raumfernfuehler, "RAUMFERNFUEHLER"),
+        makeCanMember("MANAGER", 0x480, cm_manager, "Manager"),
+        makeCanMember("HEIZMODUL", 0x500, cm_heizmodul, "Heizmodul"),
+        makeCanMember("BUSKOPPLER", 0x580, cm_buskoppler, "BUSKOPPLER"),
+        makeCanMember("MISCHERMODUL_1", 0x600, cm_mischermodul_1, "MISCHERMODUL_1"),
+        makeCanMember("MISCHERMODUL_2", 0x601, cm_mischermodul_2, "MISCHERMODUL_2"),
+        makeCanMember("MISCHERMODUL_3", 0x602, cm_mischermodul_3, "MISCHERMODUL_3"),
+        makeCanMember("MISCHERMODUL_4", 0x603, cm_mischermodul_4, "MISCHERMODUL_4"),
+        makeCanMember("PC", 0x680, cm_pc, "PC"),
+        makeCanMember("FREMDGERAET", 0x700, cm_fremdgeraet, "FREMDGERAET"),
+        makeCanMember("DCF_MODUL", 0x780, cm_dcf_modul, "DCF_MODUL"),
+        makeCanMember("OTHER", 0x000, cm_other, "OTHER")};
+
+static constexpr unsigned cCanMemberCount = sizeof(CanMembers) / sizeof(CanMembers[0]);
+
+/**
+ * Member lookup by CAN ID, built at compile time: the Elster address bits of
+ * an 11-bit ID (0x780 group, 0x007 sub-address) select one of 128 slots that
+ * holds the CanMembers position. IDs with other bits set, and unused slots,
+ * resolve to cm_other.
+ */
+constexpr uint32_t cCanMemberAddressMask = 0x787;
+
+constexpr unsigned canMemberSlot(uint32_t canId)
+{
+    return ((canId & 0x780) >> 4) | (canId & 7);
+}
+
+struct CanMemberMap {
+    uint8_t Pos[128];
+    bool Valid;
+};
+
+constexpr CanMemberMap buildCanMemberMap()
+{
+    CanMemberMap map {};
+    for (unsigned slot = 0; slot < 128; slot++)
+        map.Pos[slot] = cm_other;
+    map.Valid = cCanMemberCount == cm_other + 1u;
+    for (unsigned i = 0; i < cCanMemberCount; i++) {
+        const CanMember &cm = CanMembers[i];
+        if (cm.Member != i)
+            map.Valid = false;
+        if (i == cm_other)
+            continue;
+        unsigned slot = canMemberSlot(cm.CanId);
+        if ((cm.CanId & ~cCanMemberAddressMask) != 0 || map.Pos[slot] != cm_other)
+            map.Valid = false;
+        map.Pos[slot] = static_cast<uint8_t>(i);
+    }
+    return map;
+}
+
+static constexpr CanMemberMap CanMemberSlots = buildCanMemberMap();
+static_assert(CanMemberSlots.Valid, "CanMembers must follow CanMemberType and have distinct Elster addresses");
+
 // ============================================================================
 // MQTT AUTO-DISCOVERY CONFIGURATION
 // ============================================================================
@@ -147,6 +230,26 @@ static const CalculatedSensorConfig calculatedSensors[] = {
      "sensor", "", "", "total_increasing", "mdi:network-off", "", "", "diagnostic", false},
     {"stiebel_calculated_can_state",      LNAME_CALC_CAN_STATE,      "heatingpump/calculated/can_state/state",
      "sensor", "", "", "", "mdi:can", "", "", "diagnostic", false},
+    {"stiebel_calculated_can_bus_load",   LNAME_CALC_CAN_BUS_LOAD,   "heatingpump/calculated/can_bus_load/state",
+     "sensor", "", "%", "measurement", "mdi:gauge", "", "", "diagnostic", false},
+    {"stiebel_calculated_request_budget", LNAME_CALC_REQUEST_BUDGET, "heatingpump/calculated/request_budget/state",
+     "sensor", "", "frames/s", "measurement", "mdi:speedometer", "", "", "diagnostic", false},
+
+    // Request manager: worst achieved/configured request period over all signals
+    {"stiebel_calculated_request_period_ratio", LNAME_CALC_REQUEST_PERIOD_RATIO, "heatingpump/calculated/request_period_ratio/state",
+     "sensor", "", "%", "measurement", "mdi:timer-sync-outline", "", "", "diagnostic", false},
+    // Request manager: read requests that stayed unanswered after all retries
+    {"stiebel_calculated_request_timeouts", LNAME_CALC_REQUEST_TIMEOUTS, "heatingpump/calculated/request_timeouts/state",
+     "sensor", "", "", "total_increasing", "mdi:timer-alert-outline", "", "", "diagnostic", false},
+    // Request manager: slots backed off for getting no valid answer
+    {"stiebel_calculated_quarantined_signals", LNAME_CALC_QUARANTINED_SIGNALS, "heatingpump/calculated/quarantined_signals/state",
+     "sensor", "", "", "measurement", "mdi:timer-pause-outline", "", "", "diagnostic", false},
+    // Request manager: p95 time from an HA write to its confirmed value
+    {"stiebel_calculated_command_latency", LNAME_CALC_COMMAND_LATENCY, "heatingpump/calculated/command_latency/state",
+     "sensor", "duration", "ms", "measurement", "mdi:timer-check-outline", "", "", "diagnostic", false},
+    // MQTT: received values not published because they equal the last state
+    {"stiebel_calculated_suppressed_states", LNAME_CALC_SUPPRESSED_STATES, "heatingpump/calculated/suppressed_states/state",
+     "sensor", "", "", "total_increasing", "mdi:filter-outline", "", "", "diagnostic", false},
 };
 
 static const size_t CALCULATED_SENSOR_COUNT = sizeof(calculatedSensors) / sizeof(CalculatedSensorConfig);
@@ -250,23 +353,105 @@ static const size_t WRITABLE_SELECT_COUNT = sizeof(writableSelects) / sizeof(Wri
 // The controller is the authoritative source; these are updated via sgReadyStateInt().
 static int currentSgReadyState = 2;
 
-// Track which signals have been discovered
-static std::set<std::string> discoveredSignals;
+// Discovery published since the last republish, by position in
+// calculatedSensors, writableNumbers and writableSelects
+static std::bitset<CALCULATED_SENSOR_COUNT> discoveredCalculatedSensors;
+static std::bitset<WRITABLE_NUMBER_COUNT> discoveredWritableNumbers;
+static std::bitset<WRITABLE_SELECT_COUNT> discoveredWritableSelects;
 
-// Track which calculated sensors have been discovered
-static std::set<std::string> discoveredCalculatedSensors;
+// Position of `entry` in `table`; N for an entry that is not part of it
+template <typename T, size_t N>
+inline size_t tablePosition(const T (&table)[N], const T &entry)
+{
+    return &entry >= table && &entry < table + N ? &entry - table : N;
+}
 
-// Track which writable numbers have been discovered
-static std::set<std::string> discoveredWritableNumbers;
+// Poll groups: signals that make up one value together. The rows of a group
+// follow each other in signalRequests and address the same member; they are
+// requested back to back at the frequency of the first row and published
+// together once all responses are in, so the calculated sensors they feed
+// never mix values of two polls.
+typedef enum
+{
+    pg_none = 0,
+    pg_datetime,    // JAHR … SEKUNDE: date and time
+    pg_cop,         // energy counters: COP
+    pg_delta_t,     // WPVORLAUFIST, RUECKLAUFISTTEMP: delta T
+    pg_count
+} PollGroupId;
+
+// One schedule slot per requested (member, signal) pair, resolved once from
+// signalRequests when the request manager starts. A cm_other row expands into
+// one slot each for kessel, manager and heizmodul, stored next to each other.
+struct RequestSlot {
+    const ElsterIndex *ei;
+    const CanMember *member;
+    uint32_t deadline;      // millis() at which the next request is due
+    uint32_t intervalMs;
+    uint16_t request;       // signalRequests row, shared by the slots of a cm_other row
+    bool sent;              // requested at least once
+    uint32_t lastSentMs;    // millis() of the last request
+    uint32_t achievedMs;    // smoothed time between two requests (0 = fewer than two sent)
+    uint8_t groupSize;      // slots of the signalRequests row: 3 for cm_other, else 1
+    uint8_t groupPos;       // position of this slot among them
+    bool learning;          // cm_other: still finding out which members answer
+    bool background;        // cm_other: member does not answer, only re-probed
+    uint8_t probes;         // requests sent while learning
+    uint8_t answers;        // valid responses while learning
+    uint8_t learnRounds;    // learning rounds without any answer, kept by the row's first slot
+    SlotHealth health;      // backoff while requests get no valid answer
+    PollGroupId pollGroup;  // poll group of the signal, pg_none if it stands alone
+};
+static std::vector<RequestSlot> requestSlots;
+
+// A poll group's signals occupy `size` adjacent requestSlots from `first`. Only
+// the first slot is scheduled; sending it starts a round, which sends the
+// others right after and collects the values until every signal answered or
+// timed out.
+struct PollGroup {
+    uint16_t first;
+    uint8_t size;           // 0: the group is not in the request table
+    uint8_t pending;        // signals of the round still awaited, bit per position
+    uint8_t received;       // signals of the round that answered
+    ElsterValue values[POLL_GROUP_MAX_SIGNALS];
+};
+static PollGroup pollGroups[pg_count];
+// Slots of the running poll group rounds still to be sent, ahead of the due polls
+static std::vector<uint16_t> pollGroupBurst;
+// requestSlots positions ordered by deadline: polls, and background probes
+static RequestScheduler requestScheduler;
+static RequestScheduler probeScheduler;
+// Frame budget and inter-frame gap of the request manager, shared by all lanes
+static RequestPacer requestPacer;
+// Budget of each transmit lane, and the writes and one-off reads waiting in it
+static RequestPacer lanePacers[TX_LANE_COUNT];
+static TxQueue<TX_QUEUE_SIZE> txQueues[TX_LANE_COUNT];
+// Measured bus utilisation, adapts the budget of requestPacer
+static BusLoadLimiter busLoad;
+// Read requests awaiting their response, and unanswered ones due for a retry
+static OutstandingRequests outstandingRequests;
+static std::vector<OutstandingRequest> requestRetries;
+
+// Response statistics per member, indexed by CanMemberType
+struct MemberRequestStats {
+    RttHistogram rtt;
+    uint32_t retries;
+    uint32_t timeouts;
+};
+static MemberRequestStats memberRequestStats[cCanMemberCount];
 
-// Track which writable selects have been discovered
-static std::set<std::string> discoveredWritableSelects;
+// Writes awaiting their readback, and the time from queueing a write to its
+// confirmed value
+static OutstandingRequests pendingConfirms;
+static RttHistogram commandLatency;
+static uint32_t unconfirmedCommands = 0;
 
-// Track next scheduled request time per unique signal key (MEMBER_SIGNAL)
-static std::unordered_map<std::string, unsigned long> nextRequestTime;
+// Multi-signal writes (SG Ready transitions, date/time buttons), sent in order
+// and each confirmed by its readback
+static CommandSequencer<SEQUENCE_QUEUE_SIZE> commandSequencer;
 
-// Track starting position for round-robin signal processing (prevents starvation)
-static int signalProcessingStartIndex = 0;
+// Members that answer the cm_other signals, learned at runtime and kept in NVS
+static ResponderMap<RESPONDER_MAP_SIZE> responderMap = {};
 
 // Track sensor values for calculated sensors
 static float lastWpVorlaufIst = NAN;
@@ -287,19 +472,45 @@ static unsigned long nextCompressorUpdate = 0;
 static unsigned long nextDateTimeUpdate = 0;
 static unsigned long nextBetriebsartUpdate = 0;
 static unsigned long nextCanDiagUpdate = 0;
+static unsigned long nextRequestPeriodUpdate = 0;
+
+// MQTT names of one signal of one CAN member, formatted on its first publish
+// and kept in signalNames, so a state publish formats and allocates nothing
+struct SignalEntity {
+    const char *uid;             // stiebel_manager_aussentemp
+    const char *stateTopic;      // heatingpump/MANAGER/AUSSENTEMP/state
+    const char *discoveryTopic;  // homeassistant/sensor/heatingpump/stiebel_manager_aussentemp/config
+    uint16_t row;                // ElsterTable row of the signal
+    uint8_t member;              // CanMemberType
+    float deadband;              // see stateDeadband()
+    PublishedState state;        // last published value, see stateFilter
+};
 
-// UID cache to avoid repeated string operations on every signal update
-static std::unordered_map<std::string, std::string> uidCache;
+static StringArena<SIGNAL_NAME_BLOCK_SIZE> signalNames;
+static std::vector<SignalEntity> signalEntities;
+// Members get an entity slot when they publish their first signal, so the
+// index only has columns for the few members that answer at all
+static uint8_t entityMemberSlots[cCanMemberCount];     // slot + 1, 0 = none yet
+static uint8_t entityMemberCount = 0;
+// signalEntities position + 1 of (member slot, ElsterTable row) at
+// [slot * ElsterTableCount + row]; 0 = no entity yet
+static std::vector<uint16_t> signalEntityIndex;
+// Discovery published since the last republish, same positions
+static std::vector<bool> discoveredSignals;
+// Drops received values that equal the last published state of their entity
+static StateFilter stateFilter(STATE_HEARTBEAT_INTERVAL * 1000UL);
 
 // ============================================================================
 // SIGNAL REQUEST CONFIGURATION
 // ============================================================================
 
 // Signal request configuration structure
-typedef struct {
+typedef struct SignalRequest {
     const char* signalName;
     unsigned long frequency;     // Request frequency in seconds
     CanMemberType member;        // Use cm_other for "all members"
+    PollGroupId pollGroup = pg_none;
+    float deadband = -1.0f;      // State deadband, negative = by device class (see stateDeadband)
 } SignalRequest;
 
 // Forward declarations for the model-specific signal request table.
@@ -322,37 +533,70 @@ static unsigned long requestManagerStartTime = 0;
 #if !defined(HA_DUMMY_BUILD)
 
 /**
- * Simple struct for CAN ID bytes (avoids heap allocation)
+ * One CAN frame with an inline payload (avoids heap allocation). Passed by
+ * reference from the on_frame lambda through decoding, and built in place by
+ * readSignal()/writeSignal() up to the send call.
  */
-struct CanIdBytes {
-    uint8_t first;
-    uint8_t second;
+struct ElsterFrame {
+    uint32_t canId;
+    uint8_t dlc;
+    uint8_t data[8];
 };
 
+inline ElsterFrame makeElsterFrame(uint32_t canId, const uint8_t *data, size_t len)
+{
+    ElsterFrame frame = {canId, static_cast<uint8_t>(len < 8 ? len : 8), {}};
+    memcpy(frame.data, data, frame.dlc);
+    return frame;
+}
+
 /**
- * Generate CAN read ID from member CAN ID
+ * Build a 7-byte Elster frame to send from the PC address: target ID bytes,
+ * index (short form, or 0xFA + 16-bit index), 16-bit value
  */
-CanIdBytes generate_read_id(unsigned short can_id)
+ElsterFrame buildElsterFrame(CanIdBytes target, unsigned short index, uint16_t value)
 {
-    uint8_t address = (can_id & 0x780) / 8;
-    return {static_cast<uint8_t>((address & 0xF0) + 1), static_cast<uint8_t>(can_id & 7)};
+    const uint32_t pcId = CanMembers[cm_pc].CanId;
+    const uint8_t indexHi = static_cast<uint8_t>(index >> 8);
+    const uint8_t indexLo = static_cast<uint8_t>(index & 0xFF);
+    const uint8_t valueHi = static_cast<uint8_t>(value >> 8);
+    const uint8_t valueLo = static_cast<uint8_t>(value & 0xFF);
+
+    if (indexHi == 0x00)
+    {
+        return {pcId, 7, {target.first, target.second, indexLo, valueHi, valueLo, 0x00, 0x00}};
+    }
+    return {pcId, 7, {target.first, target.second, 0xFA, indexHi, indexLo, valueHi, valueLo}};
+}
+
+/**
+ * True for a response addressed to the PC address, i.e. the answer to one of
+ * our read requests (members also exchange values among each other)
+ */
+inline bool isResponseToPc(const ElsterFrame &frame)
+{
+    constexpr CanIdBytes pc = generate_response_id(CanMembers[cm_pc].CanId);
+    return frame.dlc >= 2 && frame.data[0] == pc.first && frame.data[1] == pc.second;
 }
 
-CanIdBytes generate_write_id(unsigned short can_id)
+/**
+ * Send a frame. esphome::canbus only accepts a std::vector, so one buffer
+ * is reused: its capacity is allocated once, not per frame.
+ */
+void sendElsterFrame(const ElsterFrame &frame)
 {
-    uint8_t address = (can_id & 0x780) / 8;
-    return {static_cast<uint8_t>(address & 0xF0), static_cast<uint8_t>(can_id & 7)};
+    constexpr bool use_extended_id = false; // No use of extended ID
+    static std::vector<uint8_t> txData;
+    txData.assign(frame.data, frame.data + frame.dlc);
+    id(my_can).send_data(frame.canId, use_extended_id, txData);
+    busLoad.frameSeen(frame.dlc);
 }
 
 const CanMember &lookupCanMember(uint32_t canId)
 {
-    for (size_t i = 0; i < sizeof(CanMembers) / sizeof(CanMember); ++i) {
-        if (CanMembers[i].CanId == canId) {
-            return CanMembers[i];
-        }
-    }
-    // Return the last element if member is not found
-    return CanMembers[sizeof(CanMembers) / sizeof(CanMembers[0]) - 1];
+    if ((canId & ~cCanMemberAddressMask) != 0)
+        return CanMembers[cm_other];
+    return CanMembers[CanMemberSlots.Pos[canMemberSlot(canId)]];
 }
 
 // Check if signal is permanently blacklisted (lookup in ElsterTable)
@@ -401,21 +645,22 @@ inline void getTypeDefaults(ElsterType type, const char*& component, const char*
     }
 }
 
-const ElsterIndex *processCanMessage(const std::vector<uint8_t> &msg, uint32_t can_id, std::string &signalValue, const CanMember **outCanMember)
+const ElsterIndex *processCanMessage(const ElsterFrame &frame, ElsterValue &signalValue, const CanMember **outCanMember)
 {
+    const uint8_t *msg = frame.data;
+
     // Return if the message is too small
-    if (msg.size() < 7)
+    if (frame.dlc < 7)
     {
         return &ElsterTable[0];
     }
 
-    const CanMember &cm = lookupCanMember(can_id);
+    const CanMember &cm = lookupCanMember(frame.canId);
     *outCanMember = &cm;  // Return CanMember to caller
 
     const ElsterIndex *ei;
     uint8_t byte1;
     uint8_t byte2;
-    char charValue[16];
 
     if (msg[2] == 0xfa)
     {
@@ -430,59 +675,27 @@ const ElsterIndex *processCanMessage(const std::vector<uint8_t> &msg, uint32_t c
         ei = GetElsterIndex(msg[2]);
     }
 
-    switch (ei->Type)
-    {
-    case et_double_val:
-        SetDoubleType(charValue, ei->Type, static_cast<double>(byte2 + (byte1 << 8)));
-        break;
-    case et_triple_val:
-        SetDoubleType(charValue, ei->Type, static_cast<double>(byte2 + (byte1 << 8)));
-        break;
-    default:
-        SetValueType(charValue, ei->Type, static_cast<int>(byte2 + (byte1 << 8)));
-        break;
-    }
+    DecodeElsterValue(signalValue, ei->Type, byte2 + (byte1 << 8));
 
-    ESP_LOGI("processCanMessage()", "%s (0x%02x):\t%s:\t%s\t(%s)", cm.Name, cm.CanId, ei->Name, charValue, ElsterTypeStr[ei->Type]);
+    ESP_LOGI("processCanMessage()", "%s (0x%02x):\t%s:\t%s\t(%s)", cm.Name, cm.CanId, ei->Name, ElsterValueText(signalValue), ElsterTypeStr[ei->Type]);
 
-    signalValue = charValue;
     return ei;
 }
 
-void readSignal(const CanMember *cm, const ElsterIndex *ei)
+void readSignal(const CanMember *cm, const ElsterIndex *ei, uint8_t attempt = 1,
+                uint16_t slot = OutstandingRequest::NO_SLOT, uint8_t lane = TX_LANE_POLL)
 {
-    constexpr bool use_extended_id = false; // No use of extended ID
-    const uint8_t IndexByte1 = static_cast<uint8_t>(ei->Index >> 8);
-    const uint8_t IndexByte2 = static_cast<uint8_t>(ei->Index & 0xFF);
-    std::vector<uint8_t> data;
-    CanIdBytes readId = generate_read_id(cm->CanId);
-
-    if (IndexByte1 == 0x00)
-    {
-        data = {readId.first,
-                readId.second,
-                IndexByte2,
-                0x00,
-                0x00,
-                0x00,
-                0x00};
-    }
-    else
-    {
-        data = {readId.first,
-                readId.second,
-                0xFA,
-                IndexByte1,
-                IndexByte2,
-                0x00,
-                0x00};
-    }
+    const CanIdBytes readId = cm->ReadId;
+    const ElsterFrame frame = buildElsterFrame(readId, ei->Index, 0);
+    const uint8_t *data = frame.data;
 
     char logmsg[120];
     snprintf(logmsg, sizeof(logmsg), "READ \"%s\" (0x%04x) FROM %s (0x%02x {0x%02x, 0x%02x}): %02x, %02x, %02x, %02x, %02x, %02x, %02x", ei->Name, ei->Index, cm->Name, cm->CanId, readId.first, readId.second, data[0], data[1], data[2], data[3], data[4], data[5], data[6]);
     ESP_LOGI("readSignal()", "%s", logmsg);
 
-    id(my_can).send_data(CanMembers[cm_pc].CanId, use_extended_id, data);
+    sendElsterFrame(frame);
+    // Await the response; processAndUpdate() matches it, expireOutstandingRequests() times it out
+    outstandingRequests.add(cm->Member, ei->Index, millis(), attempt, slot, lane);
 }
 
 void readSignal(const CanMember *cm, const char *elsterName)
@@ -491,39 +704,11 @@ void readSignal(const CanMember *cm, const char *elsterName)
     return;
 }
 
-void writeSignal(const CanMember *cm, const ElsterIndex *ei, const char *&str)
+void writeSignalValue(const CanMember *cm, const ElsterIndex *ei, uint16_t writeValue)
 {
-    bool use_extended_id = false;
-    int writeValue = TranslateString(str, ei->Type);
-    if (writeValue == -1) {
-        ESP_LOGW("writeSignal()", "TranslateString failed for \"%s\" (input: \"%s\") — refusing to write", ei->Name, str);
-        return;
-    }
-    uint8_t IndexByte1 = static_cast<uint8_t>(ei->Index >> 8);
-    uint8_t IndexByte2 = static_cast<uint8_t>(ei->Index & 0xFF);
-    std::vector<uint8_t> data;
-    CanIdBytes writeId = generate_write_id(cm->CanId);
-
-    if (IndexByte1 == 0x00)
-    {
-        data = {writeId.first,
-                writeId.second,
-                IndexByte2,
-                static_cast<uint8_t>(writeValue >> 8),
-                static_cast<uint8_t>(writeValue & 0xFF),
-                0x00,
-                0x00};
-    }
-    else
-    {
-        data = {writeId.first,
-                writeId.second,
-                0xfa,
-                IndexByte1,
-                IndexByte2,
-                static_cast<uint8_t>(writeValue >> 8),
-                static_cast<uint8_t>(writeValue & 0xFF)};
-    }
+    const CanIdBytes writeId = cm->WriteId;
+    const ElsterFrame frame = buildElsterFrame(writeId, ei->Index, writeValue);
+    const uint8_t *data = frame.data;
 
     char logmsg[120];
     snprintf(logmsg, sizeof(logmsg), "WRITE \"%s\" (0x%04x): \"%d\" TO: %s (0x%02x {0x%02x, 0x%02x}): %02x, %02x, %02x, %02x, %02x, %02x, %02x",
@@ -531,7 +716,17 @@ void writeSignal(const CanMember *cm, const ElsterIndex *ei, const char *&str)
              data[0], data[1], data[2], data[3], data[4], data[5], data[6]);
     ESP_LOGI("writeSignal()", "%s", logmsg);
 
-    id(my_can).send_data(CanMembers[cm_pc].CanId, use_extended_id, data);
+    sendElsterFrame(frame);
+}
+
+void writeSignal(const CanMember *cm, const ElsterIndex *ei, const char *&str)
+{
+    int writeValue = TranslateString(str, ei->Type);
+    if (writeValue == -1) {
+        ESP_LOGW("writeSignal()", "TranslateString failed for \"%s\" (input: \"%s\") — refusing to write", ei->Name, str);
+        return;
+    }
+    writeSignalValue(cm, ei, static_cast<uint16_t>(writeValue));
 }
 
 void writeSignal(const CanMember *cm, const char *elsterName, const char *str)
@@ -541,79 +736,199 @@ void writeSignal(const CanMember *cm, const char *elsterName, const char *str)
     return;
 }
 
+/**
+ * Queue a write of the raw `value` to `ei` in the command lane and its
+ * readback in the confirm lane; runRequestSlots() sends both ahead of the
+ * polls. The time until the readback arrives is the command latency. Returns
+ * false if the lanes are full.
+ */
+bool queueCommandValue(const CanMember *cm, const ElsterIndex *ei, uint16_t value)
+{
+    if (txQueues[TX_LANE_COMMAND].full() || txQueues[TX_LANE_CONFIRM].full()) {
+        ESP_LOGW("queueCommand()", "Command lanes full, dropping write of %s", ei->Name);
+        return false;
+    }
+
+    const uint32_t now = millis();
+    txQueues[TX_LANE_COMMAND].push({now, ei->Index, value, cm->Member, true});
+    txQueues[TX_LANE_CONFIRM].push({now, ei->Index, 0, cm->Member, false});
+    pendingConfirms.add(cm->Member, ei->Index, now, 1);
+    return true;
+}
+
+// Queue a write of `str` to `elsterName` as queueCommandValue() does. Returns
+// false if the value does not translate or the lanes are full.
+bool queueCommand(const CanMember *cm, const char *elsterName, const char *str)
+{
+    const ElsterIndex *ei = GetElsterIndex(elsterName);
+    const char *input = str;
+    int writeValue = TranslateString(input, ei->Type);
+    if (ei == &ElsterTable[0] || writeValue == -1) {
+        ESP_LOGW("queueCommand()", "Cannot write \"%s\" to %s — refusing to queue", str, elsterName);
+        return false;
+    }
+    return queueCommandValue(cm, ei, static_cast<uint16_t>(writeValue));
+}
+
+/**
+ * Append a write of `str` to `elsterName` on `cm` to `transaction`; see
+ * CommandTransaction::add() for `exact`. Returns false if the value does not
+ * translate or the transaction is full.
+ */
+bool addSequenceStep(CommandTransaction &transaction, const CanMember *cm, const char *elsterName,
+                     const char *str, bool exact = true)
+{
+    const ElsterIndex *ei = GetElsterIndex(elsterName);
+    const char *input = str;
+    int writeValue = TranslateString(input, ei->Type);
+    if (ei == &ElsterTable[0] || writeValue == -1
+        || !transaction.add(cm->Member, ei->Index, static_cast<uint16_t>(writeValue), exact)) {
+        ESP_LOGW("addSequenceStep()", "Cannot add write of \"%s\" to %s to %s", str, elsterName, transaction.name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Hand `transaction` to the command sequencer. runCommandSequencer() queues
+ * its writes one after the other, each once the previous one was read back
+ * with its value. Returns false if it is empty or the sequencer is full.
+ */
+bool submitSequence(const CommandTransaction &transaction)
+{
+    if (!commandSequencer.submit(transaction)) {
+        ESP_LOGW("submitSequence()", "Cannot run %s (%u writes, %u waiting)", transaction.name,
+                 (unsigned)transaction.count, (unsigned)commandSequencer.size());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Queue a one-off read of `elsterName` in the poll lane. Returns false if the
+ * signal is unknown or the lane is full.
+ */
+bool queueRead(const CanMember *cm, const char *elsterName)
+{
+    const ElsterIndex *ei = GetElsterIndex(elsterName);
+    const uint32_t now = millis();
+    if (ei == &ElsterTable[0] || !txQueues[TX_LANE_POLL].push({now, ei->Index, 0, cm->Member, false})) {
+        ESP_LOGW("queueRead()", "Cannot queue read of %s", elsterName);
+        return false;
+    }
+    return true;
+}
+
+// Discovery payloads are built one at a time in this buffer
+static char discoveryPayload[DISCOVERY_PAYLOAD_SIZE];
+
+// "device" of a discovery payload: the heat pump itself (cm nullptr), or a CAN
+// member as sub-device of it
+void writeDiscoveryDevice(JsonWriter &json, const CanMember *cm)
+{
+    json.beginObject("device");
+    if (cm) {
+        char deviceId[32];
+        snprintf(deviceId, sizeof(deviceId), "stiebel_%s", cm->Name);
+        json.beginArray("identifiers").value(deviceId).endArray();
+        json.field("name", cm->FriendlyName);
+        json.field("via_device", "stiebel_eltron_" HA_DEVICE_MODEL);
+    } else {
+        json.beginArray("identifiers").value("stiebel_eltron_" HA_DEVICE_MODEL).endArray();
+        json.field("name", "Stiebel Eltron Wärmepumpe");
+    }
+    json.field("manufacturer", "Stiebel Eltron");
+    json.endObject();
+}
+
+// Publish a finished discovery payload retained to `topic`. A payload that did
+// not fit in discoveryPayload is dropped: cut off, it is no valid JSON.
+bool publishDiscoveryPayload(const char *topic, const JsonWriter &json)
+{
+    if (!json.ok()) {
+        ESP_LOGW("MQTT", "Discovery payload for %s exceeds %u bytes, not published", topic,
+                 (unsigned)DISCOVERY_PAYLOAD_SIZE);
+        return false;
+    }
+    id(mqtt_client).publish(topic, json.c_str(), json.size(), 0, true);
+    return true;
+}
+
 // Unified function to publish MQTT discovery for calculated sensors
 void publishCalculatedSensorDiscovery(const CalculatedSensorConfig& config, bool forceRepublish = false) {
-    // Check if already published (unless force republish)
-    if (!forceRepublish && discoveredCalculatedSensors.find(config.uniqueId) != discoveredCalculatedSensors.end()) {
-        return;
+    // Check if already published (unless force republish); a config outside
+    // calculatedSensors is not tracked
+    const size_t pos = tablePosition(calculatedSensors, config);
+    if (pos < CALCULATED_SENSOR_COUNT) {
+        if (!forceRepublish && discoveredCalculatedSensors[pos]) {
+            return;
+        }
+        
+        // Mark as discovered
+        discoveredCalculatedSensors[pos] = true;
     }
     
-    // Mark as discovered
-    discoveredCalculatedSensors.insert(config.uniqueId);
-    
     // Build discovery topic
     char discoveryTopic[256];
     snprintf(discoveryTopic, sizeof(discoveryTopic), 
              "homeassistant/%s/heatingpump/%s/config", config.component, config.uniqueId);
     
     // Build JSON payload
-    std::ostringstream payload;
-    payload << "{\"name\":\"" << config.name << "\","
-            << "\"unique_id\":\"" << config.uniqueId << "\","
-            << "\"state_topic\":\"" << config.stateTopic << "\"";
+    JsonWriter json(discoveryPayload, sizeof(discoveryPayload));
+    json.beginObject();
+    json.field("name", config.name);
+    json.field("unique_id", config.uniqueId);
+    json.field("state_topic", config.stateTopic);
     
     // Add device class if specified
     if (config.deviceClass[0] != '\0') {
-        payload << ",\"device_class\":\"" << config.deviceClass << "\"";
+        json.field("device_class", config.deviceClass);
     }
     
     // Add unit if specified
     if (config.unit[0] != '\0') {
-        payload << ",\"unit_of_measurement\":\"" << config.unit << "\"";
+        json.field("unit_of_measurement", config.unit);
     }
     
     // Add state class if specified
     if (config.stateClass[0] != '\0') {
-        payload << ",\"state_class\":\"" << config.stateClass << "\"";
+        json.field("state_class", config.stateClass);
     }
     
     // Add icon if specified
     if (config.icon[0] != '\0') {
-        payload << ",\"icon\":\"" << config.icon << "\"";
+        json.field("icon", config.icon);
     }
     
     // For binary sensors, add payload on/off
     if (config.payloadOn[0] != '\0' && config.payloadOff[0] != '\0') {
-        payload << ",\"payload_on\":\"" << config.payloadOn << "\","
-                << "\"payload_off\":\"" << config.payloadOff << "\"";
+        json.field("payload_on", config.payloadOn);
+        json.field("payload_off", config.payloadOff);
     }
 
     // Add entity category if specified
     if (config.entityCategory[0] != '\0') {
-        payload << ",\"entity_category\":\"" << config.entityCategory << "\"";
+        json.field("entity_category", config.entityCategory);
     }
 
     // Add enabled_by_default if false (true is HA default, no need to emit)
     if (!config.enabledByDefault) {
-        payload << ",\"enabled_by_default\":false";
+        json.field("enabled_by_default", false);
     }
 
     // Add device info
-    payload << ",\"device\":{\"identifiers\":[\"stiebel_eltron_" HA_DEVICE_MODEL "\"],"
-            << "\"name\":\"Stiebel Eltron Wärmepumpe\","
-            << "\"manufacturer\":\"Stiebel Eltron\"}}";
+    writeDiscoveryDevice(json, nullptr);
+    json.endObject();
 
     // Publish discovery message
-    std::string payloadStr = payload.str();
-    id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
-
-    ESP_LOGI("MQTT", "Discovery published for calculated sensor: %s", config.name);
+    if (publishDiscoveryPayload(discoveryTopic, json))
+        ESP_LOGI("MQTT", "Discovery published for calculated sensor: %s", config.name);
 }
 
 // Publish all calculated sensor discoveries (used during startup and republish)
 void publishAllCalculatedSensorDiscoveries(bool forceRepublish = false) {
     if (forceRepublish) {
-        discoveredCalculatedSensors.clear();
+        discoveredCalculatedSensors.reset();
         ESP_LOGI("MQTT", "Republishing all calculated sensor discoveries");
     }
     
@@ -631,24 +946,27 @@ void publishWritableNumberDiscovery(const WritableNumberConfig& config, bool for
     // Get CanMember for building topics
     const CanMember* cm = &CanMembers[config.member];
     
-    // Build unique ID
-    char uniqueId[128];
-    snprintf(uniqueId, sizeof(uniqueId), "stiebel_%s_%s", cm->Name, config.signalName);
-    std::string uid(uniqueId);
-    std::transform(uid.begin(), uid.end(), uid.begin(), ::tolower);
-    
-    // Check if already published (unless force republish)
-    if (!forceRepublish && discoveredWritableNumbers.find(uid) != discoveredWritableNumbers.end()) {
-        return;
+    // Check if already published (unless force republish); a config outside
+    // writableNumbers is not tracked
+    const size_t pos = tablePosition(writableNumbers, config);
+    if (pos < WRITABLE_NUMBER_COUNT) {
+        if (!forceRepublish && discoveredWritableNumbers[pos]) {
+            return;
+        }
+        
+        // Mark as discovered
+        discoveredWritableNumbers[pos] = true;
     }
     
-    // Mark as discovered
-    discoveredWritableNumbers.insert(uid);
+    // Build unique ID
+    char uid[128];
+    snprintf(uid, sizeof(uid), "stiebel_%s_%s", cm->Name, config.signalName);
+    std::transform(uid, uid + strlen(uid), uid, ::tolower);
     
     // Build discovery topic: homeassistant/number/heatingpump/<unique_id>/config
     char discoveryTopic[256];
     snprintf(discoveryTopic, sizeof(discoveryTopic), 
-             "homeassistant/number/heatingpump/%s/config", uid.c_str());
+             "homeassistant/number/heatingpump/%s/config", uid);
     
     // Build command topic: heatingpump/<MEMBER>/<SIGNAL>/set
     char commandTopic[128];
@@ -659,54 +977,34 @@ void publishWritableNumberDiscovery(const WritableNumberConfig& config, bool for
     snprintf(stateTopic, sizeof(stateTopic), "heatingpump/%s/%s/state", cm->Name, config.signalName);
     
     // Build JSON payload
-    std::ostringstream payload;
-    payload << "{\"name\":\"" << config.friendlyName << "\","
-            << "\"unique_id\":\"" << uid << "\","
-            << "\"command_topic\":\"" << commandTopic << "\","
-            << "\"state_topic\":\"" << stateTopic << "\","
-            << "\"min\":" << config.min << ","
-            << "\"max\":" << config.max << ","
-            << "\"step\":" << config.step << ","
-            << "\"mode\":\"box\","
-            << "\"unit_of_measurement\":\"" << config.unit << "\","
-            << "\"device_class\":\"" << config.deviceClass << "\","
-            << "\"icon\":\"" << config.icon << "\",";
-    
-    // Check if this is an SG Ready control - assign to main device
+    JsonWriter json(discoveryPayload, sizeof(discoveryPayload));
+    json.beginObject();
+    json.field("name", config.friendlyName);
+    json.field("unique_id", uid);
+    json.field("command_topic", commandTopic);
+    json.field("state_topic", stateTopic);
+    json.field("min", config.min);
+    json.field("max", config.max);
+    json.field("step", config.step);
+    json.field("mode", "box");
+    json.field("unit_of_measurement", config.unit);
+    json.field("device_class", config.deviceClass);
+    json.field("icon", config.icon);
+    
+    // SG Ready controls go to the main device, regular controls to their CAN member device
     bool isSgReady = (strncmp(config.signalName, "SG_READY_", 9) == 0);
-    
-    if (isSgReady) {
-        // SG Ready controls go to main device
-        payload << "\"device\":{\"identifiers\":[\"stiebel_eltron_" HA_DEVICE_MODEL "\"],"
-                << "\"name\":\"Stiebel Eltron Wärmepumpe\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-    } else {
-        // Regular controls go to their respective CAN member device
-        char canMemberDeviceId[64];
-        snprintf(canMemberDeviceId, sizeof(canMemberDeviceId), "stiebel_%s", cm->Name);
-
-        const char* canMemberFriendlyName = cm->Name;
-        if (strcmp(cm->Name, "KESSEL") == 0) canMemberFriendlyName = "Kessel";
-        else if (strcmp(cm->Name, "MANAGER") == 0) canMemberFriendlyName = "Manager";
-        else if (strcmp(cm->Name, "HEIZMODUL") == 0) canMemberFriendlyName = "Heizmodul";
-
-        payload << "\"device\":{\"identifiers\":[\"" << canMemberDeviceId << "\"],"
-                << "\"name\":\"" << canMemberFriendlyName << "\","
-                << "\"via_device\":\"stiebel_eltron_" HA_DEVICE_MODEL "\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-    }
+    writeDiscoveryDevice(json, isSgReady ? nullptr : cm);
+    json.endObject();
 
     // Publish discovery message
-    std::string payloadStr = payload.str();
-    id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
-
-    ESP_LOGI("MQTT", "Discovery published for writable number: %s", config.friendlyName);
+    if (publishDiscoveryPayload(discoveryTopic, json))
+        ESP_LOGI("MQTT", "Discovery published for writable number: %s", config.friendlyName);
 }
 
 // Publish all writable number discoveries
 void publishAllWritableNumberDiscoveries(bool forceRepublish = false) {
     if (forceRepublish) {
-        discoveredWritableNumbers.clear();
+        discoveredWritableNumbers.reset();
         ESP_LOGI("MQTT", "Republishing all writable number discoveries");
     }
     
@@ -726,81 +1024,63 @@ void publishWritableSelectDiscovery(const WritableSelectConfig& config, bool for
     // Get CAN member
     const CanMember* cm = &CanMembers[config.member];
     
+    // Check if already published (unless forcing); a config outside
+    // writableSelects is not tracked
+    const size_t pos = tablePosition(writableSelects, config);
+    if (!forceRepublish && pos < WRITABLE_SELECT_COUNT && discoveredWritableSelects[pos]) {
+        return;
+    }
+    
     // Build unique ID (lowercase with underscores)
     char uniqueId[128];
     snprintf(uniqueId, sizeof(uniqueId), "stiebel_%s_%s", cm->Name, config.signalName);
-    std::string uniqueIdStr(uniqueId);
-    std::transform(uniqueIdStr.begin(), uniqueIdStr.end(), uniqueIdStr.begin(), ::tolower);
-    
-    // Check if already published (unless forcing)
-    if (!forceRepublish && discoveredWritableSelects.count(uniqueIdStr) > 0) {
-        return;
-    }
+    std::transform(uniqueId, uniqueId + strlen(uniqueId), uniqueId, ::tolower);
     
     // Build discovery topic
-    std::ostringstream discoveryTopicStream;
-    discoveryTopicStream << "homeassistant/select/heatingpump/" << uniqueIdStr << "/config";
-    std::string discoveryTopic = discoveryTopicStream.str();
+    char discoveryTopic[256];
+    snprintf(discoveryTopic, sizeof(discoveryTopic), "homeassistant/select/heatingpump/%s/config", uniqueId);
     
     // Build command and state topics
-    std::ostringstream commandTopicStream;
-    commandTopicStream << "heatingpump/" << cm->Name << "/" << config.signalName << "/set";
-    std::string commandTopic = commandTopicStream.str();
+    char commandTopic[128];
+    snprintf(commandTopic, sizeof(commandTopic), "heatingpump/%s/%s/set", cm->Name, config.signalName);
     
-    std::ostringstream stateTopicStream;
-    stateTopicStream << "heatingpump/" << cm->Name << "/" << config.signalName << "/state";
-    std::string stateTopic = stateTopicStream.str();
+    char stateTopic[128];
+    snprintf(stateTopic, sizeof(stateTopic), "heatingpump/%s/%s/state", cm->Name, config.signalName);
     
     // Build JSON payload
-    std::ostringstream payload;
-    payload << "{\"name\":\"" << config.friendlyName << "\","
-            << "\"unique_id\":\"" << uniqueIdStr << "\","
-            << "\"command_topic\":\"" << commandTopic << "\","
-            << "\"state_topic\":\"" << stateTopic << "\","
-            << "\"options\":[";
+    JsonWriter json(discoveryPayload, sizeof(discoveryPayload));
+    json.beginObject();
+    json.field("name", config.friendlyName);
+    json.field("unique_id", uniqueId);
+    json.field("command_topic", commandTopic);
+    json.field("state_topic", stateTopic);
     
     // Add options array
+    json.beginArray("options");
     for (size_t i = 0; i < config.optionCount; i++) {
-        if (i > 0) payload << ",";
-        payload << "\"" << config.options[i] << "\"";
+        json.value(config.options[i]);
     }
-    payload << "],";
+    json.endArray();
     
     // Add icon if specified
     if (config.icon && strlen(config.icon) > 0) {
-        payload << "\"icon\":\"" << config.icon << "\",";
+        json.field("icon", config.icon);
     }
     
-    // Check if this is an SG Ready control - assign to main device
+    // SG Ready controls go to the main device, regular controls to their CAN member device
     bool isSgReady = (strncmp(config.signalName, "SG_READY_", 9) == 0);
-    
-    if (isSgReady) {
-        // SG Ready controls go to main device
-        payload << "\"device\":{\"identifiers\":[\"stiebel_eltron_" HA_DEVICE_MODEL "\"],"
-                << "\"name\":\"Stiebel Eltron Wärmepumpe\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-    } else {
-        // Regular controls go to their respective CAN member device
-        char canMemberDeviceId[64];
-        snprintf(canMemberDeviceId, sizeof(canMemberDeviceId), "stiebel_%s", cm->Name);
-
-        const char* canMemberFriendlyName = cm->Name;
-        if (strcmp(cm->Name, "KESSEL") == 0) canMemberFriendlyName = "Kessel";
-        else if (strcmp(cm->Name, "MANAGER") == 0) canMemberFriendlyName = "Manager";
-        else if (strcmp(cm->Name, "HEIZMODUL") == 0) canMemberFriendlyName = "Heizmodul";
-
-        payload << "\"device\":{\"identifiers\":[\"" << canMemberDeviceId << "\"],"
-                << "\"name\":\"" << canMemberFriendlyName << "\","
-                << "\"via_device\":\"stiebel_eltron_" HA_DEVICE_MODEL "\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-    }
+    writeDiscoveryDevice(json, isSgReady ? nullptr : cm);
+    json.endObject();
 
     // Publish discovery message
-    std::string payloadStr = payload.str();
-    id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
+    if (!publishDiscoveryPayload(discoveryTopic, json)) {
+        return;
+    }
 
     // Mark as discovered
-    discoveredWritableSelects.insert(uniqueIdStr);
+    if (pos < WRITABLE_SELECT_COUNT) {
+        discoveredWritableSelects[pos] = true;
+    }
     
     ESP_LOGI("MQTT", "Discovery published for writable select: %s", config.friendlyName);
 }
@@ -808,7 +1088,7 @@ void publishWritableSelectDiscovery(const WritableSelectConfig& config, bool for
 // Publish all writable select discoveries
 void publishAllWritableSelectDiscoveries(bool forceRepublish = false) {
     if (forceRepublish) {
-        discoveredWritableSelects.clear();
+        discoveredWritableSelects.reset();
         ESP_LOGI("MQTT", "Republishing all writable select discoveries");
     }
     
@@ -902,17 +1182,16 @@ void publishTime()
 // Datetime states are now handled by Home Assistant input_datetime helpers
 // Read by ESPHome text_sensors and written via button triggers
 
-void publishBetriebsart(const std::string& sommerBetriebValue)
+void publishBetriebsart(bool sommerBetrieb)
 {
     // Publish discovery (only once - cached)
     publishCalculatedSensorDiscovery(calculatedSensors[2]);
     
-    // Determine Betriebsart based on SOMMERBETRIEB value
-    // SOMMERBETRIEB is et_little_bool type, so value is "on" or "off"
+    // Determine Betriebsart based on SOMMERBETRIEB value (on = Sommerbetrieb)
     std::string betriebsart;
     std::string icon;
     
-    if (sommerBetriebValue == "on") {
+    if (sommerBetrieb) {
         betriebsart = "Sommerbetrieb";
         icon = "mdi:white-balance-sunny";
     } else {
@@ -923,7 +1202,7 @@ void publishBetriebsart(const std::string& sommerBetriebValue)
     // Publish state to MQTT
     const char* stateTopic = "heatingpump/calculated/betriebsart/state";
     id(mqtt_client).publish(stateTopic, betriebsart.c_str(), betriebsart.length(), 0, true);
-    // ESP_LOGD("CALC", "Published Betriebsart: %s (SOMMERBETRIEB=%s)", betriebsart.c_str(), sommerBetriebValue.c_str());
+    // ESP_LOGD("CALC", "Published Betriebsart: %s (SOMMERBETRIEB=%d)", betriebsart.c_str(), (int)sommerBetrieb);
 }
 
 void publishDeltaTContinuous()
@@ -1001,56 +1280,116 @@ void publishCompressorActive()
     // Note: Delta T running is published separately by scheduler
 }
 
-// Helper: Check if pattern appears anywhere in text (case-insensitive substring match)
-// Get or create cached UID for a signal (eliminates repeated string ops)
-inline std::string getOrCreateUID(const CanMember &cm, const char* signalName) {
-    // Create cache key
-    char cacheKey[256];
-    snprintf(cacheKey, sizeof(cacheKey), "%u:%s", cm.CanId, signalName);
-    
-    // Check cache first
-    auto it = uidCache.find(cacheKey);
-    if (it != uidCache.end()) {
-        return it->second;
+// Position of signal `ei` of `cm` in signalEntityIndex and discoveredSignals,
+// giving the member a slot on its first signal. -1 for a row outside
+// ElsterTable (the unlisted rows of a pruned table).
+int signalEntityKey(const CanMember &cm, const ElsterIndex *ei)
+{
+    if (ei < ElsterTable || ei >= ElsterTable + ElsterTableCount || cm.Member >= cCanMemberCount) {
+        return -1;
     }
-    
-    // Generate UID if not cached (no need to lookup CanMember - already have it)
-    char uid[128];
-    snprintf(uid, sizeof(uid), "stiebel_%s_%s", cm.Name, signalName);
-    std::string result(uid);
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    std::replace(result.begin(), result.end(), ' ', '_');
-    
-    // Store in cache
-    uidCache[cacheKey] = result;
-    return result;
+    uint8_t &slot = entityMemberSlots[cm.Member];
+    if (slot == 0) {
+        slot = ++entityMemberCount;
+        signalEntityIndex.resize(entityMemberCount * ElsterTableCount, 0);
+        discoveredSignals.resize(entityMemberCount * ElsterTableCount, false);
+    }
+    return (slot - 1) * ElsterTableCount + (ei - ElsterTable);
+}
+
+// Deadband of the state of signal `ei` of `cm`: the one of its row in
+// signalRequests, else STATE_DEADBAND_TEMPERATURE for temperatures and
+// STATE_DEADBAND_DEFAULT (exact match) for everything else
+float stateDeadband(const CanMember &cm, const ElsterIndex *ei)
+{
+    for (size_t i = 0; i < SIGNAL_REQUEST_COUNT; i++) {
+        const SignalRequest &req = signalRequests[i];
+        if (req.deadband >= 0 && (req.member == cm.Member || req.member == cm_other) &&
+            strcmp(req.signalName, ei->Name) == 0) {
+            return req.deadband;
+        }
+    }
+    const ElsterMetadata *meta = GetElsterMetadata(ei);
+    const char *component, *deviceClass, *unit, *stateClass, *icon;
+    getTypeDefaults((ElsterType)ei->Type, component, deviceClass, unit, stateClass, icon);
+    if (meta && meta->haDeviceClass) {
+        deviceClass = meta->haDeviceClass;
+    }
+    return strcmp(deviceClass, "temperature") == 0 ? STATE_DEADBAND_TEMPERATURE : STATE_DEADBAND_DEFAULT;
+}
+
+// Entity of signal `ei` of `cm`: its UID and topics are formatted on the first
+// call, later calls are two array lookups. nullptr for a row outside ElsterTable
+// or a name too long for a block.
+SignalEntity *signalEntity(const CanMember &cm, const ElsterIndex *ei)
+{
+    const int key = signalEntityKey(cm, ei);
+    if (key < 0) {
+        return nullptr;
+    }
+    uint16_t &pos = signalEntityIndex[key];
+    if (pos != 0) {
+        return &signalEntities[pos - 1];
+    }
+
+    // Component of the discovery topic: from the metadata, else the type default
+    const ElsterMetadata *meta = GetElsterMetadata(ei);
+    const char *component, *deviceClass, *unit, *stateClass, *icon;
+    if (meta && meta->haComponent) {
+        component = meta->haComponent;
+    } else {
+        getTypeDefaults((ElsterType)ei->Type, component, deviceClass, unit, stateClass, icon);
+    }
+
+    char *uid = signalNames.format("stiebel_%s_%s", cm.Name, ei->Name);
+    if (!uid) {
+        ESP_LOGW("MQTT", "Names of %s/%s too long, not published", cm.Name, ei->Name);
+        return nullptr;
+    }
+    std::transform(uid, uid + strlen(uid), uid, ::tolower);
+    std::replace(uid, uid + strlen(uid), ' ', '_');
+    const char *stateTopic = signalNames.format("heatingpump/%s/%s/state", cm.Name, ei->Name);
+    const char *discoveryTopic = signalNames.format("homeassistant/%s/heatingpump/%s/config", component, uid);
+    if (!stateTopic || !discoveryTopic) {
+        ESP_LOGW("MQTT", "Names of %s/%s too long, not published", cm.Name, ei->Name);
+        return nullptr;
+    }
+
+    signalEntities.push_back({uid, stateTopic, discoveryTopic, (uint16_t)(ei - ElsterTable), (uint8_t)cm.Member,
+                              stateDeadband(cm, ei), PublishedState()});
+    pos = signalEntities.size();
+    return &signalEntities.back();
 }
 
 // Publish MQTT Discovery config for a signal
 void publishMqttDiscovery(const CanMember &cm, const ElsterIndex *ei) {
     
-    // Get cached UID (avoids repeated string operations)
-    std::string uid = getOrCreateUID(cm, ei->Name);
+    // Interned UID and topics
+    const SignalEntity *entity = signalEntity(cm, ei);
+    if (!entity) {
+        return;
+    }
     
-    // Note: Caller is responsible for checking discoveredSignals and inserting uid
+    // Note: Caller is responsible for checking and setting discoveredSignals
     // This function just publishes the MQTT discovery message
     
-    // Get friendly name: use ei->friendlyName or fallback to ei->Name
-    const char* friendlyName = (ei->hasMetadata && ei->friendlyName) ? ei->friendlyName : ei->Name;
+    // Get friendly name: use the metadata friendlyName or fallback to ei->Name
+    const ElsterMetadata *meta = GetElsterMetadata(ei);
+    const char* friendlyName = (meta && meta->friendlyName) ? meta->friendlyName : ei->Name;
     
-    // Get metadata: use ei fields if available, otherwise fall back to type defaults
+    // Get metadata: use ElsterTable metadata if available, otherwise fall back to type defaults
     const char *component, *deviceClass, *unit, *stateClass, *icon;
     const char *payloadOn = nullptr, *payloadOff = nullptr;
     
-    if (ei->hasMetadata && ei->haComponent) {
+    if (meta && meta->haComponent) {
         // Use metadata from ElsterTable
-        component = ei->haComponent;
-        deviceClass = ei->haDeviceClass ? ei->haDeviceClass : "";
-        unit = ei->unit ? ei->unit : "";
-        stateClass = ei->stateClass ? ei->stateClass : "";
-        icon = ei->icon ? ei->icon : "";
-        payloadOn = ei->payloadOn;
-        payloadOff = ei->payloadOff;
+        component = meta->haComponent;
+        deviceClass = meta->haDeviceClass ? meta->haDeviceClass : "";
+        unit = meta->unit ? meta->unit : "";
+        stateClass = meta->stateClass ? meta->stateClass : "";
+        icon = meta->icon ? meta->icon : "";
+        payloadOn = meta->payloadOn;
+        payloadOff = meta->payloadOff;
     } else {
         // Fall back to type-based defaults
         getTypeDefaults((ElsterType)ei->Type, component, deviceClass, unit, stateClass, icon);
@@ -1061,34 +1400,26 @@ void publishMqttDiscovery(const CanMember &cm, const ElsterIndex *ei) {
         }
     }
     
-    // Build discovery topic
-    char discoveryTopic[256];
-    snprintf(discoveryTopic, sizeof(discoveryTopic), 
-             "homeassistant/%s/heatingpump/%s/config", component, uid.c_str());
-    
-    // Build state topic
-    char stateTopic[128];
-    snprintf(stateTopic, sizeof(stateTopic), "heatingpump/%s/%s/state", cm.Name, ei->Name);
-    
-    // Build JSON payload efficiently using ostringstream
-    std::ostringstream payload;
-    payload << "{\"name\":\"" << friendlyName << "\","
-            << "\"unique_id\":\"" << uid << "\","
-            << "\"state_topic\":\"" << stateTopic << "\","
-            << "\"availability_topic\":\"heatingpump/status\"";
+    // Build JSON payload in the shared buffer, no heap
+    JsonWriter json(discoveryPayload, sizeof(discoveryPayload));
+    json.beginObject();
+    json.field("name", friendlyName);
+    json.field("unique_id", entity->uid);
+    json.field("state_topic", entity->stateTopic);
+    json.field("availability_topic", "heatingpump/status");
     
     // For binary sensors, specify payload values
     if (strcmp(component, "binary_sensor") == 0 && payloadOn && payloadOff) {
-        payload << ",\"payload_on\":\"" << payloadOn << "\","
-                << "\"payload_off\":\"" << payloadOff << "\"";
+        json.field("payload_on", payloadOn);
+        json.field("payload_off", payloadOff);
     }
     
     // Add optional fields only if non-empty
     if (deviceClass[0] != '\0') {
-        payload << ",\"device_class\":\"" << deviceClass << "\"";
+        json.field("device_class", deviceClass);
     }
     if (unit[0] != '\0') {
-        payload << ",\"unit_of_measurement\":\"" << unit << "\"";
+        json.field("unit_of_measurement", unit);
     }
     // State class only for numeric sensors
     if (stateClass[0] != '\0') {
@@ -1100,214 +1431,266 @@ void publishMqttDiscovery(const CanMember &cm, const ElsterIndex *ei) {
                               ei->Type == et_triple_val ||
                               ei->Type == et_little_endian);
         if (isNumericType) {
-            payload << ",\"state_class\":\"" << stateClass << "\"";
+            json.field("state_class", stateClass);
         }
     }
     if (icon[0] != '\0') {
-        payload << ",\"icon\":\"" << icon << "\"";
+        json.field("icon", icon);
     }
     
-    // Device info - create individual device per CAN member as sub-device
-    // Main device ID for the heat pump
-    const char* mainDeviceId = "stiebel_eltron_" HA_DEVICE_MODEL;
-    
-    // Create unique device ID for this CAN member
-    char canMemberDeviceId[64];
-    snprintf(canMemberDeviceId, sizeof(canMemberDeviceId), "stiebel_%s", cm.Name);
-    
-    // Convert CAN member name to friendly German name
-    const char* canMemberFriendlyName = cm.Name;
-    if (strcmp(cm.Name, "KESSEL") == 0) canMemberFriendlyName = "Kessel";
-    else if (strcmp(cm.Name, "MANAGER") == 0) canMemberFriendlyName = "Manager";
-    else if (strcmp(cm.Name, "HEIZMODUL") == 0) canMemberFriendlyName = "Heizmodul";
-    else if (strcmp(cm.Name, "FEHLERSPEICHER") == 0) canMemberFriendlyName = "Fehlerspeicher";
-    else if (strcmp(cm.Name, "MIXER1") == 0) canMemberFriendlyName = "Mischer 1";
-    else if (strcmp(cm.Name, "MIXER2") == 0) canMemberFriendlyName = "Mischer 2";
-    else if (strcmp(cm.Name, "WMZ1") == 0) canMemberFriendlyName = "Wärmemengenzähler 1";
-    else if (strcmp(cm.Name, "WMZ2") == 0) canMemberFriendlyName = "Wärmemengenzähler 2";
-    
-    payload << ",\"device\":{\"identifiers\":[\"" << canMemberDeviceId << "\"],"
-            << "\"name\":\"" << canMemberFriendlyName << "\","
-            << "\"via_device\":\"" << mainDeviceId << "\","
-            << "\"manufacturer\":\"Stiebel Eltron\"}}";
+    // Device info - individual device per CAN member as sub-device of the heat pump
+    writeDiscoveryDevice(json, &cm);
+    json.endObject();
     
     // Publish discovery message with retain flag
-    std::string payloadStr = payload.str();
-    id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
-    
-    ESP_LOGI("MQTT", "Discovery published for %s", friendlyName);
-}
-
-// Republish all MQTT discoveries (for periodic refresh)
-void republishAllDiscoveries() {
-    ESP_LOGI("MQTT", "Republishing all MQTT discoveries (%d signals)", discoveredSignals.size());
-    
-    // Create a copy of discovered signals to iterate over, filtering out blacklisted signals
-    std::set<std::string> signalsToRepublish;
-    int blacklistedCount = 0;
-    
-    for (const auto& uid : discoveredSignals) {
-        // Extract signal name from UID (format: "can_id_signalName")
-        // Find last underscore to get signal name
-        size_t lastUnderscore = uid.find_last_of('_');
-        if (lastUnderscore != std::string::npos) {
-            std::string signalName = uid.substr(lastUnderscore + 1);
-            
-            // Skip blacklisted signals
-            if (isPermanentlyBlacklisted(signalName.c_str())) {
-                blacklistedCount++;
-                ESP_LOGD("MQTT", "Skipping blacklisted signal during republish: %s", signalName.c_str());
-                continue;
-            }
-        }
-        
-        signalsToRepublish.insert(uid);
-    }
-    
-    if (blacklistedCount > 0) {
-        ESP_LOGI("MQTT", "Filtered out %d blacklisted signals during republish", blacklistedCount);
-    }
-    
-    // Clear the set and re-add only non-blacklisted signals
-    discoveredSignals = signalsToRepublish;
-    
-    // Force republish by reading all known signals
-    // This will trigger processAndUpdate which calls publishMqttDiscovery
-    for (const auto& signal : signalsToRepublish) {
-        ESP_LOGD("MQTT", "Marked for republish: %s", signal.c_str());
-    }
-    
-    // Republish all calculated sensor discoveries using unified system
-    publishAllCalculatedSensorDiscoveries(true);
-    
-    ESP_LOGI("MQTT", "Discovery refresh complete - will republish as signals are received");
+    if (publishDiscoveryPayload(entity->discoveryTopic, json))
+        ESP_LOGI("MQTT", "Discovery published for %s", friendlyName);
 }
 
 // Publish signal state to MQTT
-void publishMqttState(const CanMember &cm, const ElsterIndex *ei, const std::string &value) {
+void publishMqttState(const CanMember &cm, const ElsterIndex *ei, const char *value) {
     // Input validation
-    if (!ei || !ei->Name || value.empty()) {
+    if (!ei || !ei->Name || !value || !*value) {
         ESP_LOGW("MQTT", "Invalid signal data, skipping state publish");
         return;
     }
     
-    // Build state topic with bounds checking
-    char stateTopic[128];
-    int written = snprintf(stateTopic, sizeof(stateTopic), "heatingpump/%s/%s/state", cm.Name, ei->Name);
-    if (written >= sizeof(stateTopic)) {
-        ESP_LOGW("MQTT", "Topic too long for %s/%s, truncated", cm.Name, ei->Name);
+    // Interned state topic
+    const SignalEntity *entity = signalEntity(cm, ei);
+    if (!entity) {
+        return;
     }
     
     // Publish state with retain flag
-    id(mqtt_client).publish(stateTopic, value.c_str(), value.length(), 0, true);
+    id(mqtt_client).publish(entity->stateTopic, value, strlen(value), 0, true);
+}
+
+// Forget the last published states, so every signal publishes its next value
+// (after a reconnect, e.g. to a broker that lost its retained messages)
+void forgetPublishedStates() {
+    for (SignalEntity &entity : signalEntities) {
+        entity.state = PublishedState();
+    }
 }
 
 // Diagnostics removed for simplification
 
-// Track which COP values we have valid data for
-static std::unordered_map<std::string, float> copEnergyValues;
+// Energy counters the COPs are calculated from, the signals of pg_cop
+typedef enum {
+    ce_el_heiz,             // EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH
+    ce_el_ww,               // EL_AUFNAHMELEISTUNG_WW_SUM_MWH
+    ce_waerme_heiz,         // WAERMEERTRAG_HEIZ_SUM_MWH
+    ce_waerme_ww,           // WAERMEERTRAG_WW_SUM_MWH
+    ce_waerme_2we_heiz,     // WAERMEERTRAG_2WE_HEIZ_SUM_MWH
+    ce_waerme_2we_ww,       // WAERMEERTRAG_2WE_WW_SUM_MWH
+    ce_count
+} CopEnergyId;
+
+// Last value of each COP energy counter, valid once one was received
+static float copEnergyValues[ce_count];
+static bool copEnergyValid[ce_count];
+
+// COP WW, COP Heizung, COP Gesamt
+struct COPSensorConfig {
+    const char *name;
+    const char *id;
+    const char *icon;
+};
+static const COPSensorConfig copSensors[] = {
+    {LNAME_COP_WW, "cop_ww", "mdi:water-boiler"},
+    {LNAME_COP_HEIZ, "cop_heiz", "mdi:radiator"},
+    {LNAME_COP_GESAMT, "cop_gesamt", "mdi:chart-line"},
+};
+static const size_t COP_SENSOR_COUNT = sizeof(copSensors) / sizeof(COPSensorConfig);
+static bool copDiscoveryPublished = false;
+
+// Publish MQTT discovery for one COP sensor
+void publishCOPSensorDiscovery(const COPSensorConfig &cop) {
+    char discoveryTopic[64];
+    char uniqueId[32];
+    char stateTopic[64];
+    snprintf(discoveryTopic, sizeof(discoveryTopic), "homeassistant/sensor/heatingpump/%s/config", cop.id);
+    snprintf(uniqueId, sizeof(uniqueId), "stiebel_%s", cop.id);
+    snprintf(stateTopic, sizeof(stateTopic), "heatingpump/calculated/%s/state", cop.id);
+
+    JsonWriter json(discoveryPayload, sizeof(discoveryPayload));
+    json.beginObject();
+    json.field("name", cop.name);
+    json.field("unique_id", uniqueId);
+    json.field("state_topic", stateTopic);
+    json.field("icon", cop.icon);
+    json.field("state_class", "measurement");
+    writeDiscoveryDevice(json, nullptr);
+    json.endObject();
+    publishDiscoveryPayload(discoveryTopic, json);
+}
 
 // Publish MQTT discovery for COP sensors
 void publishCOPDiscovery() {
-    static bool discoveryPublished = false;
-    if (discoveryPublished) return;
+    if (copDiscoveryPublished) return;
     
-    // COP WW
-    {
-        const char* discoveryTopic = "homeassistant/sensor/heatingpump/cop_ww/config";
-        std::ostringstream payload;
-        payload << "{\"name\":\"" LNAME_COP_WW "\","
-                << "\"unique_id\":\"stiebel_cop_ww\","
-                << "\"state_topic\":\"heatingpump/calculated/cop_ww/state\","
-                << "\"icon\":\"mdi:water-boiler\","
-                << "\"state_class\":\"measurement\","
-                << "\"device\":{\"identifiers\":[\"stiebel_eltron_" HA_DEVICE_MODEL "\"],"
-                << "\"name\":\"Stiebel Eltron Wärmepumpe\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-        std::string payloadStr = payload.str();
-        id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
-    }
-    
-    // COP Heizung
-    {
-        const char* discoveryTopic = "homeassistant/sensor/heatingpump/cop_heiz/config";
-        std::ostringstream payload;
-        payload << "{\"name\":\"" LNAME_COP_HEIZ "\","
-                << "\"unique_id\":\"stiebel_cop_heiz\","
-                << "\"state_topic\":\"heatingpump/calculated/cop_heiz/state\","
-                << "\"icon\":\"mdi:radiator\","
-                << "\"state_class\":\"measurement\","
-                << "\"device\":{\"identifiers\":[\"stiebel_eltron_" HA_DEVICE_MODEL "\"],"
-                << "\"name\":\"Stiebel Eltron Wärmepumpe\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-        std::string payloadStr = payload.str();
-        id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
-    }
-    
-    // COP Gesamt
-    {
-        const char* discoveryTopic = "homeassistant/sensor/heatingpump/cop_gesamt/config";
-        std::ostringstream payload;
-        payload << "{\"name\":\"" LNAME_COP_GESAMT "\","
-                << "\"unique_id\":\"stiebel_cop_gesamt\","
-                << "\"state_topic\":\"heatingpump/calculated/cop_gesamt/state\","
-                << "\"icon\":\"mdi:chart-line\","
-                << "\"state_class\":\"measurement\","
-                << "\"device\":{\"identifiers\":[\"stiebel_eltron_" HA_DEVICE_MODEL "\"],"
-                << "\"name\":\"Stiebel Eltron Wärmepumpe\","
-                << "\"manufacturer\":\"Stiebel Eltron\"}}";
-        std::string payloadStr = payload.str();
-        id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
-    }
-    
-    discoveryPublished = true;
+    for (const COPSensorConfig &cop : copSensors) {
+        publishCOPSensorDiscovery(cop);
+    }
+    
+    copDiscoveryPublished = true;
     ESP_LOGI("MQTT", "Discovery published for COP sensors");
 }
 
-// Store energy value when received for COP calculation
-void storeCOPEnergyValue(const char* signalName, const std::string &value) {
-    // Validate the string contains a valid number (no exceptions available)
-    if (value.empty()) {
-        ESP_LOGW("COP", "Empty value for %s", signalName);
+// ============================================================================
+// DISCOVERY REPUBLISH
+// ============================================================================
+
+// A republish walks every known entity and publishes its discovery config,
+// at most DISCOVERY_REPUBLISH_PER_SEC per second from the main loop. Positions
+// run through the signals, calculated and COP sensors published so far, then
+// all writable numbers and selects. Entities that were never published are
+// passed over without using budget.
+struct DiscoveryRepublish {
+    bool active = false;
+    const char *reason = "";
+    size_t signals = 0;     // signalEntities at the start; later ones publish their own
+    size_t total = 0;
+    size_t position = 0;
+    size_t sent = 0;
+    uint32_t startMs = 0;
+    uint32_t progressMs = 0;
+};
+static DiscoveryRepublish discoveryRepublish;
+static RequestPacer discoveryRepublishPacer;
+
+// Publish the discovery at republish position `pos`; false if it needs none
+bool republishDiscoveryAt(size_t pos, size_t signals)
+{
+    if (pos < signals) {
+        const SignalEntity &entity = signalEntities[pos];
+        const CanMember &cm = CanMembers[entity.member];
+        const ElsterIndex *ei = &ElsterTable[entity.row];
+        if (!discoveredSignals[signalEntityKey(cm, ei)]) {
+            return false;
+        }
+        publishMqttDiscovery(cm, ei);
+        return true;
+    }
+    pos -= signals;
+    if (pos < CALCULATED_SENSOR_COUNT) {
+        if (!discoveredCalculatedSensors[pos]) {
+            return false;
+        }
+        publishCalculatedSensorDiscovery(calculatedSensors[pos], true);
+        return true;
+    }
+    pos -= CALCULATED_SENSOR_COUNT;
+    if (pos < COP_SENSOR_COUNT) {
+        if (!copDiscoveryPublished) {
+            return false;
+        }
+        publishCOPSensorDiscovery(copSensors[pos]);
+        return true;
+    }
+    pos -= COP_SENSOR_COUNT;
+    if (pos < WRITABLE_NUMBER_COUNT) {
+        publishWritableNumberDiscovery(writableNumbers[pos], true);
+        return true;
+    }
+    pos -= WRITABLE_NUMBER_COUNT;
+    if (pos < WRITABLE_SELECT_COUNT) {
+        publishWritableSelectDiscovery(writableSelects[pos], true);
+        return true;
+    }
+    return false;
+}
+
+// Progress of the current or last republish, as JSON to
+// heatingpump/discovery_republish/state
+void publishDiscoveryRepublishProgress(uint32_t now) {
+    const DiscoveryRepublish &r = discoveryRepublish;
+    char buf[160];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.field("state", r.active ? "running" : "done");
+    json.field("reason", r.reason);
+    json.field("position", (unsigned long)r.position);
+    json.field("total", (unsigned long)r.total);
+    json.field("sent", (unsigned long)r.sent);
+    json.field("duration", (unsigned long)(now - r.startMs));
+    json.endObject();
+    if (!json.ok()) {
+        ESP_LOGW("MQTT", "Discovery republish progress does not fit in %u bytes", (unsigned)sizeof(buf));
         return;
     }
-    
-    // Check for valid numeric characters
-    bool hasDigit = false;
-    bool isValid = true;
-    for (size_t i = 0; i < value.length(); i++) {
-        char c = value[i];
-        if (c >= '0' && c <= '9') {
-            hasDigit = true;
-        } else if (c != '.' && c != '-' && c != '+' && c != ' ') {
-            isValid = false;
-            break;
+    id(mqtt_client).publish("heatingpump/discovery_republish/state", json.c_str(), json.size(), 0, true);
+}
+
+// Republish all MQTT discoveries, paced (15 min interval, HA restart, manual).
+// A republish in progress starts over.
+void republishAllDiscoveries(const char *reason = "manual") {
+    const uint32_t now = millis();
+    DiscoveryRepublish &r = discoveryRepublish;
+    if (r.active) {
+        ESP_LOGI("MQTT", "Discovery republish restarted (%s) at %u of %u", reason, (unsigned)r.position,
+                 (unsigned)r.total);
+    }
+    r = DiscoveryRepublish();
+    r.active = true;
+    r.reason = reason;
+    r.signals = signalEntities.size();
+    r.total = r.signals + CALCULATED_SENSOR_COUNT + COP_SENSOR_COUNT + WRITABLE_NUMBER_COUNT + WRITABLE_SELECT_COUNT;
+    r.startMs = now;
+    r.progressMs = now;
+    discoveryRepublishPacer.configure(DISCOVERY_REPUBLISH_PER_SEC, 0, now);
+    ESP_LOGI("MQTT", "Republishing MQTT discoveries (%s): %u signals, %u entities at most %d/s", reason,
+             (unsigned)r.signals, (unsigned)r.total, DISCOVERY_REPUBLISH_PER_SEC);
+    publishDiscoveryRepublishProgress(now);
+}
+
+// Publish the discoveries of the running republish that are due at `now`
+void runDiscoveryRepublish(uint32_t now) {
+    DiscoveryRepublish &r = discoveryRepublish;
+    if (!r.active) {
+        return;
+    }
+    while (r.position < r.total && discoveryRepublishPacer.ready(now)) {
+        if (republishDiscoveryAt(r.position++, r.signals)) {
+            discoveryRepublishPacer.sent(now);
+            r.sent++;
         }
     }
-    
-    if (!hasDigit || !isValid) {
-        ESP_LOGW("COP", "Invalid numeric value for %s: %s", signalName, value.c_str());
+    if (r.position >= r.total) {
+        r.active = false;
+        ESP_LOGI("MQTT", "Discovery republish (%s) complete: %u messages in %lu ms", r.reason, (unsigned)r.sent,
+                 (unsigned long)(now - r.startMs));
+        publishDiscoveryRepublishProgress(now);
+    } else if (now - r.progressMs >= DISCOVERY_REPUBLISH_PROGRESS_MS) {
+        r.progressMs = now;
+        publishDiscoveryRepublishProgress(now);
+    }
+}
+
+// Store energy value when received for COP calculation
+void storeCOPEnergyValue(CopEnergyId id, const ElsterValue &value) {
+    if (!value.hasNumber) {
+        ESP_LOGW("COP", "Invalid numeric value for energy counter %d (raw 0x%04x)", (int)id, value.Raw);
         return;
     }
     
-    // Parse the value (std::stof may still fail but won't throw in this context)
-    float fval = std::atof(value.c_str());
-    copEnergyValues[signalName] = fval;
-    ESP_LOGD("COP", "Stored %s = %.3f", signalName, fval);
+    float fval = ElsterValueToFloat(value);
+    copEnergyValues[id] = fval;
+    copEnergyValid[id] = true;
+    ESP_LOGD("COP", "Stored energy counter %d = %.3f", (int)id, fval);
 }
 
 // Calculate and publish COP values if all required data is available
 void updateCOPCalculations() {
     publishCOPDiscovery();
+    const float *e = copEnergyValues;
+    const bool *valid = copEnergyValid;
     
     // COP WW: (WAERMEERTRAG_WW_SUM + WAERMEERTRAG_2WE_WW_SUM) / EL_AUFNAHMELEISTUNG_WW_SUM
-    if (copEnergyValues.find("WAERMEERTRAG_WW_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("WAERMEERTRAG_2WE_WW_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("EL_AUFNAHMELEISTUNG_WW_SUM_MWH") != copEnergyValues.end()) {
-        
-        float el_ww = copEnergyValues["EL_AUFNAHMELEISTUNG_WW_SUM_MWH"];
+    if (valid[ce_waerme_ww] && valid[ce_waerme_2we_ww] && valid[ce_el_ww]) {
+        float el_ww = e[ce_el_ww];
         if (el_ww > 0.001f) { // Avoid division by zero
-            float waerme_ww = copEnergyValues["WAERMEERTRAG_WW_SUM_MWH"] + copEnergyValues["WAERMEERTRAG_2WE_WW_SUM_MWH"];
+            float waerme_ww = e[ce_waerme_ww] + e[ce_waerme_2we_ww];
             float cop_ww = waerme_ww / el_ww;
             
             char valueStr[16];
@@ -1319,13 +1702,10 @@ void updateCOPCalculations() {
     }
     
     // COP Heizung: (WAERMEERTRAG_HEIZ_SUM + WAERMEERTRAG_2WE_HEIZ_SUM) / EL_AUFNAHMELEISTUNG_HEIZ_SUM
-    if (copEnergyValues.find("WAERMEERTRAG_HEIZ_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("WAERMEERTRAG_2WE_HEIZ_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH") != copEnergyValues.end()) {
-        
-        float el_heiz = copEnergyValues["EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH"];
+    if (valid[ce_waerme_heiz] && valid[ce_waerme_2we_heiz] && valid[ce_el_heiz]) {
+        float el_heiz = e[ce_el_heiz];
         if (el_heiz > 0.001f) { // Avoid division by zero
-            float waerme_heiz = copEnergyValues["WAERMEERTRAG_HEIZ_SUM_MWH"] + copEnergyValues["WAERMEERTRAG_2WE_HEIZ_SUM_MWH"];
+            float waerme_heiz = e[ce_waerme_heiz] + e[ce_waerme_2we_heiz];
             float cop_heiz = waerme_heiz / el_heiz;
             
             char valueStr[16];
@@ -1337,17 +1717,12 @@ void updateCOPCalculations() {
     }
     
     // COP Gesamt: (all WAERMEERTRAG) / (all EL_AUFNAHMELEISTUNG)
-    if (copEnergyValues.find("WAERMEERTRAG_HEIZ_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("WAERMEERTRAG_2WE_HEIZ_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("WAERMEERTRAG_WW_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("WAERMEERTRAG_2WE_WW_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH") != copEnergyValues.end() &&
-        copEnergyValues.find("EL_AUFNAHMELEISTUNG_WW_SUM_MWH") != copEnergyValues.end()) {
-        
-        float el_total = copEnergyValues["EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH"] + copEnergyValues["EL_AUFNAHMELEISTUNG_WW_SUM_MWH"];
+    bool all = true;
+    for (int i = 0; i < ce_count; i++) all = all && valid[i];
+    if (all) {
+        float el_total = e[ce_el_heiz] + e[ce_el_ww];
         if (el_total > 0.001f) { // Avoid division by zero
-            float waerme_total = copEnergyValues["WAERMEERTRAG_HEIZ_SUM_MWH"] + copEnergyValues["WAERMEERTRAG_2WE_HEIZ_SUM_MWH"] +
-                               copEnergyValues["WAERMEERTRAG_WW_SUM_MWH"] + copEnergyValues["WAERMEERTRAG_2WE_WW_SUM_MWH"];
+            float waerme_total = e[ce_waerme_heiz] + e[ce_waerme_2we_heiz] + e[ce_waerme_ww] + e[ce_waerme_2we_ww];
             float cop_gesamt = waerme_total / el_total;
             
             char valueStr[16];
@@ -1373,10 +1748,27 @@ public:
     static ESPPreferenceObject nvsRoom;
     static ESPPreferenceObject nvsActive;
 
+    // Writes between beginCanWrites() and endCanWrites() run as one
+    // transaction, any other write as a transaction of its own
     void writeCanSignal(const char* signalName, const char* value) override {
-        writeSignal(&CanMembers[cm_manager], signalName, value);
-        delay(100);
-        readSignal(&CanMembers[cm_manager], signalName);
+        if (grouping_) {
+            addSequenceStep(pending_, &CanMembers[cm_manager], signalName, value);
+            return;
+        }
+        CommandTransaction single = {signalName};
+        if (addSequenceStep(single, &CanMembers[cm_manager], signalName, value))
+            submitSequence(single);
+    }
+
+    void beginCanWrites(const char* name) override {
+        pending_ = {name};
+        grouping_ = true;
+    }
+
+    void endCanWrites() override {
+        grouping_ = false;
+        if (pending_.count > 0)
+            submitSequence(pending_);
     }
 
     void publishMqtt(const char* topic, const char* value) override {
@@ -1397,6 +1789,10 @@ public:
         nvsRoom.load(&room);
         return ok;
     }
+
+private:
+    CommandTransaction pending_ = {};
+    bool grouping_ = false;
 };
 
 ESPPreferenceObject EspHomeSgReadyIO::nvsDhw;
@@ -1480,37 +1876,61 @@ constexpr uint32_t HASH_WAERMEERTRAG_HEIZ = hash("WAERMEERTRAG_HEIZ_SUM_MWH");
 
 
 
-void updateSensor(const CanMember &cm, const ElsterIndex *ei, const std::string &value)
+// True if the inputs of calculated sensors fed by poll group `id` must come
+// from its rounds: the group is polled and `grouped` (the value is part of a
+// round) is false
+inline bool ignoreOutsidePollGroup(PollGroupId id, bool grouped)
+{
+    return !grouped && pollGroups[id].size > 0;
+}
+
+// Store COP energy counter `id`; a value outside a poll group round updates the
+// COPs right away
+void updateCOPEnergy(CopEnergyId id, const ElsterValue &value, bool grouped)
+{
+    if (ignoreOutsidePollGroup(pg_cop, grouped)) return;
+    storeCOPEnergyValue(id, value);
+    if (!grouped) updateCOPCalculations();
+}
+
+// Publish `value` of signal `ei` from `cm` as the state of its entity, with
+// its discovery the first time
+void publishSignalValue(const CanMember &cm, const ElsterIndex *ei, ElsterValue &value)
 {
-    // Skip empty values
-    if (value.empty()) {
-        return;
-    }
-    
     // Invert boolean logic for EVU_SPERRE_AKTIV signal
     // CAN: 1 = lock inactive (off), 0 = lock active (on)
     // MQTT: "off" = lock inactive, "on" = lock active
-    std::string publishValue = value;
-    if (strcmp(ei->Name, "EVU_SPERRE_AKTIV") == 0) {
-        if (value == "on") {
-            publishValue = "off";
-        } else if (value == "off") {
-            publishValue = "on";
-        }
+    const char* publishValue;
+    if (strcmp(ei->Name, "EVU_SPERRE_AKTIV") == 0 && value.hasNumber && (value.Fixed == 0 || value.Fixed == 1)) {
+        publishValue = value.Fixed ? "off" : "on";
+    } else {
+        publishValue = ElsterValueText(value);
     }
     
     // Check if discovery is needed
-    std::string uid = getOrCreateUID(cm, ei->Name);
-    bool needsDiscovery = (discoveredSignals.find(uid) == discoveredSignals.end());
+    const int key = signalEntityKey(cm, ei);
     
-    if (needsDiscovery) {
+    if (key >= 0 && !discoveredSignals[key]) {
         // Mark as discovered and publish discovery immediately
-        discoveredSignals.insert(uid);
+        discoveredSignals[key] = true;
         publishMqttDiscovery(cm, ei);
     }
     
-    // Publish state
-    publishMqttState(cm, ei, publishValue);
+    // Publish state, unless it equals the last published one within the
+    // deadband of the signal and its heartbeat is not yet due
+    SignalEntity *entity = signalEntity(cm, ei);
+    if (entity && StateFilter::publishes(stateFilter.check(entity->state, publishValue, value.hasNumber, value.Fixed,
+                                                           value.Decimals, entity->deadband, millis()))) {
+        publishMqttState(cm, ei, publishValue);
+    }
+}
+
+// Publish `value` of signal `ei` from `cm` and update the calculated sensors
+// that use it. `grouped` marks a value of a complete poll group round: it only
+// updates the inputs, flushPollGroup() updates the calculated sensors after.
+void updateSensor(const CanMember &cm, const ElsterIndex *ei, ElsterValue &value, bool grouped = false)
+{
+    publishSignalValue(cm, ei, value);
     
     // Fast signal dispatch using compile-time hash (O(1) switch/jump table)
     const char* signalName = ei->Name;
@@ -1518,116 +1938,103 @@ void updateSensor(const CanMember &cm, const ElsterIndex *ei, const std::string
     
     switch (signalHash) {
         case HASH_JAHR: {
-            char* endPtr;
-            long intValue = strtol(value.c_str(), &endPtr, 10);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastJahr = static_cast<int>(intValue);
+            if (ignoreOutsidePollGroup(pg_datetime, grouped)) break;
+            if (value.hasNumber && value.Decimals == 0) {
+                lastJahr = static_cast<int>(value.Fixed);
                 // ESP_LOGD("CALC", "Updated JAHR: %d", lastJahr);
             }
             break;
         }
         
         case HASH_MONAT: {
-            char* endPtr;
-            long intValue = strtol(value.c_str(), &endPtr, 10);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastMonat = static_cast<int>(intValue);
+            if (ignoreOutsidePollGroup(pg_datetime, grouped)) break;
+            if (value.hasNumber && value.Decimals == 0) {
+                lastMonat = static_cast<int>(value.Fixed);
                 // ESP_LOGD("CALC", "Updated MONAT: %d", lastMonat);
             }
             break;
         }
         
         case HASH_TAG: {
-            char* endPtr;
-            long intValue = strtol(value.c_str(), &endPtr, 10);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastTag = static_cast<int>(intValue);
+            if (ignoreOutsidePollGroup(pg_datetime, grouped)) break;
+            if (value.hasNumber && value.Decimals == 0) {
+                lastTag = static_cast<int>(value.Fixed);
                 // ESP_LOGD("CALC", "Updated TAG: %d", lastTag);
-                publishDate();
+                if (!grouped) publishDate();
             }
             break;
         }
         
         case HASH_STUNDE: {
-            char* endPtr;
-            long intValue = strtol(value.c_str(), &endPtr, 10);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastStunde = static_cast<int>(intValue);
+            if (ignoreOutsidePollGroup(pg_datetime, grouped)) break;
+            if (value.hasNumber && value.Decimals == 0) {
+                lastStunde = static_cast<int>(value.Fixed);
                 // ESP_LOGD("CALC", "Updated STUNDE: %d", lastStunde);
             }
             break;
         }
         
         case HASH_MINUTE: {
-            char* endPtr;
-            long intValue = strtol(value.c_str(), &endPtr, 10);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastMinute = static_cast<int>(intValue);
+            if (ignoreOutsidePollGroup(pg_datetime, grouped)) break;
+            if (value.hasNumber && value.Decimals == 0) {
+                lastMinute = static_cast<int>(value.Fixed);
                 // ESP_LOGD("CALC", "Updated MINUTE: %d", lastMinute);
-                publishTime();
+                if (!grouped) publishTime();
             }
             break;
         }
         
         case HASH_SEKUNDE: {
-            char* endPtr;
-            long intValue = strtol(value.c_str(), &endPtr, 10);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastSekunde = static_cast<int>(intValue);
+            if (ignoreOutsidePollGroup(pg_datetime, grouped)) break;
+            if (value.hasNumber && value.Decimals == 0) {
+                lastSekunde = static_cast<int>(value.Fixed);
                 // ESP_LOGD("CALC", "Updated SEKUNDE: %d", lastSekunde);
             }
             break;
         }
         
         case HASH_SOMMERBETRIEB:
-            publishBetriebsart(value);
+            publishBetriebsart(value.hasNumber && value.Fixed == 1);
             break;
         
         case HASH_WPVORLAUFIST: {
-            char* endPtr;
-            float floatValue = strtof(value.c_str(), &endPtr);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastWpVorlaufIst = floatValue;
+            if (ignoreOutsidePollGroup(pg_delta_t, grouped)) break;
+            if (value.hasNumber) {
+                lastWpVorlaufIst = ElsterValueToFloat(value);
                 // Delta T will be calculated and published by scheduler
             } else {
-                ESP_LOGW("CALC", "Failed to parse WPVORLAUFIST value: %s", value.c_str());
+                ESP_LOGW("CALC", "No numeric WPVORLAUFIST value: %s", ElsterValueText(value));
             }
             break;
         }
         
         case HASH_RUECKLAUFISTTEMP: {
-            char* endPtr;
-            float floatValue = strtof(value.c_str(), &endPtr);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastRuecklaufIstTemp = floatValue;
+            if (ignoreOutsidePollGroup(pg_delta_t, grouped)) break;
+            if (value.hasNumber) {
+                lastRuecklaufIstTemp = ElsterValueToFloat(value);
                 // Delta T will be calculated and published by scheduler
             } else {
-                ESP_LOGW("CALC", "Failed to parse RUECKLAUFISTTEMP value: %s", value.c_str());
+                ESP_LOGW("CALC", "No numeric RUECKLAUFISTTEMP value: %s", ElsterValueText(value));
             }
             break;
         }
         
         case HASH_VERDICHTER: {
-            char* endPtr;
-            float floatValue = strtof(value.c_str(), &endPtr);
-            if (endPtr != value.c_str() && *endPtr == '\0') {
-                lastVerdichterValue = floatValue;
+            if (value.hasNumber) {
+                lastVerdichterValue = ElsterValueToFloat(value);
                 // Compressor state will be calculated and published by scheduler
             } else {
-                ESP_LOGW("CALC", "Failed to parse VERDICHTER value: %s", value.c_str());
+                ESP_LOGW("CALC", "No numeric VERDICHTER value: %s", ElsterValueText(value));
             }
             break;
         }
         
-        case HASH_EL_AUFNAHMELEISTUNG_HEIZ:
-        case HASH_EL_AUFNAHMELEISTUNG_WW:
-        case HASH_WAERMEERTRAG_2WE_WW:
-        case HASH_WAERMEERTRAG_2WE_HEIZ:
-        case HASH_WAERMEERTRAG_WW:
-        case HASH_WAERMEERTRAG_HEIZ:
-            storeCOPEnergyValue(signalName, value);
-            updateCOPCalculations();
-            break;
+        case HASH_EL_AUFNAHMELEISTUNG_HEIZ: updateCOPEnergy(ce_el_heiz, value, grouped); break;
+        case HASH_EL_AUFNAHMELEISTUNG_WW:   updateCOPEnergy(ce_el_ww, value, grouped); break;
+        case HASH_WAERMEERTRAG_HEIZ:        updateCOPEnergy(ce_waerme_heiz, value, grouped); break;
+        case HASH_WAERMEERTRAG_WW:          updateCOPEnergy(ce_waerme_ww, value, grouped); break;
+        case HASH_WAERMEERTRAG_2WE_HEIZ:    updateCOPEnergy(ce_waerme_2we_heiz, value, grouped); break;
+        case HASH_WAERMEERTRAG_2WE_WW:      updateCOPEnergy(ce_waerme_2we_ww, value, grouped); break;
         
         default:
             // Signal not monitored for calculated sensors - no action needed
@@ -1643,6 +2050,27 @@ unsigned long getRandomInRange(unsigned long min, unsigned long max) {
     return min + (esp_random() % range);
 }
 
+// Lost arbitrations since the TWAI driver started (0 without TWAI driver)
+uint32_t canArbLostCount() {
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) != ESP_OK) return 0;
+    return status.arb_lost_count;
+}
+
+// Measured bus utilisation and current request budget (see BusLoadLimiter)
+void publishBusLoad() {
+    publishCalculatedSensorDiscovery(calculatedSensors[10]);
+    publishCalculatedSensorDiscovery(calculatedSensors[11]);
+
+    char buf[16];
+
+    snprintf(buf, sizeof(buf), "%u", (unsigned)busLoad.loadPercent());
+    id(mqtt_client).publish("heatingpump/calculated/can_bus_load/state", buf, strlen(buf), 0, true);
+
+    snprintf(buf, sizeof(buf), "%u", (unsigned)requestPacer.framesPerSecond());
+    id(mqtt_client).publish("heatingpump/calculated/request_budget/state", buf, strlen(buf), 0, true);
+}
+
 void publishCanDiagnostics() {
     twai_status_info_t status;
     if (twai_get_status_info(&status) != ESP_OK) return;
@@ -1689,6 +2117,166 @@ void publishCanDiagnostics() {
                             stateStr, strlen(stateStr), 0, true);
 }
 
+// Request interval of a slot: members that do not answer a cm_other signal
+// are only re-probed every RESPONDER_REPROBE_INTERVAL, quarantined slots back
+// off up to QUARANTINE_MAX_INTERVAL
+uint32_t slotIntervalMs(const RequestSlot &slot)
+{
+    const uint32_t reprobeMs = RESPONDER_REPROBE_INTERVAL * 1000UL;
+    if (slot.background)
+        return slot.intervalMs < reprobeMs ? reprobeMs : slot.intervalMs;
+    return slot.health.interval(slot.intervalMs, QUARANTINE_MAX_INTERVAL * 1000UL);
+}
+
+// Publish the achieved vs. configured request period of every schedule slot
+// (seconds) as one retained JSON document to heatingpump/request_periods/state,
+// keyed by MEMBER/SIGNAL, and the worst achieved/configured ratio in percent as
+// diagnostic sensor. One message instead of one per slot spares the broker a
+// burst every CALC_REQUEST_PERIOD_FREQUENCY.
+static char requestPeriodsPayload[REQUEST_PERIODS_PAYLOAD_SIZE];
+
+void publishRequestPeriods() {
+    publishCalculatedSensorDiscovery(calculatedSensors[12]);
+
+    const size_t listEnd = sizeof(requestPeriodsPayload) - 48;   // room for the closing count and flag
+    JsonWriter json(requestPeriodsPayload, sizeof(requestPeriodsPayload));
+    json.beginObject();
+    json.beginObject("periods");
+    char key[64];
+    unsigned long count = 0;
+    bool truncated = false;
+    uint32_t worstPercent = 0;
+    for (const RequestSlot& slot : requestSlots) {
+        if (slot.achievedMs == 0 || slot.intervalMs == 0 || slot.background) continue;
+        uint32_t percent = slot.achievedMs * 100 / slot.intervalMs;
+        if (percent > worstPercent) worstPercent = percent;
+        count++;
+        if (truncated) continue;
+
+        snprintf(key, sizeof(key), "%s/%s", slot.member->Name, slot.ei->Name);
+        const JsonWriter::Mark mark = json.mark();
+        json.beginObject(key);
+        json.field("configured", slot.intervalMs / 1000.0f);
+        json.field("achieved", slot.achievedMs / 1000.0f);
+        json.endObject();
+        if (json.truncated() || json.size() > listEnd) {
+            json.rewind(mark);
+            truncated = true;
+        }
+    }
+    json.endObject();
+    json.field("count", count);
+    json.field("truncated", truncated);
+    json.endObject();
+    if (json.ok())
+        id(mqtt_client).publish("heatingpump/request_periods/state", json.c_str(), json.size(), 0, true);
+
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)worstPercent);
+    id(mqtt_client).publish("heatingpump/calculated/request_period_ratio/state", buf, strlen(buf), 0, true);
+}
+
+// Publish the response statistics of every member that was asked at least
+// once as retained JSON to heatingpump/{MEMBER}/rtt/state: p50 and p95 round
+// trip time in ms, answered requests, retries and timeouts; and the timeouts
+// of all members as diagnostic sensor.
+void publishRequestResponses() {
+    publishCalculatedSensorDiscovery(calculatedSensors[13]);
+
+    char topic[64];
+    char buf[128];
+    unsigned long totalTimeouts = 0;
+    for (const CanMember& cm : CanMembers) {
+        const MemberRequestStats& stats = memberRequestStats[cm.Member];
+        totalTimeouts += stats.timeouts;
+        if (stats.rtt.samples() == 0 && stats.timeouts == 0) continue;
+        snprintf(topic, sizeof(topic), "heatingpump/%s/rtt/state", cm.Name);
+        snprintf(buf, sizeof(buf), "{\"p50\":%lu,\"p95\":%lu,\"responses\":%lu,\"retries\":%lu,\"timeouts\":%lu}",
+                 (unsigned long)stats.rtt.percentile(50), (unsigned long)stats.rtt.percentile(95),
+                 (unsigned long)stats.rtt.samples(), (unsigned long)stats.retries, (unsigned long)stats.timeouts);
+        id(mqtt_client).publish(topic, buf, strlen(buf), 0, true);
+    }
+
+    snprintf(buf, sizeof(buf), "%lu", totalTimeouts);
+    id(mqtt_client).publish("heatingpump/calculated/request_timeouts/state", buf, strlen(buf), 0, true);
+}
+
+// Publish the quarantined schedule slots as retained JSON to
+// heatingpump/quarantine/state: member, signal, consecutive misses and the
+// backed-off interval in seconds. The list stops at the first slot that does
+// not fit and is flagged truncated; the count covers all of them and is also
+// published as diagnostic sensor.
+void publishRequestQuarantine() {
+    publishCalculatedSensorDiscovery(calculatedSensors[14]);
+
+    char buf[768];
+    const size_t listEnd = sizeof(buf) - 48;   // room for the closing count and flag
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.beginArray("signals");
+    unsigned long count = 0;
+    bool truncated = false;
+    for (const RequestSlot& slot : requestSlots) {
+        if (!slot.health.quarantined()) continue;
+        count++;
+        if (truncated) continue;
+        const JsonWriter::Mark mark = json.mark();
+        json.beginObject();
+        json.field("member", slot.member->Name);
+        json.field("signal", slot.ei->Name);
+        json.field("misses", (unsigned long)slot.health.misses);
+        json.field("interval", (unsigned long)(slotIntervalMs(slot) / 1000));
+        json.endObject();
+        if (json.truncated() || json.size() > listEnd) {
+            json.rewind(mark);
+            truncated = true;
+        }
+    }
+    json.endArray();
+    json.field("count", count);
+    json.field("truncated", truncated);
+    json.endObject();
+    if (json.ok())
+        id(mqtt_client).publish("heatingpump/quarantine/state", json.c_str(), json.size(), 0, true);
+
+    snprintf(buf, sizeof(buf), "%lu", count);
+    id(mqtt_client).publish("heatingpump/calculated/quarantined_signals/state", buf, strlen(buf), 0, true);
+}
+
+// Publish the time from queueing a write to its confirming readback as
+// retained JSON to heatingpump/command_latency/state: p50 and p95 in ms,
+// confirmed writes and writes without a readback in time; and the p95 as
+// diagnostic sensor.
+void publishCommandLatency() {
+    publishCalculatedSensorDiscovery(calculatedSensors[15]);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "{\"p50\":%lu,\"p95\":%lu,\"confirmed\":%lu,\"unconfirmed\":%lu}",
+             (unsigned long)commandLatency.percentile(50), (unsigned long)commandLatency.percentile(95),
+             (unsigned long)commandLatency.samples(), (unsigned long)unconfirmedCommands);
+    id(mqtt_client).publish("heatingpump/command_latency/state", buf, strlen(buf), 0, true);
+
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)commandLatency.percentile(95));
+    id(mqtt_client).publish("heatingpump/calculated/command_latency/state", buf, strlen(buf), 0, true);
+}
+
+// Publish the counters of the state filter as retained JSON to
+// heatingpump/state_filter/state: states published (heartbeats among them)
+// and values suppressed as unchanged or within their deadband; and all
+// suppressed values as diagnostic sensor.
+void publishStateFilterStats() {
+    publishCalculatedSensorDiscovery(calculatedSensors[16]);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "{\"published\":%lu,\"heartbeats\":%lu,\"unchanged\":%lu,\"deadband\":%lu}",
+             (unsigned long)stateFilter.published(), (unsigned long)stateFilter.heartbeats(),
+             (unsigned long)stateFilter.suppressedUnchanged(), (unsigned long)stateFilter.suppressedDeadband());
+    id(mqtt_client).publish("heatingpump/state_filter/state", buf, strlen(buf), 0, true);
+
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)stateFilter.suppressed());
+    id(mqtt_client).publish("heatingpump/calculated/suppressed_states/state", buf, strlen(buf), 0, true);
+}
+
 // Process calculated sensor updates with frequency-based scheduling
 // This function should be called regularly from the main loop
 void processCalculatedSensors() {
@@ -1720,48 +2308,547 @@ void processCalculatedSensors() {
         unsigned long can_diag_interval = CALC_CAN_DIAG_FREQUENCY * 1000UL;
         nextCanDiagUpdate = now + getRandomInRange(0, can_diag_interval + 1);
 
+        // Request period diagnostics (5min frequency)
+        unsigned long request_period_interval = CALC_REQUEST_PERIOD_FREQUENCY * 1000UL;
+        nextRequestPeriodUpdate = now + getRandomInRange(0, request_period_interval + 1);
+
         initialized = true;
         ESP_LOGI("CALC_SCHED", "Calculated sensor scheduler initialized");
     }
     
     if (!initialized) return; // Wait for request manager to start
     
-    // Check and publish Delta T sensors
-    if (now >= nextDeltaTUpdate) {
-        publishDeltaTContinuous();
-        publishDeltaTRunning();
+    // Check and publish Delta T sensors; a polled poll group publishes them
+    // itself with each complete round
+    if (deadlineReached(now, nextDeltaTUpdate)) {
+        if (pollGroups[pg_delta_t].size == 0) {
+            publishDeltaTContinuous();
+            publishDeltaTRunning();
+        }
         nextDeltaTUpdate = now + (CALC_DELTA_T_FREQUENCY * 1000UL) + getRandomInRange(0, 1000);
     }
     
     // Check and publish Compressor sensor
-    if (now >= nextCompressorUpdate) {
+    if (deadlineReached(now, nextCompressorUpdate)) {
         publishCompressorActive();
         nextCompressorUpdate = now + (CALC_COMPRESSOR_FREQUENCY * 1000UL) + getRandomInRange(0, 1000);
     }
     
-    // Check and publish Date/Time sensors
-    if (now >= nextDateTimeUpdate) {
-        publishDate();
-        publishTime();
+    // Check and publish Date/Time sensors, unless their poll group does
+    if (deadlineReached(now, nextDateTimeUpdate)) {
+        if (pollGroups[pg_datetime].size == 0) {
+            publishDate();
+            publishTime();
+        }
         nextDateTimeUpdate = now + (CALC_DATETIME_FREQUENCY * 1000UL) + getRandomInRange(0, 1000);
     }
     
     // Check and publish Betriebsart sensor (only if SOMMERBETRIEB value is available)
-    if (now >= nextBetriebsartUpdate) {
+    if (deadlineReached(now, nextBetriebsartUpdate)) {
         // Betriebsart requires a value parameter, so we skip auto-publishing
         // It will be published when SOMMERBETRIEB signal is received
         nextBetriebsartUpdate = now + (CALC_BETRIEBSART_FREQUENCY * 1000UL) + getRandomInRange(0, 1000);
     }
 
     // Check and publish CAN diagnostic sensors
-    if (now >= nextCanDiagUpdate) {
+    if (deadlineReached(now, nextCanDiagUpdate)) {
         publishCanDiagnostics();
+        publishBusLoad();
         nextCanDiagUpdate = now + (CALC_CAN_DIAG_FREQUENCY * 1000UL) + getRandomInRange(0, 1000);
     }
+
+    // Check and publish request period, response and state filter diagnostics
+    if (deadlineReached(now, nextRequestPeriodUpdate)) {
+        publishRequestPeriods();
+        publishRequestResponses();
+        publishRequestQuarantine();
+        publishCommandLatency();
+        publishStateFilterStats();
+        nextRequestPeriodUpdate = now + (CALC_REQUEST_PERIOD_FREQUENCY * 1000UL) + getRandomInRange(0, 1000);
+    }
 }
 
-// Timeout tracking removed for simplification
-// Signals that don't respond will simply not update in Home Assistant
+// Lane of a schedule slot: members in the background and quarantined slots
+// are probes, all others polls
+uint8_t slotLane(const RequestSlot &slot)
+{
+    return slot.background || slot.health.quarantined() ? TX_LANE_PROBE : TX_LANE_POLL;
+}
+
+RequestScheduler &laneScheduler(uint8_t lane)
+{
+    return lane == TX_LANE_PROBE ? probeScheduler : requestScheduler;
+}
+
+// Queue slot `pos` for `deadline` in the scheduler of its lane
+void scheduleSlot(uint16_t pos, uint32_t deadline)
+{
+    requestSlots[pos].deadline = deadline;
+    laneScheduler(slotLane(requestSlots[pos])).schedule(pos, deadline);
+}
+
+// Move a queued slot to `deadline`, and to the scheduler of its lane if that
+// changed. A slot that is not queued right now is left alone.
+void rescheduleSlot(uint16_t pos, uint32_t deadline)
+{
+    if (!requestScheduler.remove(pos) && !probeScheduler.remove(pos))
+        return;
+    scheduleSlot(pos, deadline);
+}
+
+static ESPPreferenceObject responderMapPref;
+// NVS key of responderMap; change it when the layout of ResponderMap changes
+static const uint32_t RESPONDER_MAP_NVS_KEY = 0x5E5D0001;
+
+// Called from on_boot lambda in common.yaml
+void loadResponderMap()
+{
+    responderMapPref = global_preferences->make_preference<ResponderMap<RESPONDER_MAP_SIZE>>(RESPONDER_MAP_NVS_KEY, true);
+    if (!responderMapPref.load(&responderMap) || !responderMap.valid())
+        responderMap.clear();
+    ESP_LOGI("NVS", "Responder map loaded, %u signals", (unsigned)responderMap.count);
+}
+
+void saveResponderMap()
+{
+    responderMapPref.save(&responderMap);
+}
+
+// Once every slot of a cm_other row was asked more than RESPONDER_LEARN_PROBES
+// times, keep polling the members that answered and move the others to the
+// background. If none answered, start over; after RESPONDER_LEARN_ROUNDS such
+// rounds the whole row goes to the background.
+void learnResponders(uint16_t first)
+{
+    RequestSlot *group = &requestSlots[first];
+    uint32_t responders = 0;
+    for (uint8_t i = 0; i < group[0].groupSize; i++) {
+        if (group[i].probes <= RESPONDER_LEARN_PROBES) return;
+        if (group[i].answers > 0) responders |= 1u << group[i].member->Member;
+    }
+
+    for (uint8_t i = 0; i < group[0].groupSize; i++) {
+        group[i].probes = 0;
+        group[i].answers = 0;
+    }
+    if (responders == 0 && ++group[0].learnRounds < RESPONDER_LEARN_ROUNDS) return;
+
+    for (uint8_t i = 0; i < group[0].groupSize; i++) {
+        group[i].learning = false;
+        group[i].background = !(responders & (1u << group[i].member->Member));
+        if (group[i].background) group[i].health = {};   // re-probed, not backed off
+    }
+    if (responders == 0) {
+        ESP_LOGI("REQUEST_MGR", "%s: no member answers, re-probed in the background", group[0].ei->Name);
+        responders = responderMap.NO_RESPONDER;
+    } else {
+        ESP_LOGI("REQUEST_MGR", "%s: learned responders 0x%02x", group[0].ei->Name, (unsigned)responders);
+    }
+    if (responderMap.set(group[0].ei->Index, responders))
+        saveResponderMap();
+}
+
+// A schedule slot got a valid value back. While learning it counts as an
+// answer; a background member that answers again returns to its interval.
+void noteResponderAnswer(uint16_t pos)
+{
+    if (pos >= requestSlots.size()) return;
+    RequestSlot &slot = requestSlots[pos];
+    if (slot.groupSize < 2) return;
+
+    if (slot.learning) {
+        if (slot.answers < UINT8_MAX) slot.answers++;
+        return;
+    }
+    if (!slot.background) return;
+
+    slot.background = false;
+    ESP_LOGI("REQUEST_MGR", "%s: %s answers again", slot.ei->Name, slot.member->Name);
+    const uint32_t responders = responderMap.get(slot.ei->Index) & ~responderMap.NO_RESPONDER;
+    if (responderMap.set(slot.ei->Index, responders | (1u << slot.member->Member)))
+        saveResponderMap();
+}
+
+// True for the answers that carry no value: 0x8000, or a number decoding to
+// -255 as probe signals a member does not support report it
+bool isNoValue(const ElsterValue &value)
+{
+    if (value.Raw == 0x8000) return true;
+    return value.hasNumber && fabsf(ElsterValueToFloat(value) - INVALID_VALUE_NEG_255) < INVALID_VALUE_EPSILON;
+}
+
+// A request of schedule slot `pos` got a value back at `now` (`valid` false
+// for isNoValue()) or stayed unanswered after all retries. A slot backs off while
+// it misses, also while its cm_other row is still learning; members in the
+// background are left to the re-probe. A slot back from the background or the
+// quarantine is due one interval after its answer.
+void noteSlotResult(uint16_t pos, bool valid, uint32_t now)
+{
+    if (pos >= requestSlots.size()) return;
+    RequestSlot &slot = requestSlots[pos];
+
+    bool restored = false;
+    if (valid) {
+        restored = slot.background;
+        noteResponderAnswer(pos);
+    }
+    if (slot.background) return;
+    // A poll group backs off as a whole, with its first signal
+    if (slot.pollGroup != pg_none && pos != pollGroups[slot.pollGroup].first) return;
+
+    if (!valid) {
+        if (slot.health.miss(QUARANTINE_MISSES, slot.intervalMs, QUARANTINE_MAX_INTERVAL * 1000UL)) {
+            ESP_LOGI("REQUEST_MGR", "%s/%s: no value in %u requests, backing off",
+                     slot.member->Name, slot.ei->Name, (unsigned)slot.health.misses);
+            rescheduleSlot(pos, slot.deadline);   // now a probe
+        }
+        return;
+    }
+
+    if (slot.health.answer()) {
+        ESP_LOGI("REQUEST_MGR", "%s/%s: answers again, leaving quarantine", slot.member->Name, slot.ei->Name);
+        restored = true;
+    }
+    const uint32_t deadline = now + slot.intervalMs;
+    if (restored)
+        rescheduleSlot(pos, deadlineBefore(deadline, slot.deadline) ? deadline : slot.deadline);
+}
+
+// Hand the values of a poll group round to updateSensor() together, then
+// update the calculated sensors fed by the group. A round where a signal
+// stayed unanswered publishes the values it has, but leaves the inputs of the
+// calculated sensors at the last complete round.
+void flushPollGroup(PollGroupId id)
+{
+    PollGroup &group = pollGroups[id];
+    const bool complete = group.received == (1u << group.size) - 1;
+    for (uint8_t k = 0; k < group.size; k++) {
+        if (!(group.received & (1u << k))) continue;
+        const RequestSlot &slot = requestSlots[group.first + k];
+        if (complete)
+            updateSensor(*slot.member, slot.ei, group.values[k], true);
+        else
+            publishSignalValue(*slot.member, slot.ei, group.values[k]);
+    }
+    group.pending = 0;
+    group.received = 0;
+    if (!complete) {
+        ESP_LOGD("REQUEST_MGR", "Poll group of %s incomplete, calculated sensors not updated",
+                 requestSlots[group.first].ei->Name);
+        return;
+    }
+
+    switch (id) {
+        case pg_datetime:
+            publishDate();
+            publishTime();
+            break;
+        case pg_cop:
+            updateCOPCalculations();
+            break;
+        case pg_delta_t:
+            publishDeltaTContinuous();
+            publishDeltaTRunning();
+            break;
+        default:
+            break;
+    }
+}
+
+// The first slot of poll group `id` was sent: queue the others right behind
+// it and await all of them. What a previous round still awaits is given up.
+void startPollGroupRound(PollGroupId id)
+{
+    PollGroup &group = pollGroups[id];
+    if (group.pending)
+        flushPollGroup(id);
+    group.pending = static_cast<uint8_t>((1u << group.size) - 1);
+    for (uint8_t k = 1; k < group.size; k++) {
+        const uint16_t pos = group.first + k;
+        if (std::find(pollGroupBurst.begin(), pollGroupBurst.end(), pos) == pollGroupBurst.end())
+            pollGroupBurst.push_back(pos);
+    }
+}
+
+// The request of slot `pos` got `value` back, or stayed unanswered (nullptr).
+// Returns true if a poll group round awaited it; the value is then published
+// with the rest of the round.
+bool notePollGroupValue(uint16_t pos, const ElsterValue *value)
+{
+    if (pos >= requestSlots.size() || requestSlots[pos].pollGroup == pg_none) return false;
+    const PollGroupId id = requestSlots[pos].pollGroup;
+    PollGroup &group = pollGroups[id];
+    const uint8_t bit = static_cast<uint8_t>(1u << (pos - group.first));
+    if (!(group.pending & bit)) return false;
+
+    group.pending &= ~bit;
+    if (value) {
+        group.values[pos - group.first] = *value;
+        group.received |= bit;
+    }
+    if (group.pending == 0)
+        flushPollGroup(id);
+    return true;
+}
+
+// Start the budgets of the request manager and its lanes at `now` and forget
+// the requests in flight. Queued writes and reads are kept.
+void configureTxLanes(uint32_t now)
+{
+    static const uint16_t laneBudgets[TX_LANE_COUNT] = {
+        TX_LANE_COMMAND_FRAMES_PER_SEC, TX_LANE_CONFIRM_FRAMES_PER_SEC,
+        TX_LANE_POLL_FRAMES_PER_SEC, TX_LANE_PROBE_FRAMES_PER_SEC,
+    };
+
+    requestPacer.configure(REQUEST_BUDGET_FRAMES_PER_SEC, REQUEST_MIN_GAP_MS, now);
+    for (uint8_t lane = 0; lane < TX_LANE_COUNT; lane++)
+        lanePacers[lane].configure(laneBudgets[lane], 0, now);
+    outstandingRequests.reset(REQUEST_TRACKER_SIZE);
+    pendingConfirms.reset(TX_QUEUE_SIZE);
+    requestRetries.clear();
+    requestRetries.reserve(REQUEST_TRACKER_SIZE);
+}
+
+// Resolve a signal request table into requestSlots: names are looked up once,
+// unknown and blacklisted signals get no slot. First deadlines are spread over
+// one interval with random offsets to prevent a burst.
+void buildRequestSlots(const SignalRequest *requests, size_t count, uint32_t now)
+{
+    static const CanMemberType allMembers[] = {cm_kessel, cm_manager, cm_heizmodul};
+
+    requestSlots.clear();
+    requestSlots.reserve(count * 3);
+    requestScheduler.reset(count * 3);
+    probeScheduler.reset(count * 3);
+    for (PollGroup& group : pollGroups)
+        group = PollGroup();
+    pollGroupBurst.clear();
+    pollGroupBurst.reserve(POLL_GROUP_MAX_SIGNALS * pg_count);
+    configureTxLanes(now);
+    for (size_t i = 0; i < count; i++) {
+        const SignalRequest& req = requests[i];
+        const ElsterIndex* ei = GetElsterIndex(req.signalName);
+        if (ei->Index == 0xFFFF || ei->isBlacklisted) continue;
+
+        const uint32_t intervalMs = req.frequency * 1000UL;
+        const CanMemberType *members = req.member == cm_other ? allMembers : &req.member;
+        const size_t memberCount = req.member == cm_other ? 3 : 1;
+        const uint32_t responders = memberCount > 1 ? responderMap.get(ei->Index) : 0;
+
+        // A poll group row joins its group if it follows the group's last slot
+        // and addresses the same member; otherwise it is polled on its own
+        PollGroup *group = nullptr;
+        if (req.pollGroup > pg_none && req.pollGroup < pg_count && memberCount == 1) {
+            group = &pollGroups[req.pollGroup];
+            if (group->size > 0 && (group->first + group->size != requestSlots.size()
+                                    || group->size >= POLL_GROUP_MAX_SIGNALS
+                                    || requestSlots[group->first].member != &CanMembers[req.member])) {
+                ESP_LOGW("REQUEST_MGR", "%s: not next to the rest of its poll group, polled on its own", ei->Name);
+                group = nullptr;
+            }
+        }
+        if (group && group->size > 0) {
+            RequestSlot slot = {};
+            slot.ei = ei;
+            slot.member = &CanMembers[req.member];
+            slot.intervalMs = requestSlots[group->first].intervalMs;
+            slot.request = static_cast<uint16_t>(i);
+            slot.groupSize = 1;
+            slot.pollGroup = req.pollGroup;
+            requestSlots.push_back(slot);   // sent by the group's first slot, not scheduled
+            group->size++;
+            continue;
+        }
+        if (group) {
+            group->first = static_cast<uint16_t>(requestSlots.size());
+            group->size = 1;
+        }
+
+        for (size_t m = 0; m < memberCount; m++) {
+            RequestSlot slot = {};
+            slot.ei = ei;
+            slot.member = &CanMembers[members[m]];
+            slot.intervalMs = intervalMs;
+            slot.request = static_cast<uint16_t>(i);
+            slot.groupSize = static_cast<uint8_t>(memberCount);
+            slot.groupPos = static_cast<uint8_t>(m);
+            slot.learning = memberCount > 1 && responders == 0;
+            slot.background = responders != 0 && !(responders & (1u << members[m]));   // all for NO_RESPONDER
+            slot.pollGroup = group ? req.pollGroup : pg_none;
+
+            // Random offset between 0 and full interval using ESP32 hardware RNG
+            uint32_t randomOffset = getRandomInRange(0, slotIntervalMs(slot) + 1);
+            requestSlots.push_back(slot);
+            scheduleSlot(static_cast<uint16_t>(requestSlots.size() - 1), now + randomOffset);
+        }
+    }
+}
+
+// Take the requests that stayed unanswered for REQUEST_TIMEOUT_MS out of the
+// outstanding table: queue a retry while attempts are left, count a timeout
+// for the member and a miss for its slot otherwise. Count the writes whose
+// readback did not arrive within COMMAND_CONFIRM_TIMEOUT_MS.
+void expireOutstandingRequests(uint32_t now)
+{
+    OutstandingRequest req;
+    while (outstandingRequests.takeExpired(now, REQUEST_TIMEOUT_MS, req)) {
+        if (req.attempts <= REQUEST_MAX_RETRIES && requestRetries.size() < REQUEST_TRACKER_SIZE) {
+            requestRetries.push_back(req);
+        } else {
+            memberRequestStats[req.member].timeouts++;
+            ESP_LOGD("REQUEST_MGR", "No response from %s for 0x%04x after %u attempts",
+                     CanMembers[req.member].Name, req.index, (unsigned)req.attempts);
+            if (req.slot != OutstandingRequest::NO_SLOT) {
+                noteSlotResult(req.slot, false, now);
+                notePollGroupValue(req.slot, nullptr);
+            }
+        }
+    }
+
+    while (pendingConfirms.takeExpired(now, COMMAND_CONFIRM_TIMEOUT_MS, req)) {
+        unconfirmedCommands++;
+        ESP_LOGW("REQUEST_MGR", "Write of 0x%04x to %s not confirmed within %u ms",
+                 req.index, CanMembers[req.member].Name, (unsigned)COMMAND_CONFIRM_TIMEOUT_MS);
+    }
+}
+
+// Request schedule slot `pos` at `now` and queue its next deadline
+void sendSlot(uint16_t pos, uint32_t now)
+{
+    RequestSlot& slot = requestSlots[pos];
+    readSignal(slot.member, slot.ei, 1, pos, slotLane(slot));
+
+    if (slot.learning) {
+        if (slot.probes < UINT8_MAX) slot.probes++;
+        learnResponders(pos - slot.groupPos);
+    }
+
+    // Achieved refresh period, smoothed over the last few requests
+    if (slot.sent) {
+        uint32_t period = now - slot.lastSentMs;
+        slot.achievedMs = slot.achievedMs > 0 ? (3 * slot.achievedMs + period) / 4 : period;
+    }
+    slot.sent = true;
+    slot.lastSentMs = now;
+
+    // The first slot of a poll group starts a round and schedules the group;
+    // the others are sent by it
+    if (slot.pollGroup != pg_none) {
+        if (pos != pollGroups[slot.pollGroup].first) return;
+        startPollGroupRound(slot.pollGroup);
+    }
+
+    // Calculate next scheduled time with random offset (0 to 5% of interval)
+    // This keeps signals from synchronizing while staying close to target frequency
+    const uint32_t intervalMs = slotIntervalMs(slot);
+    uint32_t maxJitter = intervalMs / 20; // 5% of interval
+    if (maxJitter < 500) maxJitter = 500; // Minimum 500ms jitter
+    scheduleSlot(pos, now + intervalMs + getRandomInRange(0, maxJitter + 1));
+}
+
+// Send the next frame of `lane`: the retry queued last, else the next signal
+// of a running poll group round, else the oldest queued write or read, else
+// the earliest due slot. Returns false if the
+// lane has nothing to send.
+bool sendFromLane(uint8_t lane, uint32_t now)
+{
+    for (size_t i = requestRetries.size(); i-- > 0;) {
+        if (requestRetries[i].lane != lane) continue;
+        const OutstandingRequest req = requestRetries[i];
+        requestRetries.erase(requestRetries.begin() + i);
+        readSignal(&CanMembers[req.member], GetElsterIndex(req.index), req.attempts + 1, req.slot, lane);
+        memberRequestStats[req.member].retries++;
+        return true;
+    }
+
+    if (lane == TX_LANE_POLL && !pollGroupBurst.empty()) {
+        const uint16_t pos = pollGroupBurst.front();
+        pollGroupBurst.erase(pollGroupBurst.begin());
+        sendSlot(pos, now);
+        return true;
+    }
+
+    auto& queue = txQueues[lane];
+    if (!queue.empty()) {
+        const TxRequest req = queue.front();
+        queue.pop();
+        const CanMember *cm = &CanMembers[req.member];
+        if (req.write)
+            writeSignalValue(cm, GetElsterIndex(req.index), req.value);
+        else
+            readSignal(cm, GetElsterIndex(req.index), 1, OutstandingRequest::NO_SLOT, lane);
+        return true;
+    }
+
+    if (lane != TX_LANE_POLL && lane != TX_LANE_PROBE) return false;
+    RequestScheduler& scheduler = laneScheduler(lane);
+    if (!scheduler.due(now)) return false;
+    sendSlot(scheduler.pop(), now);
+    return true;
+}
+
+// Transmit scheduler: while the request budget and the inter-frame gap allow,
+// send one frame from the first lane that has one and budget left, in the
+// order commands, confirms, polls, probes. Only due slots are touched.
+// Returns the number of frames sent.
+int runRequestSlots(uint32_t now)
+{
+    int requestsSent = 0;
+    while (requestPacer.ready(now)) {
+        bool sent = false;
+        for (uint8_t lane = 0; lane < TX_LANE_COUNT && !sent; lane++) {
+            if (lanePacers[lane].ready(now) && sendFromLane(lane, now)) {
+                lanePacers[lane].sent(now);
+                sent = true;
+            }
+        }
+        if (!sent) break;
+        requestPacer.sent(now);
+        requestsSent++;
+    }
+    return requestsSent;
+}
+
+// Publish the outcome of a command transaction as retained JSON to
+// heatingpump/command_sequence/state: its name, whether all writes were
+// confirmed, how many were, and how long it ran in ms.
+void publishSequenceResult(const SequenceResult &result) {
+    char buf[160];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.field("name", result.name);
+    json.field("ok", result.ok);
+    json.field("confirmed", (unsigned long)result.confirmed);
+    json.field("steps", (unsigned long)result.count);
+    json.field("duration", (unsigned long)result.durationMs);
+    json.endObject();
+    if (!json.ok()) {
+        ESP_LOGW("SEQUENCE", "Result of %s does not fit in %u bytes", result.name, (unsigned)sizeof(buf));
+        return;
+    }
+    id(mqtt_client).publish("heatingpump/command_sequence/state", json.c_str(), json.size(), 0, true);
+}
+
+// Queue the next write of the running command transaction, if it is due, and
+// report finished transactions. Never waits: a write awaiting its readback
+// simply stays pending until processAndUpdate() confirms it or it times out.
+void runCommandSequencer(uint32_t now)
+{
+    SequenceStep step;
+    while (commandSequencer.nextWrite(now, step))
+        queueCommandValue(&CanMembers[step.member], GetElsterIndex(step.index), step.value);
+
+    SequenceResult result;
+    while (commandSequencer.takeResult(result)) {
+        if (result.ok)
+            ESP_LOGI("SEQUENCE", "%s: %u writes confirmed in %lu ms", result.name, (unsigned)result.count,
+                     (unsigned long)result.durationMs);
+        else
+            ESP_LOGW("SEQUENCE", "%s failed: %u of %u writes confirmed", result.name, (unsigned)result.confirmed,
+                     (unsigned)result.count);
+        publishSequenceResult(result);
+    }
+}
 
 // Process signal request table with frequency-based scheduling
 void processSignalRequests() {
@@ -1771,12 +2858,21 @@ void processSignalRequests() {
     if (!requestManagerStarted) {
         if (requestManagerStartTime == 0) {
             requestManagerStartTime = now;
+            busLoad.configure({CAN_BIT_RATE, BUS_LOAD_WINDOW_MS, BUS_LOAD_HIGH_PERCENT, BUS_LOAD_LOW_PERCENT,
+                               BUS_LOAD_ARB_LOST_LIMIT, REQUEST_BUDGET_MIN_FRAMES_PER_SEC, REQUEST_BUDGET_MAX_FRAMES_PER_SEC},
+                              REQUEST_BUDGET_FRAMES_PER_SEC, now);
+            configureTxLanes(now);
+            commandSequencer.configure(SEQUENCE_STEP_TIMEOUT_MS, SEQUENCE_STEP_ATTEMPTS);
             ESP_LOGI("REQUEST_MGR", "Starting signal request manager (%ds startup delay)", STARTUP_DELAY_MS / 1000);
             return;
         }
         
         if (now - requestManagerStartTime < STARTUP_DELAY_MS) {
-            return; // Still in startup delay
+            // Still in startup delay: no polls yet, but writes and reads from HA go out
+            expireOutstandingRequests(now);
+            runCommandSequencer(now);
+            runRequestSlots(now);
+            return;
         }
         
         requestManagerStarted = true;
@@ -1784,158 +2880,67 @@ void processSignalRequests() {
                  SIGNAL_REQUEST_COUNT);
         
         // Initialize all signal schedules with random offsets to spread out initial load
-        ESP_LOGI("REQUEST_MGR", "Initializing signal schedules with random offsets to prevent burst");
-        for (int i = 0; i < SIGNAL_REQUEST_COUNT; i++) {
-            const SignalRequest& req = signalRequests[i];
-            const ElsterIndex* ei = GetElsterIndex(req.signalName);
-            if (!ei || ei->Index == 0xFFFF) continue;
-            
-            // Skip blacklisted signals during initialization
-            if (isPermanentlyBlacklisted(ei->Name)) continue;
-            
-            unsigned long intervalMs = req.frequency * 1000UL;
-            
-            if (req.member == cm_other) {
-                // Schedule for all members
-                const CanMember* allMembers[] = {
-                    &CanMembers[cm_kessel],
-                    &CanMembers[cm_manager],
-                    &CanMembers[cm_heizmodul]
-                };
-                for (size_t m = 0; m < 3; m++) {
-                    std::string key = std::string(allMembers[m]->Name) + "_" + ei->Name;
-                    // Random offset between 0 and full interval using ESP32 hardware RNG
-                    unsigned long randomOffset = getRandomInRange(0, intervalMs + 1);
-                    nextRequestTime[key] = now + randomOffset;
-                }
-            } else {
-                // Schedule for specific member
-                const CanMember* member = &CanMembers[req.member];
-                std::string key = std::string(member->Name) + "_" + ei->Name;
-                // Random offset between 0 and full interval using ESP32 hardware RNG
-                unsigned long randomOffset = getRandomInRange(0, intervalMs + 1);
-                nextRequestTime[key] = now + randomOffset;
-            }
-        }
-        ESP_LOGI("REQUEST_MGR", "Initialized %d signal schedules", nextRequestTime.size());
+        buildRequestSlots(signalRequests, SIGNAL_REQUEST_COUNT, now);
+        ESP_LOGI("REQUEST_MGR", "Initialized %d signal schedules", (int) requestSlots.size());
     }
-    
-    // Rate limiting: send up to MAX_REQUESTS_PER_ITERATION requests per iteration
-    // Randomization in scheduling prevents bursts
-    int requestsSentThisIteration = 0;
-    
-    // Round-robin processing: start from last position to prevent starvation of signals at end of array
-    // Process all signals, wrapping around, until we hit rate limit or complete full cycle
-    int processedCount = 0;
-    int currentIndex = signalProcessingStartIndex;
-    
-    while (processedCount < SIGNAL_REQUEST_COUNT && requestsSentThisIteration < MAX_REQUESTS_PER_ITERATION) {
-        const SignalRequest& req = signalRequests[currentIndex];
-        processedCount++;
-        
-        const ElsterIndex* ei = GetElsterIndex(req.signalName);
-        if (!ei || ei->Index == 0xFFFF) {
-            // Move to next signal and continue
-            currentIndex = (currentIndex + 1) % SIGNAL_REQUEST_COUNT;
-            continue; // Signal not found in table
-        }
-        
-        // Skip blacklisted signals - don't request them on CAN bus
-        if (isPermanentlyBlacklisted(ei->Name)) {
-            currentIndex = (currentIndex + 1) % SIGNAL_REQUEST_COUNT;
-            continue; // Signal is blacklisted
-        }
-        
-        unsigned long intervalMs = req.frequency * 1000UL;
-        
-        // Determine which members to request from
-        if (req.member == cm_other) {
-            // Request from all members (each tracked independently)
-            const CanMember* allMembers[] = {
-                &CanMembers[cm_kessel],
-                &CanMembers[cm_manager],
-                &CanMembers[cm_heizmodul]
-            };
-            
-            // Track how many members we've sent to in this cm_other group to stagger them
-            int sentInThisGroup = 0;
-            
-            for (const auto* member : allMembers) {
-                // Don't break - just skip remaining members for this signal
-                // The outer loop will continue with next signal
-                if (requestsSentThisIteration >= MAX_REQUESTS_PER_ITERATION) {
-                    break; // Hit rate limit for this iteration
-                }
-                
-                // Use ei->Name (from ElsterTable) to match blacklist key format
-                std::string key = std::string(member->Name) + "_" + ei->Name;
-                
-                // Get the next scheduled time for this signal
-                unsigned long nextScheduled = nextRequestTime[key];
-                
-                // Check if this signal is overdue (current time >= scheduled time)
-                if (now >= nextScheduled) {
-                    // For cm_other: only send to ONE member per iteration to prevent bursts
-                    // Other members will be checked in subsequent iterations
-                    if (sentInThisGroup == 0) {
-                        readSignal(member, ei);
-                        requestsSentThisIteration++;
-                        sentInThisGroup++;
-                        
-                        // Calculate next scheduled time with random offset (0 to 5% of interval)
-                        // This keeps signals from synchronizing while staying close to target frequency
-                        unsigned long maxJitter = (intervalMs / 20); // 5% of interval
-                        if (maxJitter < 500) maxJitter = 500; // Minimum 500ms jitter
-                        unsigned long randomDelay = getRandomInRange(0, maxJitter + 1);
-                        nextRequestTime[key] = now + intervalMs + randomDelay;
-                        
-                        // ESP_LOGD("REQUEST_MGR", "Sent %s, next in %lums", key.c_str(), intervalMs + randomDelay);
-                    }
-                    // Else: skip this member for now, will be checked next iteration
-                }
-            }
-        } else {
-            // Request from specific member
-            const CanMember* member = &CanMembers[req.member];
-            std::string key = std::string(member->Name) + "_" + ei->Name;
-            
-            // Get the next scheduled time for this signal
-            unsigned long nextScheduled = nextRequestTime[key];
-            
-            // Check if this signal is overdue (current time >= scheduled time)
-            if (now >= nextScheduled) {
-                readSignal(member, ei);
-                requestsSentThisIteration++;
-                
-                // Calculate next scheduled time with random offset (0 to 5% of interval)
-                // This keeps signals from synchronizing while staying close to target frequency
-                unsigned long maxJitter = (intervalMs / 20); // 5% of interval
-                if (maxJitter < 500) maxJitter = 500; // Minimum 500ms jitter
-                unsigned long randomDelay = getRandomInRange(0, maxJitter + 1);
-                nextRequestTime[key] = now + intervalMs + randomDelay;
-                
-                // ESP_LOGD("REQUEST_MGR", "Sent %s, next in %lums", key.c_str(), intervalMs + randomDelay);
-            }
-        }
-        
-        // Move to next signal in round-robin fashion (wrap around at end)
-        currentIndex = (currentIndex + 1) % SIGNAL_REQUEST_COUNT;
+
+    // Adapt the request budget to the bus load once per window
+    if (busLoad.windowElapsed(now) && busLoad.update(now, canArbLostCount())
+        && busLoad.budget() != requestPacer.framesPerSecond()) {
+        ESP_LOGD("REQUEST_MGR", "Bus load %u%%, %u lost arbitrations: budget %u frames/s",
+                 (unsigned)busLoad.loadPercent(), (unsigned)busLoad.arbLost(), (unsigned)busLoad.budget());
+        requestPacer.setFramesPerSecond(busLoad.budget());
     }
+
+    expireOutstandingRequests(now);
+    runCommandSequencer(now);
+    runRequestSlots(now);
 }
 
-void processAndUpdate(uint32_t can_id, std::vector<uint8_t> msg)
+void processAndUpdate(const ElsterFrame &frame)
 {
- 
-    std::string value;
+    busLoad.frameSeen(frame.dlc);
+
+    ElsterValue value;
     const CanMember *cm = nullptr;
-    const ElsterIndex *ei = processCanMessage(msg, can_id, value, &cm);
+    const ElsterIndex *ei = processCanMessage(frame, value, &cm);
+
+    // Frame too short to carry a value
+    if (!cm)
+    {
+        return;
+    }
+
+    // Answer to one of our read requests: record its round-trip time, and the
+    // command latency if it confirms a write
+    OutstandingRequest request;
+    uint16_t slot = OutstandingRequest::NO_SLOT;
+    if (isResponseToPc(frame) && outstandingRequests.complete(cm->Member, ei->Index, request))
+    {
+        slot = request.slot;
+        memberRequestStats[cm->Member].rtt.record(millis() - request.sentMs);
+        if (request.slot != OutstandingRequest::NO_SLOT)
+            noteSlotResult(request.slot, !isNoValue(value), millis());
+        if (request.lane == TX_LANE_CONFIRM && pendingConfirms.complete(cm->Member, ei->Index, request))
+            commandLatency.record(millis() - request.sentMs);
+    }
+
+    // A readback may confirm the awaited write of a command transaction
+    if (isResponseToPc(frame))
+        commandSequencer.onValue(cm->Member, ei->Index, value.Raw, millis());
 
     // Skip permanently blacklisted signals
-    if (isPermanentlyBlacklisted(ei->Name))
+    if (ei->isBlacklisted)
     {
         return; // Reject before lookup, parsing, formatting, logging
     }
 
+    // Poll group signals are published with the rest of their round
+    if (notePollGroupValue(slot, &value))
+    {
+        return;
+    }
+
     updateSensor(*cm, ei, value);
     return;
 }
@@ -1958,12 +2963,12 @@ void updateTime(CanMember cm, const char *str_time)
     const char *cminute = minute;
     const char *csekunde = sekunde;
     ESP_LOGI("WRITE", "Stunde: %s, Minute: %s, Sekunde: %s", cstunde, cminute, csekunde);
-    writeSignal(&cm, "STUNDE", cstunde);
-    readSignal(&cm, "STUNDE");
-    writeSignal(&cm, "MINUTE", cminute);
-    readSignal(&cm, "MINUTE");
-    writeSignal(&cm, "SEKUNDE", csekunde);
-    readSignal(&cm, "SEKUNDE");
+    // The clock keeps running, so any value read back confirms a write
+    CommandTransaction transaction = {"Uhrzeit"};
+    if (addSequenceStep(transaction, &cm, "STUNDE", cstunde, false)
+        && addSequenceStep(transaction, &cm, "MINUTE", cminute, false)
+        && addSequenceStep(transaction, &cm, "SEKUNDE", csekunde, false))
+        submitSequence(transaction);
 }
 
 void updateDate(CanMember cm, const char *str_date)
@@ -1984,12 +2989,11 @@ void updateDate(CanMember cm, const char *str_date)
     const char *cmonth = month;
     const char *cday = day;
     ESP_LOGI("WRITE", "Year: %s, Month: %s, Day: %s", cyear, cmonth, cday);
-    writeSignal(&cm, "JAHR", cyear);
-    readSignal(&cm, "JAHR");
-    writeSignal(&cm, "MONAT", cmonth);
-    readSignal(&cm, "MONAT");
-    writeSignal(&cm, "TAG", cday);
-    readSignal(&cm, "TAG");
+    CommandTransaction transaction = {"Datum"};
+    if (addSequenceStep(transaction, &cm, "JAHR", cyear)
+        && addSequenceStep(transaction, &cm, "MONAT", cmonth)
+        && addSequenceStep(transaction, &cm, "TAG", cday))
+        submitSequence(transaction);
 }
 
 #endif // !defined(HA_DUMMY_BUILD)
@@ -0,0 +1,200 @@
+/*
+ * JsonWriter — streaming JSON into a caller-supplied buffer.
+ *
+ * No ESPHome dependencies, no heap. Builds a JSON document front to back in a
+ * fixed char buffer (static or on the stack) and places the commas itself.
+ * Strings are escaped. A document that does not fit is cut off and flagged:
+ * ok() is false and the buffer holds no valid JSON, so the caller must not
+ * publish it.
+ *
+ *   char buf[256];
+ *   JsonWriter json(buf, sizeof(buf));
+ *   json.beginObject();
+ *   json.field("name", "Außentemperatur");
+ *   json.field("min", 20.5f);
+ *   json.beginArray("options");
+ *   json.value("Automatik");
+ *   json.endArray();
+ *   json.endObject();
+ *   if (json.ok()) publish(json.c_str(), json.size());
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+class JsonWriter {
+public:
+    static constexpr uint8_t MAX_DEPTH = 8;
+
+    // `buf` must hold at least one byte; it always stays NUL-terminated
+    JsonWriter(char* buf, size_t size) : buf_(buf), size_(size) {
+        if (size_ > 0) buf_[0] = '\0';
+        else overflow_ = true;
+    }
+
+    // Objects and arrays: the key is needed inside an object only
+    JsonWriter& beginObject(const char* key = nullptr) { return open(key, '{'); }
+    JsonWriter& endObject() { return close('}'); }
+    JsonWriter& beginArray(const char* key = nullptr) { return open(key, '['); }
+    JsonWriter& endArray() { return close(']'); }
+
+    // "key":"value", escaped
+    JsonWriter& field(const char* key, const char* value) {
+        separate();
+        writeString(key);
+        put(':');
+        writeString(value);
+        return *this;
+    }
+
+    // "key":number, formatted like std::ostream (%g, 6 digits)
+    JsonWriter& field(const char* key, double value) {
+        separate();
+        writeString(key);
+        put(':');
+        writeNumber(value);
+        return *this;
+    }
+    JsonWriter& field(const char* key, float value) { return field(key, static_cast<double>(value)); }
+    JsonWriter& field(const char* key, int value) { return field(key, static_cast<double>(value)); }
+
+    // "key":number, all digits (counters and durations in ms)
+    JsonWriter& field(const char* key, unsigned long value) {
+        separate();
+        writeString(key);
+        put(':');
+        char num[24];
+        snprintf(num, sizeof(num), "%lu", value);
+        write(num);
+        return *this;
+    }
+
+    // "key":true / false
+    JsonWriter& field(const char* key, bool value) {
+        separate();
+        writeString(key);
+        put(':');
+        write(value ? "true" : "false");
+        return *this;
+    }
+
+    // An array element: "value", escaped
+    JsonWriter& value(const char* value) {
+        separate();
+        writeString(value);
+        return *this;
+    }
+
+    // Position to return to with rewind(), e.g. to drop an array element that
+    // did not fit and close the array after the elements before it
+    struct Mark {
+        size_t len;
+        uint8_t depth;
+        bool first;
+        bool overflow;
+        bool misnested;
+    };
+    Mark mark() const { return {len_, depth_, depth_ > 0 && first_[depth_ - 1], overflow_, misnested_}; }
+    void rewind(const Mark& m) {
+        len_ = m.len;
+        if (size_ > 0) buf_[len_] = '\0';
+        depth_ = m.depth;
+        if (depth_ > 0) first_[depth_ - 1] = m.first;
+        overflow_ = m.overflow;
+        misnested_ = m.misnested;
+    }
+
+    // True while everything fit and every object and array was closed in order
+    bool ok() const { return !overflow_ && !misnested_ && depth_ == 0; }
+    bool truncated() const { return overflow_; }
+    const char* c_str() const { return buf_; }
+    size_t size() const { return len_; }
+
+private:
+    JsonWriter& open(const char* key, char bracket) {
+        separate();
+        if (key) {
+            writeString(key);
+            put(':');
+        }
+        put(bracket);
+        if (depth_ >= MAX_DEPTH) {
+            misnested_ = true;
+            return *this;
+        }
+        first_[depth_++] = true;
+        return *this;
+    }
+
+    JsonWriter& close(char bracket) {
+        if (depth_ == 0) misnested_ = true;
+        else depth_--;
+        put(bracket);
+        return *this;
+    }
+
+    // Comma before every member but the first of an object or array
+    void separate() {
+        if (depth_ == 0) return;
+        if (!first_[depth_ - 1]) put(',');
+        first_[depth_ - 1] = false;
+    }
+
+    void writeString(const char* s) {
+        static const char hex[] = "0123456789abcdef";
+        put('"');
+        for (const char* p = s ? s : ""; *p; p++) {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            switch (c) {
+                case '"':  write("\\\""); break;
+                case '\\': write("\\\\"); break;
+                case '\n': write("\\n"); break;
+                case '\r': write("\\r"); break;
+                case '\t': write("\\t"); break;
+                default:
+                    if (c < 0x20) {
+                        write("\\u00");
+                        put(hex[c >> 4]);
+                        put(hex[c & 0x0F]);
+                    } else {
+                        put(static_cast<char>(c));   // UTF-8 passes through
+                    }
+            }
+        }
+        put('"');
+    }
+
+    void writeNumber(double value) {
+        char num[24];
+        snprintf(num, sizeof(num), "%g", value);
+        write(num);
+    }
+
+    void write(const char* s) {
+        while (*s) put(*s++);
+    }
+
+    void put(char c) {
+        if (overflow_) return;
+        if (len_ + 1 >= size_) {
+            overflow_ = true;
+            return;
+        }
+        buf_[len_++] = c;
+        buf_[len_] = '\0';
+    }
+
+    char* buf_;
+    size_t size_;
+    size_t len_ = 0;
+    uint8_t depth_ = 0;
+    bool first_[MAX_DEPTH] = {};
+    bool overflow_ = false;
+    bool misnested_ = false;
+};
+
+#endif // JSON_WRITER_H
@@ -114,6 +114,13 @@
 #define LNAME_CALC_CAN_REC                     "CAN RX Fehlerzähler"
 #define LNAME_CALC_CAN_BUS_ERRORS              "CAN Bus Fehler"
 #define LNAME_CALC_CAN_STATE                   "CAN Bus Zustand"
+#define LNAME_CALC_CAN_BUS_LOAD                "CAN Buslast"
+#define LNAME_CALC_REQUEST_BUDGET              "CAN Abfragebudget"
+#define LNAME_CALC_REQUEST_PERIOD_RATIO        "Abfrageperiode Ist/Soll (max)"
+#define LNAME_CALC_REQUEST_TIMEOUTS            "Abfragen ohne Antwort"
+#define LNAME_CALC_QUARANTINED_SIGNALS         "Abfragen in Quarantäne"
+#define LNAME_CALC_COMMAND_LATENCY             "Schreiblatenz (p95)"
+#define LNAME_CALC_SUPPRESSED_STATES           "Unterdrückte MQTT-Zustände"
 
 // ============================================================================
 // Writable number friendly names (writableNumbers[])
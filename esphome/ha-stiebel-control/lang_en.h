@@ -209,6 +209,20 @@
 #define LNAME_CALC_CAN_BUS_ERRORS              "CAN Bus Errors"
 #undef  LNAME_CALC_CAN_STATE
 #define LNAME_CALC_CAN_STATE                   "CAN Bus State"
+#undef  LNAME_CALC_CAN_BUS_LOAD
+#define LNAME_CALC_CAN_BUS_LOAD                "CAN Bus Load"
+#undef  LNAME_CALC_REQUEST_BUDGET
+#define LNAME_CALC_REQUEST_BUDGET              "CAN Request Budget"
+#undef  LNAME_CALC_REQUEST_PERIOD_RATIO
+#define LNAME_CALC_REQUEST_PERIOD_RATIO        "Poll Period Actual/Target (max)"
+#undef  LNAME_CALC_REQUEST_TIMEOUTS
+#define LNAME_CALC_REQUEST_TIMEOUTS            "Unanswered Requests"
+#undef  LNAME_CALC_QUARANTINED_SIGNALS
+#define LNAME_CALC_QUARANTINED_SIGNALS         "Quarantined Requests"
+#undef  LNAME_CALC_COMMAND_LATENCY
+#define LNAME_CALC_COMMAND_LATENCY             "Write Latency (p95)"
+#undef  LNAME_CALC_SUPPRESSED_STATES
+#define LNAME_CALC_SUPPRESSED_STATES           "Suppressed MQTT States"
 
 // ============================================================================
 // Writable number friendly names
@@ -0,0 +1,604 @@
+/*
+ * RequestScheduler — deadline queue for the signal request schedule.
+ *
+ * No ESPHome dependencies. A binary min-heap of schedule slot numbers keyed
+ * on their next due time in millis(), so a tick only touches the slots that
+ * are due: O(due · log n) instead of a scan over the whole request table.
+ * The heap storage is reserved once; scheduling and popping never allocate.
+ *
+ * RequestPacer spaces the frames of the request manager: a token bucket with
+ * a budget in frames per second plus a minimum gap between two frames.
+ * TxQueue holds commands and one-off reads in their transmit lane.
+ * BusLoadLimiter measures the bus utilisation and adapts that budget.
+ * OutstandingRequests pairs every read request with its response, and
+ * RttHistogram collects the round-trip times per member. ResponderMap holds
+ * the members found to answer a signal that is polled on several of them.
+ * SlotHealth backs off slots that keep getting no valid answer.
+ */
+
+#ifndef REQUEST_SCHEDULER_H
+#define REQUEST_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// WRAPAROUND-SAFE MILLIS() ARITHMETIC
+// ============================================================================
+// millis() wraps after 49.7 days. Differences are taken modulo 2^32 and read
+// as signed, which is correct while the compared times lie less than 2^31 ms
+// (24.8 days) apart — far more than the longest request interval.
+
+// True once `now` has reached `deadline`
+inline bool deadlineReached(uint32_t now, uint32_t deadline) {
+    return static_cast<int32_t>(now - deadline) >= 0;
+}
+
+// True if deadline `a` lies before deadline `b`
+inline bool deadlineBefore(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+// ============================================================================
+// SCHEDULER
+// ============================================================================
+
+class RequestScheduler {
+public:
+    // Drop all entries and reserve room for `capacity` slots
+    void reset(size_t capacity) {
+        heap_.clear();
+        heap_.reserve(capacity);
+    }
+
+    // Queue `slot` to become due at `deadline` (millis())
+    void schedule(uint16_t slot, uint32_t deadline) {
+        heap_.push_back({deadline, slot});
+        siftUp(heap_.size() - 1);
+    }
+
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+
+    // True if the earliest slot is due at `now`
+    bool due(uint32_t now) const {
+        return !heap_.empty() && deadlineReached(now, heap_[0].deadline);
+    }
+
+    // Earliest deadline; only valid if !empty()
+    uint32_t nextDeadline() const { return heap_[0].deadline; }
+
+    // Remove and return the earliest slot; only valid if !empty().
+    // Equal deadlines come out in slot order.
+    uint16_t pop() {
+        const uint16_t slot = heap_[0].slot;
+        heap_[0] = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty())
+            siftDown(0);
+        return slot;
+    }
+
+    // Move the deadline of a queued `slot`. Returns false if it is not queued.
+    bool reschedule(uint16_t slot, uint32_t deadline) {
+        for (size_t i = 0; i < heap_.size(); i++) {
+            if (heap_[i].slot != slot)
+                continue;
+            const bool earlier = deadlineBefore(deadline, heap_[i].deadline);
+            heap_[i].deadline = deadline;
+            if (earlier)
+                siftUp(i);
+            else
+                siftDown(i);
+            return true;
+        }
+        return false;
+    }
+
+    // Take a queued `slot` out. Returns false if it is not queued.
+    bool remove(uint16_t slot) {
+        for (size_t i = 0; i < heap_.size(); i++) {
+            if (heap_[i].slot != slot)
+                continue;
+            const Entry last = heap_.back();
+            heap_.pop_back();
+            if (i < heap_.size()) {
+                const bool earlier = before(last, heap_[i]);
+                heap_[i] = last;
+                if (earlier)
+                    siftUp(i);
+                else
+                    siftDown(i);
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Entry {
+        uint32_t deadline;
+        uint16_t slot;
+    };
+
+    static bool before(const Entry& a, const Entry& b) {
+        if (a.deadline != b.deadline)
+            return deadlineBefore(a.deadline, b.deadline);
+        return a.slot < b.slot;
+    }
+
+    void siftUp(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(heap_[i], heap_[parent]))
+                return;
+            Entry tmp = heap_[i];
+            heap_[i] = heap_[parent];
+            heap_[parent] = tmp;
+            i = parent;
+        }
+    }
+
+    void siftDown(size_t i) {
+        const size_t n = heap_.size();
+        while (2 * i + 1 < n) {
+            size_t child = 2 * i + 1;
+            if (child + 1 < n && before(heap_[child + 1], heap_[child]))
+                child++;
+            if (!before(heap_[child], heap_[i]))
+                return;
+            Entry tmp = heap_[i];
+            heap_[i] = heap_[child];
+            heap_[child] = tmp;
+            i = child;
+        }
+    }
+
+    std::vector<Entry> heap_;
+};
+
+// ============================================================================
+// PACER
+// ============================================================================
+
+class RequestPacer {
+public:
+    // Budget in frames per second, minimum gap between two frames in ms.
+    // The bucket holds at most one second of budget and starts with one frame.
+    void configure(uint16_t framesPerSecond, uint16_t minGapMs, uint32_t now) {
+        framesPerSecond_ = framesPerSecond;
+        minGapMs_ = minGapMs;
+        tokens_ = framesPerSecond > 0 ? TOKEN : 0;
+        lastRefill_ = now;
+        lastSent_ = now - minGapMs;
+    }
+
+    uint16_t framesPerSecond() const { return framesPerSecond_; }
+    uint16_t minGapMs() const { return minGapMs_; }
+
+    // Change the budget; tokens above the new bucket size are dropped
+    void setFramesPerSecond(uint16_t framesPerSecond) {
+        framesPerSecond_ = framesPerSecond;
+        if (tokens_ > framesPerSecond * TOKEN)
+            tokens_ = framesPerSecond * TOKEN;
+    }
+
+    // True if a frame may be sent at `now`
+    bool ready(uint32_t now) {
+        refill(now);
+        return tokens_ >= TOKEN && now - lastSent_ >= minGapMs_;
+    }
+
+    // Account for a frame sent at `now`; call only after ready(now)
+    void sent(uint32_t now) {
+        tokens_ -= TOKEN;
+        lastSent_ = now;
+    }
+
+private:
+    // Tokens are counted in thousandths of a frame: a budget of N frames per
+    // second adds N of them per millisecond.
+    static constexpr uint32_t TOKEN = 1000;
+
+    void refill(uint32_t now) {
+        uint32_t elapsed = now - lastRefill_;
+        if (elapsed == 0)
+            return;
+        lastRefill_ = now;
+        const uint32_t capacity = framesPerSecond_ * TOKEN;
+        tokens_ = elapsed >= 1000 ? capacity : tokens_ + elapsed * framesPerSecond_;
+        if (tokens_ > capacity)
+            tokens_ = capacity;
+    }
+
+    uint16_t framesPerSecond_ = 0;
+    uint16_t minGapMs_ = 0;
+    uint32_t tokens_ = 0;
+    uint32_t lastRefill_ = 0;
+    uint32_t lastSent_ = 0;
+};
+
+// ============================================================================
+// TRANSMIT LANES
+// ============================================================================
+// Every frame the PC sends belongs to one lane. Lanes are served in this
+// order, each under its own budget: writes from HA or SG Ready, the readbacks
+// that confirm them, the periodic polls and the background probes.
+
+enum TxLane : uint8_t {
+    TX_LANE_COMMAND,
+    TX_LANE_CONFIRM,
+    TX_LANE_POLL,
+    TX_LANE_PROBE,
+    TX_LANE_COUNT
+};
+
+// A write or read waiting in a lane
+struct TxRequest {
+    uint32_t queuedMs;  // millis() when queued
+    uint16_t index;     // Elster index
+    uint16_t value;     // raw value to write, 0 for reads
+    uint8_t member;     // CanMemberType of the addressed member
+    bool write;
+};
+
+// First-in first-out ring of up to N TxRequests; never allocates
+template <size_t N>
+class TxQueue {
+public:
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == N; }
+    size_t size() const { return size_; }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Append `req`. Returns false if the queue is full.
+    bool push(const TxRequest& req) {
+        if (full())
+            return false;
+        ring_[(head_ + size_) % N] = req;
+        size_++;
+        return true;
+    }
+
+    // Oldest request; only valid if !empty()
+    const TxRequest& front() const { return ring_[head_]; }
+
+    void pop() {
+        head_ = (head_ + 1) % N;
+        size_--;
+    }
+
+private:
+    TxRequest ring_[N] = {};
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// BUS LOAD LIMITER
+// ============================================================================
+// Counts the bits of every frame seen on the bus (received and sent) over a
+// fixed window and adapts the request budget once per window: halve it when
+// the utilisation or the arbitration losses exceed their limits, raise it by
+// one frame per second when the bus is quiet (AIMD, as in TCP congestion
+// control), keep it otherwise.
+
+class BusLoadLimiter {
+public:
+    struct Config {
+        uint32_t bitRate;           // bus bit rate in bit/s
+        uint16_t windowMs;          // measurement window
+        uint8_t  highPercent;       // back off above this utilisation
+        uint8_t  lowPercent;        // speed up below this utilisation
+        uint16_t arbLostLimit;      // back off at this many arbitration losses per window
+        uint16_t minFramesPerSec;   // budget limits
+        uint16_t maxFramesPerSec;
+    };
+
+    void configure(const Config& config, uint16_t framesPerSecond, uint32_t now) {
+        config_ = config;
+        budget_ = clamp(framesPerSecond);
+        windowStart_ = now;
+        windowBits_ = 0;
+        loadPercent_ = 0;
+        arbLost_ = 0;
+        arbLostTotal_ = 0;
+        arbLostKnown_ = false;
+    }
+
+    // Bits of a standard (11-bit ID) data frame with `dlc` bytes: 47 bits of
+    // framing and interframe space plus the data, and about one stuff bit per
+    // five bits of the stuffed part
+    static uint32_t frameBits(uint8_t dlc) {
+        const uint32_t data = 8u * (dlc > 8 ? 8 : dlc);
+        return 47 + data + (34 + data) / 5;
+    }
+
+    void frameSeen(uint8_t dlc) { windowBits_ += frameBits(dlc); }
+
+    bool windowElapsed(uint32_t now) const { return now - windowStart_ >= config_.windowMs; }
+
+    // Close the window once it has elapsed and adapt the budget. `arbLostTotal`
+    // is the controller's running count of lost arbitrations (0 if unknown).
+    // Returns true when the budget was re-evaluated.
+    bool update(uint32_t now, uint32_t arbLostTotal) {
+        if (!windowElapsed(now))
+            return false;
+        const uint32_t elapsed = now - windowStart_;
+
+        const uint64_t capacity = static_cast<uint64_t>(config_.bitRate) * elapsed / 1000;
+        const uint64_t percent = capacity > 0 ? static_cast<uint64_t>(windowBits_) * 100 / capacity : 0;
+        loadPercent_ = static_cast<uint8_t>(percent > 100 ? 100 : percent);
+        arbLost_ = arbLostKnown_ ? arbLostTotal - arbLostTotal_ : 0;
+        arbLostTotal_ = arbLostTotal;
+        arbLostKnown_ = true;
+        windowStart_ = now;
+        windowBits_ = 0;
+
+        if (loadPercent_ > config_.highPercent || (config_.arbLostLimit > 0 && arbLost_ >= config_.arbLostLimit))
+            budget_ = clamp(budget_ / 2);
+        else if (loadPercent_ < config_.lowPercent)
+            budget_ = clamp(budget_ + 1);
+        return true;
+    }
+
+    uint16_t budget() const { return budget_; }
+    uint8_t loadPercent() const { return loadPercent_; }     // last window
+    uint32_t arbLost() const { return arbLost_; }            // last window
+
+private:
+    uint16_t clamp(uint32_t fps) const {
+        if (fps < config_.minFramesPerSec) return config_.minFramesPerSec;
+        if (fps > config_.maxFramesPerSec) return config_.maxFramesPerSec;
+        return static_cast<uint16_t>(fps);
+    }
+
+    Config config_ = {};
+    uint16_t budget_ = 0;
+    uint32_t windowStart_ = 0;
+    uint32_t windowBits_ = 0;
+    uint8_t loadPercent_ = 0;
+    uint32_t arbLost_ = 0;
+    uint32_t arbLostTotal_ = 0;
+    bool arbLostKnown_ = false;
+};
+
+// ============================================================================
+// OUTSTANDING REQUESTS
+// ============================================================================
+// One entry per read request that has not been answered yet, keyed on the
+// member (CanMemberType) and the Elster index. A response removes its entry
+// and yields the round-trip time; entries older than the timeout are taken
+// out by takeExpired() for a retry or to be counted as timed out. The table
+// has a fixed capacity reserved once; requests beyond it are not tracked.
+
+struct OutstandingRequest {
+    static constexpr uint16_t NO_SLOT = 0xFFFF;
+
+    uint32_t sentMs;    // millis() of the last send
+    uint16_t index;     // Elster index
+    uint16_t slot;      // schedule slot that sent it, NO_SLOT for other reads
+    uint8_t member;     // CanMemberType of the addressed member
+    uint8_t attempts;   // sends so far, 1 for the first request
+    uint8_t lane;       // TxLane it was sent in, retries use the same
+};
+
+class OutstandingRequests {
+public:
+    void reset(size_t capacity) {
+        entries_.clear();
+        entries_.reserve(capacity);
+        capacity_ = capacity;
+    }
+
+    bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+
+    // Track a request sent at `now`. A request for a pair that is already
+    // outstanding replaces it. Returns false if the table is full.
+    bool add(uint8_t member, uint16_t index, uint32_t now, uint8_t attempts,
+             uint16_t slot = OutstandingRequest::NO_SLOT, uint8_t lane = TX_LANE_POLL) {
+        OutstandingRequest* entry = find(member, index);
+        if (!entry) {
+            if (entries_.size() >= capacity_)
+                return false;
+            entries_.push_back({});
+            entry = &entries_.back();
+        }
+        *entry = {now, index, slot, member, attempts, lane};
+        return true;
+    }
+
+    // Match a response from `member` for `index`: removes the entry into
+    // `out`; the round-trip time is now - out.sentMs
+    bool complete(uint8_t member, uint16_t index, OutstandingRequest& out) {
+        OutstandingRequest* entry = find(member, index);
+        if (!entry)
+            return false;
+        out = *entry;
+        remove(entry);
+        return true;
+    }
+
+    // Remove one entry whose timeout has passed at `now` into `out`
+    bool takeExpired(uint32_t now, uint32_t timeoutMs, OutstandingRequest& out) {
+        for (OutstandingRequest& entry : entries_) {
+            if (deadlineReached(now, entry.sentMs + timeoutMs)) {
+                out = entry;
+                remove(&entry);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    OutstandingRequest* find(uint8_t member, uint16_t index) {
+        for (OutstandingRequest& entry : entries_)
+            if (entry.member == member && entry.index == index)
+                return &entry;
+        return nullptr;
+    }
+
+    // Order does not matter: fill the hole with the last entry
+    void remove(OutstandingRequest* entry) {
+        *entry = entries_.back();
+        entries_.pop_back();
+    }
+
+    std::vector<OutstandingRequest> entries_;
+    size_t capacity_ = 0;
+};
+
+// ============================================================================
+// RTT HISTOGRAM
+// ============================================================================
+// Round-trip times in power-of-two buckets: bucket 0 holds 0 ms, bucket b
+// holds [2^(b-1), 2^b) ms, the last bucket everything from 2^(BUCKETS-2) ms
+// (16 s) on. Percentiles interpolate linearly inside their bucket, which is
+// plenty to tell a 40 ms member from a 400 ms one in 64 bytes per member.
+
+class RttHistogram {
+public:
+    static constexpr unsigned BUCKETS = 16;
+
+    void record(uint32_t rttMs) {
+        unsigned b = 0;
+        while (rttMs >> b && b < BUCKETS - 1)
+            b++;
+        counts_[b]++;
+        samples_++;
+    }
+
+    uint32_t samples() const { return samples_; }
+
+    // Estimated `percent` percentile in ms, 0 without samples
+    uint32_t percentile(unsigned percent) const {
+        if (samples_ == 0)
+            return 0;
+        // rank of the wanted sample, 1-based
+        uint64_t rank = (static_cast<uint64_t>(samples_) * percent + 99) / 100;
+        if (rank == 0)
+            rank = 1;
+        uint64_t below = 0;
+        for (unsigned b = 0; b < BUCKETS; b++) {
+            if (below + counts_[b] >= rank) {
+                if (b == 0)
+                    return 0;
+                const uint32_t low = 1u << (b - 1);
+                const uint32_t width = low;   // [2^(b-1), 2^b)
+                return low + static_cast<uint32_t>(width * (rank - below - 1) / counts_[b]);
+            }
+            below += counts_[b];
+        }
+        return 0;
+    }
+
+private:
+    uint32_t counts_[BUCKETS] = {};
+    uint32_t samples_ = 0;
+};
+
+// ============================================================================
+// RESPONDER MAP
+// ============================================================================
+// The members that answer a signal polled on all of them (cm_other), one bit
+// per CanMemberType, keyed on the Elster index; NO_RESPONDER once learning
+// found none. Plain data of a fixed size so it can be stored in NVS as one
+// blob; zero-initialise before use.
+
+template <size_t N>
+struct ResponderMap {
+    static constexpr uint32_t NO_RESPONDER = 0x80000000u;   // learned: no member answers
+
+    struct Entry {
+        uint16_t index;
+        uint16_t reserved;
+        uint32_t members;
+    };
+
+    uint32_t count;
+    Entry entries[N];
+
+    void clear() { count = 0; }
+
+    // False for a blob that was not written by this layout
+    bool valid() const { return count <= N; }
+
+    // Members known to answer `index`, NO_RESPONDER if none does, 0 if not
+    // learned yet
+    uint32_t get(uint16_t index) const {
+        for (uint32_t i = 0; i < count; i++)
+            if (entries[i].index == index)
+                return entries[i].members;
+        return 0;
+    }
+
+    // Store the members of `index`. Returns true if the map changed; a new
+    // index is not stored once the map is full.
+    bool set(uint16_t index, uint32_t members) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (entries[i].index == index) {
+                if (entries[i].members == members)
+                    return false;
+                entries[i].members = members;
+                return true;
+            }
+        }
+        if (count >= N)
+            return false;
+        entries[count++] = {index, 0, members};
+        return true;
+    }
+};
+
+// ============================================================================
+// SLOT HEALTH
+// ============================================================================
+// Consecutive requests of a schedule slot that stayed unanswered or got the
+// 0x8000 "no value" answer. From `threshold` misses on the slot is
+// quarantined: every miss doubles its interval up to a ceiling. The first
+// valid answer restores it. Zero-initialise before use.
+
+struct SlotHealth {
+    uint8_t misses;     // consecutive requests without a valid answer
+    uint8_t backoff;    // interval doublings, 0 while healthy
+
+    bool quarantined() const { return backoff > 0; }
+
+    // Interval of a slot configured for `baseMs`; backing off never goes
+    // beyond `ceilingMs`, nor shortens a base interval above it
+    uint32_t interval(uint32_t baseMs, uint32_t ceilingMs) const {
+        uint32_t ms = baseMs;
+        for (uint8_t i = 0; i < backoff && ms < ceilingMs; i++)
+            ms = ms > ceilingMs / 2 ? ceilingMs : ms * 2;
+        return ms;
+    }
+
+    // A request got no valid answer. Returns true if this quarantined the slot.
+    bool miss(uint8_t threshold, uint32_t baseMs, uint32_t ceilingMs) {
+        if (misses < UINT8_MAX)
+            misses++;
+        if (misses < threshold)
+            return false;
+        if (backoff > 0 && interval(baseMs, ceilingMs) >= ceilingMs)
+            return false;
+        backoff++;
+        return backoff == 1;
+    }
+
+    // A valid answer. Returns true if the slot was quarantined.
+    bool answer() {
+        const bool wasQuarantined = quarantined();
+        misses = 0;
+        backoff = 0;
+        return wasQuarantined;
+    }
+};
+
+#endif // REQUEST_SCHEDULER_H
@@ -23,6 +23,11 @@ public:
     // Write a CAN signal value (e.g. "PROGRAMMSCHALTER" = "Tagbetrieb")
     virtual void writeCanSignal(const char* signalName, const char* value) = 0;
 
+    // Bracket the writes of one state change (named `name`) so they can be
+    // sent as one ordered transaction. By default each write stands alone.
+    virtual void beginCanWrites(const char* /*name*/) {}
+    virtual void endCanWrites() {}
+
     // Publish a value to an MQTT state topic
     virtual void publishMqtt(const char* topic, const char* value) = 0;
 
@@ -96,12 +101,14 @@ public:
         snprintf(topic, sizeof(topic), "heatingpump/MANAGER/SG_READY_STATE/state");
         io_.publishMqtt(topic, stateLabel(newState));
 
+        io_.beginCanWrites(stateLabel(newState));
         switch (newState) {
             case STATE_EVU_LOCK:   applyEvuLock();    break;
             case STATE_NORMAL:     applyNormal();     break;
             case STATE_RECOMMENDED: applyRecommended(); break;
             case STATE_FORCED:     applyForced();     break;
         }
+        io_.endCanWrites();
         return true;
     }
 
@@ -18,6 +18,12 @@
  * Notes:
  * - cm_other queries all three main CAN members (kessel, manager, heizmodul).
  *   Use it when the responding member varies by heat pump model.
+ * - pollGroup (4th field, pg_* in ha-stiebel-control.h) ties adjacent rows of
+ *   one member together: they are requested back to back at the frequency of
+ *   the first row and published as one snapshot.
+ * - deadband (5th field) overrides the state deadband of the signal, in its
+ *   unit: a new value is published only if it moved by more than that. The
+ *   default depends on the device class (STATE_DEADBAND_* in config.h).
  * - Energy counter signals are included here because COP calculations in
  *   ha-stiebel-control.h depend on them universally. If a model lacks them,
  *   the signals simply never respond and COP stays unpublished — no harm done.
@@ -26,34 +32,59 @@
 #ifndef SIGNAL_REQUESTS_BASE_H
 #define SIGNAL_REQUESTS_BASE_H
 
-#define SIGNAL_REQUESTS_BASE \
+// The base rows as X(name, frequency, member, pollGroup): expanded into
+// SignalRequest rows here and into names for ELSTER_SIGNALS_BASE below, so
+// the two lists cannot drift apart.
+#define SIGNAL_REQUESTS_BASE_ROWS(X) \
     \
     /* -------------------------------------------------------------------- */ \
-    /* DATE AND TIME                                                         */ \
+    /* DATE AND TIME — one poll group, published as one snapshot            */ \
     /* -------------------------------------------------------------------- */ \
-    {"JAHR",    FREQ_1MIN, cm_manager}, \
-    {"MONAT",   FREQ_1MIN, cm_manager}, \
-    {"TAG",     FREQ_1MIN, cm_manager}, \
-    {"STUNDE",  FREQ_1MIN, cm_manager}, \
-    {"MINUTE",  FREQ_1MIN, cm_manager}, \
-    {"SEKUNDE", FREQ_1MIN, cm_manager}, \
+    X("JAHR",    FREQ_1MIN, cm_manager, pg_datetime) \
+    X("MONAT",   FREQ_1MIN, cm_manager, pg_datetime) \
+    X("TAG",     FREQ_1MIN, cm_manager, pg_datetime) \
+    X("STUNDE",  FREQ_1MIN, cm_manager, pg_datetime) \
+    X("MINUTE",  FREQ_1MIN, cm_manager, pg_datetime) \
+    X("SEKUNDE", FREQ_1MIN, cm_manager, pg_datetime) \
     \
     /* -------------------------------------------------------------------- */ \
     /* OPERATING STATE                                                       */ \
     /* -------------------------------------------------------------------- */ \
-    {"EVU_SPERRE_AKTIV", FREQ_1MIN,  cm_manager},   \
-    {"PROGRAMMSCHALTER", FREQ_10MIN, cm_manager},   \
-    {"SOMMERBETRIEB",    FREQ_1MIN,  cm_manager},   \
-    {"VERDICHTER",       FREQ_30S,   cm_heizmodul}, \
+    X("EVU_SPERRE_AKTIV", FREQ_1MIN,  cm_manager,   pg_none) \
+    X("PROGRAMMSCHALTER", FREQ_10MIN, cm_manager,   pg_none) \
+    X("SOMMERBETRIEB",    FREQ_1MIN,  cm_manager,   pg_none) \
+    X("VERDICHTER",       FREQ_30S,   cm_heizmodul, pg_none) \
     \
     /* -------------------------------------------------------------------- */ \
-    /* ENERGY COUNTERS — required for COP calculations                      */ \
+    /* ENERGY COUNTERS — required for COP calculations, one poll group      */ \
     /* -------------------------------------------------------------------- */ \
-    {"EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH", FREQ_10MIN, cm_heizmodul}, \
-    {"EL_AUFNAHMELEISTUNG_WW_SUM_MWH",   FREQ_10MIN, cm_heizmodul}, \
-    {"WAERMEERTRAG_WW_SUM_MWH",          FREQ_10MIN, cm_heizmodul}, \
-    {"WAERMEERTRAG_HEIZ_SUM_MWH",        FREQ_10MIN, cm_heizmodul}, \
-    {"WAERMEERTRAG_2WE_WW_SUM_MWH",      FREQ_10MIN, cm_heizmodul}, \
-    {"WAERMEERTRAG_2WE_HEIZ_SUM_MWH",    FREQ_10MIN, cm_heizmodul},
+    X("EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH", FREQ_10MIN, cm_heizmodul, pg_cop) \
+    X("EL_AUFNAHMELEISTUNG_WW_SUM_MWH",   FREQ_10MIN, cm_heizmodul, pg_cop) \
+    X("WAERMEERTRAG_WW_SUM_MWH",          FREQ_10MIN, cm_heizmodul, pg_cop) \
+    X("WAERMEERTRAG_HEIZ_SUM_MWH",        FREQ_10MIN, cm_heizmodul, pg_cop) \
+    X("WAERMEERTRAG_2WE_WW_SUM_MWH",      FREQ_10MIN, cm_heizmodul, pg_cop) \
+    X("WAERMEERTRAG_2WE_HEIZ_SUM_MWH",    FREQ_10MIN, cm_heizmodul, pg_cop)
+
+#define SIGNAL_REQUEST_BASE_ROW(name, frequency, member, pollGroup) {name, frequency, member, pollGroup},
+#define SIGNAL_REQUEST_BASE_NAME(name, frequency, member, pollGroup) name,
+
+#define SIGNAL_REQUESTS_BASE SIGNAL_REQUESTS_BASE_ROWS(SIGNAL_REQUEST_BASE_ROW)
+
+/*
+ * Universal Elster signal set — every ElsterTable name the shared firmware
+ * uses, for the per-model ElsterSignalSet (see signal_set_wpl13e.h):
+ * the signals of SIGNAL_REQUESTS_BASE, writableNumbers / writableSelects,
+ * on-demand reads from common.yaml and inputs of the calculated sensors.
+ * Only macros here, so KElsterTable.cpp can include this file as well.
+ */
+#define ELSTER_SIGNALS_BASE \
+    SIGNAL_REQUESTS_BASE_ROWS(SIGNAL_REQUEST_BASE_NAME) \
+    /* writableNumbers / writableSelects (SG_READY_* are not CAN signals) */ \
+    "EINSTELL_SPEICHERSOLLTEMP", "EINSTELL_SPEICHERSOLLTEMP2", \
+    "RAUMSOLLTEMP_I", "RAUMSOLLTEMP_II", "RAUMSOLLTEMP_III", "RAUMSOLLTEMP_NACHT", \
+    /* read on demand from common.yaml */ \
+    "WW_ECO", \
+    /* delta T inputs of the calculated sensors */ \
+    "WPVORLAUFIST", "RUECKLAUFISTTEMP",
 
 #endif // SIGNAL_REQUESTS_BASE_H
@@ -30,8 +30,8 @@ extern const SignalRequest signalRequests[] = {
     {"SPEICHERISTTEMP",             FREQ_30S,  cm_kessel},
     {"AUSSENTEMP",                  FREQ_30S,  cm_other},    // cm_other: varies by install
     {"RUECKLAUFISTTEMP",            FREQ_30S,  cm_manager},
-    {"RUECKLAUFISTTEMP",            FREQ_30S,  cm_kessel},
-    {"WPVORLAUFIST",                FREQ_30S,  cm_kessel},
+    {"RUECKLAUFISTTEMP",            FREQ_30S,  cm_kessel, pg_delta_t},
+    {"WPVORLAUFIST",                FREQ_30S,  cm_kessel, pg_delta_t},
     {"EINSTELL_SPEICHERSOLLTEMP",   FREQ_30S,  cm_manager},
     {"EINSTELL_SPEICHERSOLLTEMP",   FREQ_30S,  cm_kessel},
     {"ABTAUUNGAKTIV",               FREQ_1MIN, cm_heizmodul},
@@ -36,8 +36,8 @@ extern const SignalRequest signalRequests[] = {
     {"EINSTELL_SPEICHERSOLLTEMP",  FREQ_30S,   cm_kessel},
     {"EINSTELL_SPEICHERSOLLTEMP",  FREQ_30S,   cm_manager},
     {"RUECKLAUFISTTEMP",           FREQ_30S,   cm_manager},
-    {"RUECKLAUFISTTEMP",           FREQ_30S,   cm_kessel},
-    {"WPVORLAUFIST",               FREQ_30S,   cm_kessel},
+    {"RUECKLAUFISTTEMP",           FREQ_30S,   cm_kessel, pg_delta_t},
+    {"WPVORLAUFIST",               FREQ_30S,   cm_kessel, pg_delta_t},
     {"EINSTELL_SPEICHERSOLLTEMP2", FREQ_30S,   cm_kessel},
     {"EINSTELL_SPEICHERSOLLTEMP2", FREQ_30S,   cm_manager},
     {"ABTAUUNGAKTIV",              FREQ_1MIN,  cm_heizmodul},
@@ -0,0 +1,27 @@
+/*
+ * Elster Signal Set — WPF10 / WPF10M Heat Pump (Ground-Source)
+ *
+ * Every ElsterTable name the WPF10 firmware uses. wpf10.yaml builds with
+ * ELSTER_SIGNAL_SET pointing at this file; see signal_set_wpl13e.h.
+ *
+ * Keep this list in sync with signal_requests_wpf10.h.
+ */
+
+#ifndef SIGNAL_SET_WPF10_H
+#define SIGNAL_SET_WPF10_H
+
+#include "signal_requests_base.h"
+
+static constexpr const char * ElsterSignalSet[] = {
+    ELSTER_SIGNALS_BASE   // universal signals, writables, calculated sensor inputs
+
+    // signal_requests_wpf10.h (QUELLENEINTRITTSTEMPERATUR and QUELLENAUSTRITTSTEMP
+    // are not in ElsterTable.h and resolve to INDEX_NOT_FOUND either way)
+    "KESSELSOLLTEMP", "SPEICHERSOLLTEMP", "SPEICHERISTTEMP", "AUSSENTEMP",
+    "ABTAUUNGAKTIV", "BETRIEBSART_WP", "HEIZKURVE", "ANTILEGIONELLEN",
+
+    // Passive listen allow-list: signals other bus members send on their own
+    // (no request in signal_requests_wpf10.h) that should still be published.
+};
+
+#endif // SIGNAL_SET_WPF10_H
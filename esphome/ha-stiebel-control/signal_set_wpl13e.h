@@ -0,0 +1,39 @@
+/*
+ * Elster Signal Set — WPL13E Heat Pump
+ *
+ * Every ElsterTable name the WPL13E firmware uses. wpl13e.yaml builds with
+ * ELSTER_SIGNAL_SET pointing at this file, so KElsterTable.cpp links only
+ * these rows instead of the full ElsterTable (see elster/KElsterTable.cpp).
+ * Frames for any other index are still decoded with the right type for the
+ * log, but never published.
+ *
+ * Keep this list in sync with signal_requests_wpl13e.h — `make test` fails
+ * if a requested signal is missing here, the firmware build fails if a name
+ * here is not in ElsterTable.h.
+ */
+
+#ifndef SIGNAL_SET_WPL13E_H
+#define SIGNAL_SET_WPL13E_H
+
+#include "signal_requests_base.h"
+
+static constexpr const char * ElsterSignalSet[] = {
+    ELSTER_SIGNALS_BASE   // universal signals, writables, calculated sensor inputs
+
+    // signal_requests_wpl13e.h
+    "KESSELSOLLTEMP", "SPEICHERSOLLTEMP", "SPEICHERISTTEMP", "SAMMLERISTTEMP",
+    "VORLAUFISTTEMP", "AUSSENTEMP", "ABTAUUNGAKTIV", "BETRIEBSART_WP",
+
+    // probe signals
+    "HEIZKURVE", "WW_HYSTERSE", "ANTILEGIONELLEN", "ANTILEGIONELLEN_ZEITPUNKT",
+    "GEBAEUDEART",
+
+    // compressor runtime counters
+    "LZ_VERD_1_HEIZBETRIEB", "LZ_VERD_2_HEIZBETRIEB", "LZ_VERD_1_2_HEIZBETRIEB",
+    "LZ_VERD_1_KUEHLBETRIEB", "LZ_VERD_2_KUEHLBETRIEB", "LZ_VERD_1_2_KUEHLBETRIEB",
+
+    // Passive listen allow-list: signals other bus members send on their own
+    // (no request in signal_requests_wpl13e.h) that should still be published.
+};
+
+#endif // SIGNAL_SET_WPL13E_H
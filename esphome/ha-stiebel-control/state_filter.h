@@ -0,0 +1,122 @@
+/*
+ * StateFilter — decides whether a received signal value is worth publishing.
+ *
+ * No ESPHome dependencies. Each entity keeps the last value it published in a
+ * PublishedState. A new value is published when it differs from that one:
+ * a number by more than the entity's deadband, anything else (or any value
+ * with deadband 0) in its text. A value whose entity has published nothing
+ * for the heartbeat interval is published even when unchanged, so a retained
+ * state never goes stale. The filter counts what it published and what it
+ * suppressed.
+ *
+ *   StateFilter filter(10 * 60 * 1000UL);
+ *   if (filter.publishes(filter.check(entity.state, "21.5", true, 215, 1, 0.1f, millis())))
+ *       publish(entity.stateTopic, "21.5");
+ */
+
+#ifndef STATE_FILTER_H
+#define STATE_FILTER_H
+
+#include <cstdint>
+
+// Last published value of one entity
+struct PublishedState {
+    uint32_t textHash = 0;
+    uint32_t publishedMs = 0;
+    long fixed = 0;             // the number as Fixed / 10^decimals
+    uint8_t decimals = 0;
+    bool hasNumber = false;
+    bool valid = false;         // false until the first publish
+};
+
+class StateFilter {
+public:
+    enum Verdict : uint8_t {
+        PUBLISH_CHANGED,        // first value, or changed beyond the deadband
+        PUBLISH_HEARTBEAT,      // unchanged, but silent for the heartbeat interval
+        SUPPRESS_UNCHANGED,     // same text as published last
+        SUPPRESS_DEADBAND,      // a number within the deadband of the last one
+    };
+
+    // Heartbeat interval in ms; 0 publishes an unchanged value never again
+    explicit StateFilter(uint32_t heartbeatMs = 0) : heartbeatMs_(heartbeatMs) {}
+
+    uint32_t heartbeatMs() const { return heartbeatMs_; }
+
+    // Verdict for a value with text `text` and, if `hasNumber`, the number
+    // fixed / 10^decimals, against the last published value `last`. `last`
+    // becomes this value if it is to be published. `deadband` is in the unit
+    // of the number; 0 publishes every change.
+    Verdict check(PublishedState& last, const char* text, bool hasNumber, long fixed, uint8_t decimals,
+                  float deadband, uint32_t now) {
+        const uint32_t textHash = hash(text);
+        Verdict verdict = PUBLISH_CHANGED;
+        if (!last.valid) {
+            // first value of the entity
+        } else if (textHash == last.textHash) {
+            verdict = SUPPRESS_UNCHANGED;
+        } else if (withinDeadband(last, hasNumber, fixed, decimals, deadband)) {
+            verdict = SUPPRESS_DEADBAND;
+        }
+        // A value that would be suppressed goes out once the entity was silent
+        // for the heartbeat interval
+        if (!publishes(verdict) && heartbeatMs_ > 0 && now - last.publishedMs >= heartbeatMs_)
+            verdict = PUBLISH_HEARTBEAT;
+
+        switch (verdict) {
+            case PUBLISH_CHANGED:    published_++; break;
+            case PUBLISH_HEARTBEAT:  published_++; heartbeats_++; break;
+            case SUPPRESS_UNCHANGED: suppressedUnchanged_++; break;
+            case SUPPRESS_DEADBAND:  suppressedDeadband_++; break;
+        }
+        if (publishes(verdict)) {
+            last.textHash = textHash;
+            last.publishedMs = now;
+            last.fixed = fixed;
+            last.decimals = decimals;
+            last.hasNumber = hasNumber;
+            last.valid = true;
+        }
+        return verdict;
+    }
+
+    static bool publishes(Verdict verdict) { return verdict <= PUBLISH_HEARTBEAT; }
+
+    // Publishes, the heartbeats among them, and suppressed values by reason
+    uint32_t published() const { return published_; }
+    uint32_t heartbeats() const { return heartbeats_; }
+    uint32_t suppressedUnchanged() const { return suppressedUnchanged_; }
+    uint32_t suppressedDeadband() const { return suppressedDeadband_; }
+    uint32_t suppressed() const { return suppressedUnchanged_ + suppressedDeadband_; }
+
+    void resetCounters() {
+        published_ = heartbeats_ = suppressedUnchanged_ = suppressedDeadband_ = 0;
+    }
+
+private:
+    static bool withinDeadband(const PublishedState& last, bool hasNumber, long fixed, uint8_t decimals,
+                               float deadband) {
+        static const float scale[] = {1.0f, 10.0f, 100.0f, 1000.0f};
+        if (deadband <= 0 || !hasNumber || !last.hasNumber || decimals != last.decimals || decimals > 3)
+            return false;
+        const long delta = fixed > last.fixed ? fixed - last.fixed : last.fixed - fixed;
+        // The tolerance keeps e.g. 0.7 * 10 = 6.9999995 from missing a delta of 7
+        return static_cast<float>(delta) <= deadband * scale[decimals] + 0.001f;
+    }
+
+    // djb2, as hash_runtime() in ha-stiebel-control.h
+    static uint32_t hash(const char* s) {
+        uint32_t h = 5381;
+        for (; s && *s; s++)
+            h = ((h << 5) + h) + static_cast<uint32_t>(*s);
+        return h;
+    }
+
+    uint32_t heartbeatMs_;
+    uint32_t published_ = 0;
+    uint32_t heartbeats_ = 0;
+    uint32_t suppressedUnchanged_ = 0;
+    uint32_t suppressedDeadband_ = 0;
+};
+
+#endif // STATE_FILTER_H
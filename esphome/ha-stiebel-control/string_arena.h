@@ -0,0 +1,105 @@
+/*
+ * StringArena — append-only storage for strings that live as long as the program.
+ *
+ * No ESPHome dependencies. Strings are copied or formatted into blocks of
+ * BlockSize bytes, taken from the heap one at a time as they fill up; a block
+ * is never moved, so the returned pointers stay valid until clear(). There is
+ * no per-string header and no per-string free: the overhead is the unused
+ * tail of the last block and one pointer per block.
+ *
+ *   StringArena<1024> names;
+ *   const char *topic = names.format("heatingpump/%s/%s/state", member, signal);
+ */
+
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+template <size_t BlockSize>
+class StringArena {
+public:
+    StringArena() = default;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    ~StringArena() { clear(); }
+
+    // Copy of the `len` bytes at `s`, NUL-terminated; nullptr if it does not
+    // fit in one block
+    char* add(const char* s, size_t len) {
+        char* p = reserve(len + 1);
+        if (!p) return nullptr;
+        memcpy(p, s, len);
+        p[len] = '\0';
+        commit(len + 1);
+        return p;
+    }
+
+    // printf into the arena; nullptr if the result does not fit in one block
+    __attribute__((format(printf, 2, 3)))
+    char* format(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        int len = vsnprintf(nullptr, 0, fmt, args);
+        va_end(args);
+        if (len < 0) return nullptr;
+        char* p = reserve(static_cast<size_t>(len) + 1);
+        if (!p) return nullptr;
+        va_start(args, fmt);
+        vsnprintf(p, static_cast<size_t>(len) + 1, fmt, args);
+        va_end(args);
+        commit(static_cast<size_t>(len) + 1);
+        return p;
+    }
+
+    // Frees every block; all strings handed out become invalid
+    void clear() {
+        while (head_) {
+            Block* next = head_->next;
+            delete head_;
+            head_ = next;
+        }
+        used_ = BlockSize;
+        blocks_ = 0;
+        size_ = 0;
+    }
+
+    size_t blocks() const { return blocks_; }
+    // Bytes of the strings and their terminators, and bytes taken from the heap
+    size_t size() const { return size_; }
+    size_t capacity() const { return blocks_ * sizeof(Block); }
+
+private:
+    struct Block {
+        Block* next;
+        char data[BlockSize];
+    };
+
+    // Room for `n` bytes in the current block, opening a new one if needed
+    char* reserve(size_t n) {
+        if (n > BlockSize) return nullptr;
+        if (used_ + n > BlockSize) {
+            Block* block = new Block;
+            block->next = head_;
+            head_ = block;
+            used_ = 0;
+            blocks_++;
+        }
+        return head_->data + used_;
+    }
+
+    void commit(size_t n) {
+        used_ += n;
+        size_ += n;
+    }
+
+    Block* head_ = nullptr;
+    size_t used_ = BlockSize;   // bytes used in head_; BlockSize while there is none
+    size_t blocks_ = 0;
+    size_t size_ = 0;
+};
+
+#endif // STRING_ARENA_H
@@ -287,7 +287,7 @@ def ai_refine_elster_table(input_file, output_file, max_entries=None, start_from
     pending_lines = []  # Lines waiting to be processed
     
     for line_idx, line in enumerate(lines):
-        if 'ElsterTable[]' in line:
+        if 'ElsterTableRows[]' in line:
             in_table = True
             output_lines.append(line)
             continue
@@ -0,0 +1,444 @@
+/*
+ * Host benchmarks for the frame handling and request paths in
+ * ha-stiebel-control.h, built with -O2 by `make bench`. Same fakes as
+ * test_can_logic.cpp (esphome_stubs.h); the WPL13E request table is linked
+ * in directly instead of signal_requests_stub.cpp so the request tick has work.
+ *
+ * Catch2 must be included BEFORE esphome_stubs.h (see test_can_logic.cpp).
+ */
+#include "catch2/catch_amalgamated.hpp"
+
+#include "esphome_stubs.h"
+
+#include "../esphome/ha-stiebel-control/ha-stiebel-control.h"
+#include "../esphome/ha-stiebel-control/signal_requests_wpl13e.h"
+#include "../esphome/ha-stiebel-control/signal_set_wpl13e.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+// ============================================================================
+// ALLOCATION COUNTER — every operator new in the bench binary, with the bytes
+// in use and their peak. Each block carries its size in front of it. The
+// malloc/free pair stays behind helpers the compiler does not inline, so it
+// never sees free() on a pointer that came out of operator new.
+// ============================================================================
+
+static size_t allocationCount = 0;
+static size_t heapInUse = 0;
+static size_t heapPeak = 0;
+static constexpr size_t HEAP_HEADER = alignof(std::max_align_t);
+
+__attribute__((noinline)) static void* countedAlloc(std::size_t size) {
+    allocationCount++;
+    if (char* p = static_cast<char*>(std::malloc(size + HEAP_HEADER))) {
+        *reinterpret_cast<std::size_t*>(p) = size;
+        heapInUse += size;
+        if (heapInUse > heapPeak)
+            heapPeak = heapInUse;
+        return p + HEAP_HEADER;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) static void countedFree(void* p) noexcept {
+    if (!p)
+        return;
+    char* block = static_cast<char*>(p) - HEAP_HEADER;
+    heapInUse -= *reinterpret_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+
+// ============================================================================
+// FRAME MIX — one response frame per requested WPL13E signal
+// ============================================================================
+
+struct BenchFrame {
+    ElsterFrame frame;
+    const ElsterIndex* ei;
+};
+
+static std::vector<BenchFrame> responseFrames() {
+    std::vector<BenchFrame> frames;
+    for (size_t i = 0; i < SIGNAL_REQUEST_COUNT; i++) {
+        const SignalRequest& req = signalRequests[i];
+        const ElsterIndex* ei = GetElsterIndex(req.signalName);
+        if (ei == &ElsterTable[0] || ei->isBlacklisted)
+            continue;
+        const CanMember& cm = CanMembers[req.member == cm_other ? cm_manager : req.member];
+        // a response to a read request of the PC, sent by the member
+        ElsterFrame frame = buildElsterFrame(generate_response_id(0x680), ei->Index, (uint16_t)(i * 0x0701));
+        frame.canId = cm.CanId;
+        frames.push_back({frame, ei});
+    }
+    return frames;
+}
+
+// ============================================================================
+// INCOMING FRAMES
+// ============================================================================
+TEST_CASE("Frame handling: processCanMessage and processAndUpdate", "[bench]") {
+    const std::vector<BenchFrame> frames = responseFrames();
+    REQUIRE(!frames.empty());
+
+    BENCHMARK("processCanMessage (decode only)") {
+        unsigned sum = 0;
+        for (const BenchFrame& f : frames) {
+            ElsterValue value;
+            const CanMember* cm = nullptr;
+            sum += processCanMessage(f.frame, value, &cm)->Index + value.Raw;
+        }
+        return sum;
+    };
+
+    // Steady state: discovery and state of every signal are already published
+    for (const BenchFrame& f : frames)
+        processAndUpdate(f.frame);
+
+    // A poll round with the same values again: the state filter drops them
+    mqtt_client_instance().clear();
+    const uint32_t suppressedBefore = stateFilter.suppressed();
+    for (const BenchFrame& f : frames)
+        processAndUpdate(f.frame);
+    std::printf("Unchanged poll round of %zu frames: %zu messages, %lu states suppressed\n", frames.size(),
+                mqtt_client_instance().messages.size(), (unsigned long)(stateFilter.suppressed() - suppressedBefore));
+    CHECK(stateFilter.suppressed() > suppressedBefore);
+
+    BENCHMARK("processAndUpdate (decode, unchanged state suppressed, calculated sensors)") {
+        mqtt_client_instance().clear();
+        for (const BenchFrame& f : frames)
+            processAndUpdate(f.frame);
+        return mqtt_client_instance().messages.size();
+    };
+}
+
+// The linear scan lookupCanMember used before the direct-mapped table
+static const CanMember& scanCanMember(uint32_t canId) {
+    for (const CanMember& cm : CanMembers)
+        if (cm.CanId == canId)
+            return cm;
+    return CanMembers[cm_other];
+}
+
+TEST_CASE("Frame handling: lookupCanMember, scan vs table", "[bench]") {
+    const std::vector<BenchFrame> frames = responseFrames();
+
+    BENCHMARK("lookupCanMember, scan") {
+        unsigned sum = 0;
+        for (const BenchFrame& f : frames)
+            sum += scanCanMember(f.frame.canId).CanId;
+        return sum;
+    };
+    BENCHMARK("lookupCanMember, table") {
+        unsigned sum = 0;
+        for (const BenchFrame& f : frames)
+            sum += lookupCanMember(f.frame.canId).CanId;
+        return sum;
+    };
+}
+
+// ============================================================================
+// MQTT DISCOVERY AND UIDS
+// ============================================================================
+TEST_CASE("Discovery: signalEntity and publishMqttDiscovery", "[bench]") {
+    const std::vector<BenchFrame> frames = responseFrames();
+
+    BENCHMARK("signalEntity (interned)") {
+        size_t len = 0;
+        for (const BenchFrame& f : frames)
+            len += strlen(signalEntity(lookupCanMember(f.frame.canId), f.ei)->uid);
+        return len;
+    };
+
+    BENCHMARK("publishMqttDiscovery") {
+        mqtt_client_instance().clear();
+        for (const BenchFrame& f : frames)
+            publishMqttDiscovery(lookupCanMember(f.frame.canId), f.ei);
+        return mqtt_client_instance().messages.size();
+    };
+}
+
+// The names of every signal as the former uidCache and discoveredSignals held
+// them: "<CanId>:<signal>" -> uid, and the set of discovered uids
+static size_t stringMapFootprint(const std::vector<BenchFrame>& frames) {
+    const size_t before = heapInUse;
+    auto* uidCache = new std::unordered_map<std::string, std::string>;
+    auto* discovered = new std::set<std::string>;
+    for (const BenchFrame& f : frames) {
+        const CanMember& cm = lookupCanMember(f.frame.canId);
+        char key[256];
+        snprintf(key, sizeof(key), "%u:%s", cm.CanId, f.ei->Name);
+        std::string uid = signalEntity(cm, f.ei)->uid;
+        (*uidCache)[key] = uid;
+        discovered->insert(uid);
+    }
+    const size_t footprint = heapInUse - before;
+    delete uidCache;
+    delete discovered;
+    return footprint;
+}
+
+TEST_CASE("Discovery: interned signal names vs string maps", "[bench]") {
+    const std::vector<BenchFrame> frames = responseFrames();
+
+    // Heap of the entity table, built from scratch for the frame mix
+    signalNames.clear();
+    std::vector<SignalEntity>().swap(signalEntities);
+    std::vector<uint16_t>().swap(signalEntityIndex);
+    std::vector<bool>().swap(discoveredSignals);
+    memset(entityMemberSlots, 0, sizeof(entityMemberSlots));
+    entityMemberCount = 0;
+    const size_t afterClear = heapInUse;
+    for (const BenchFrame& f : frames)
+        REQUIRE(signalEntity(lookupCanMember(f.frame.canId), f.ei) != nullptr);
+    signalEntities.shrink_to_fit();
+    const size_t entityHeap = heapInUse - afterClear;
+    const size_t indexHeap = signalEntityIndex.capacity() * sizeof(uint16_t);
+    // The state filter fields of an entity have no counterpart in the maps
+    const size_t filterHeap = signalEntities.size() * (sizeof(float) + sizeof(PublishedState));
+    const size_t mapHeap = stringMapFootprint(frames);
+    std::printf("%zu signal entities (%u members): %zu bytes heap (names %zu in %zu blocks, index %zu for "
+                "%u table rows, state filter %zu), uidCache + discoveredSignals %zu bytes\n",
+                signalEntities.size(), (unsigned)entityMemberCount, entityHeap, signalNames.size(),
+                signalNames.blocks(), indexHeap, ElsterTableCount, filterHeap, mapHeap);
+    // The firmware links the WPL13E signal set, not the full table of this binary
+    const size_t prunedRows = sizeof(ElsterSignalSet) / sizeof(ElsterSignalSet[0]) + 1;
+    const size_t prunedIndex = entityMemberCount * prunedRows * sizeof(uint16_t);
+    const size_t namesHeap = entityHeap - indexHeap + prunedIndex - filterHeap;
+    std::printf("  names with the WPL13E table (%zu rows): %zu bytes vs %zu bytes\n",
+                prunedRows, namesHeap, mapHeap);
+    CHECK(namesHeap < mapHeap);
+
+    // A state publish: no allocation
+    mqtt_client_instance().record = false;
+    const CanMember& cm = lookupCanMember(frames[0].frame.canId);
+    const size_t allocationsBefore = allocationCount;
+    for (int i = 0; i < 1000; i++)
+        publishMqttState(cm, frames[0].ei, "21.5");
+    const size_t allocations = allocationCount - allocationsBefore;
+    mqtt_client_instance().record = true;
+    CHECK(allocations == 0);
+
+    BENCHMARK("publishMqttState") {
+        mqtt_client_instance().record = false;
+        for (const BenchFrame& f : frames)
+            publishMqttState(lookupCanMember(f.frame.canId), f.ei, "21.5");
+        mqtt_client_instance().record = true;
+        return mqtt_client_instance().publishCount;
+    };
+}
+
+TEST_CASE("Discovery: per-frame discovery check, bitset vs std::set", "[bench]") {
+    const std::vector<BenchFrame> frames = responseFrames();
+    std::set<std::string> discoveredUids;
+    for (const BenchFrame& f : frames) {
+        const CanMember& cm = lookupCanMember(f.frame.canId);
+        discoveredSignals[signalEntityKey(cm, f.ei)] = true;
+        discoveredUids.insert(signalEntity(cm, f.ei)->uid);
+    }
+
+    BENCHMARK("discoveredSignals bit test") {
+        size_t discovered = 0;
+        for (const BenchFrame& f : frames)
+            discovered += discoveredSignals[signalEntityKey(lookupCanMember(f.frame.canId), f.ei)];
+        return discovered;
+    };
+    BENCHMARK("std::set<std::string> lookup of the uid") {
+        size_t discovered = 0;
+        for (const BenchFrame& f : frames)
+            discovered += discoveredUids.count(signalEntity(lookupCanMember(f.frame.canId), f.ei)->uid);
+        return discovered;
+    };
+    std::printf("Discovery tracking of %zu signals: bitset %zu bytes, std::set %zu nodes\n",
+                frames.size(), (discoveredSignals.size() + 7) / 8, discoveredUids.size());
+}
+
+// ============================================================================
+// DISCOVERY PAYLOADS — JsonWriter vs the former std::ostringstream builder
+// ============================================================================
+
+// publishMqttDiscovery as it was before JsonWriter, kept as reference
+static void publishMqttDiscoveryOstream(const CanMember &cm, const ElsterIndex *ei) {
+    std::string uid = signalEntity(cm, ei)->uid;
+    const ElsterMetadata *meta = GetElsterMetadata(ei);
+    const char* friendlyName = (meta && meta->friendlyName) ? meta->friendlyName : ei->Name;
+
+    const char *component, *deviceClass, *unit, *stateClass, *icon;
+    const char *payloadOn = nullptr, *payloadOff = nullptr;
+    if (meta && meta->haComponent) {
+        component = meta->haComponent;
+        deviceClass = meta->haDeviceClass ? meta->haDeviceClass : "";
+        unit = meta->unit ? meta->unit : "";
+        stateClass = meta->stateClass ? meta->stateClass : "";
+        icon = meta->icon ? meta->icon : "";
+        payloadOn = meta->payloadOn;
+        payloadOff = meta->payloadOff;
+    } else {
+        getTypeDefaults((ElsterType)ei->Type, component, deviceClass, unit, stateClass, icon);
+        if (strcmp(component, "binary_sensor") == 0) {
+            payloadOn = "on";
+            payloadOff = "off";
+        }
+    }
+
+    char discoveryTopic[256];
+    snprintf(discoveryTopic, sizeof(discoveryTopic),
+             "homeassistant/%s/heatingpump/%s/config", component, uid.c_str());
+    char stateTopic[128];
+    snprintf(stateTopic, sizeof(stateTopic), "heatingpump/%s/%s/state", cm.Name, ei->Name);
+
+    std::ostringstream payload;
+    payload << "{\"name\":\"" << friendlyName << "\","
+            << "\"unique_id\":\"" << uid << "\","
+            << "\"state_topic\":\"" << stateTopic << "\","
+            << "\"availability_topic\":\"heatingpump/status\"";
+    if (strcmp(component, "binary_sensor") == 0 && payloadOn && payloadOff) {
+        payload << ",\"payload_on\":\"" << payloadOn << "\","
+                << "\"payload_off\":\"" << payloadOff << "\"";
+    }
+    if (deviceClass[0] != '\0')
+        payload << ",\"device_class\":\"" << deviceClass << "\"";
+    if (unit[0] != '\0')
+        payload << ",\"unit_of_measurement\":\"" << unit << "\"";
+    if (stateClass[0] != '\0') {
+        bool isNumericType = (ei->Type == et_dec_val || ei->Type == et_cent_val ||
+                              ei->Type == et_mil_val || ei->Type == et_byte ||
+                              ei->Type == et_double_val || ei->Type == et_triple_val ||
+                              ei->Type == et_little_endian);
+        if (isNumericType)
+            payload << ",\"state_class\":\"" << stateClass << "\"";
+    }
+    if (icon[0] != '\0')
+        payload << ",\"icon\":\"" << icon << "\"";
+
+    char canMemberDeviceId[64];
+    snprintf(canMemberDeviceId, sizeof(canMemberDeviceId), "stiebel_%s", cm.Name);
+    payload << ",\"device\":{\"identifiers\":[\"" << canMemberDeviceId << "\"],"
+            << "\"name\":\"" << cm.FriendlyName << "\","
+            << "\"via_device\":\"stiebel_eltron_" HA_DEVICE_MODEL "\","
+            << "\"manufacturer\":\"Stiebel Eltron\"}}";
+
+    std::string payloadStr = payload.str();
+    id(mqtt_client).publish(discoveryTopic, payloadStr.c_str(), payloadStr.length(), 0, true);
+}
+
+// Allocations and peak heap of one discovery publish per frame
+static void reportDiscoveryHeap(const char* name, const std::vector<BenchFrame>& frames,
+                                void (*publish)(const CanMember&, const ElsterIndex*),
+                                size_t& allocations, size_t& peak) {
+    const size_t allocationsBefore = allocationCount;
+    peak = 0;
+    for (const BenchFrame& f : frames) {
+        const size_t base = heapInUse;
+        heapPeak = base;
+        publish(lookupCanMember(f.frame.canId), f.ei);
+        if (heapPeak - base > peak)
+            peak = heapPeak - base;
+    }
+    allocations = allocationCount - allocationsBefore;
+    std::printf("%s: %zu payloads, %.1f allocations per payload, peak heap %zu bytes\n",
+                name, frames.size(), (double)allocations / frames.size(), peak);
+}
+
+TEST_CASE("Discovery: payload build, JsonWriter vs ostringstream", "[bench]") {
+    const std::vector<BenchFrame> frames = responseFrames();
+
+    // Same payloads, byte for byte
+    for (const BenchFrame& f : frames) {
+        const CanMember& cm = lookupCanMember(f.frame.canId);
+        mqtt_client_instance().clear();
+        publishMqttDiscovery(cm, f.ei);
+        publishMqttDiscoveryOstream(cm, f.ei);
+        REQUIRE(mqtt_client_instance().messages.size() == 2);
+        CHECK(mqtt_client_instance().messages[0].topic == mqtt_client_instance().messages[1].topic);
+        CHECK(mqtt_client_instance().messages[0].payload == mqtt_client_instance().messages[1].payload);
+    }
+
+    mqtt_client_instance().record = false;
+    BENCHMARK("publishMqttDiscovery, JsonWriter") {
+        for (const BenchFrame& f : frames)
+            publishMqttDiscovery(lookupCanMember(f.frame.canId), f.ei);
+        return mqtt_client_instance().publishCount;
+    };
+    BENCHMARK("publishMqttDiscovery, ostringstream") {
+        for (const BenchFrame& f : frames)
+            publishMqttDiscoveryOstream(lookupCanMember(f.frame.canId), f.ei);
+        return mqtt_client_instance().publishCount;
+    };
+
+    size_t writerAllocations, writerPeak, ostreamAllocations, ostreamPeak;
+    reportDiscoveryHeap("JsonWriter", frames, publishMqttDiscovery, writerAllocations, writerPeak);
+    reportDiscoveryHeap("ostringstream", frames, publishMqttDiscoveryOstream, ostreamAllocations, ostreamPeak);
+    mqtt_client_instance().record = true;
+    CHECK(writerAllocations < ostreamAllocations);
+    CHECK(writerPeak < ostreamPeak);
+}
+
+// ============================================================================
+// REQUEST SCHEDULER — processSignalRequests() once per main loop pass (16 ms)
+// ============================================================================
+TEST_CASE("Requests: processSignalRequests loop", "[bench]") {
+    // Leave the startup delay behind and initialise the schedules
+    fake_millis() = 1;
+    processSignalRequests();
+    fake_millis() += STARTUP_DELAY_MS;
+    processSignalRequests();
+    REQUIRE(requestManagerStarted);
+
+    fake_can().record = false;
+    BENCHMARK("processSignalRequests (16 ms loop pass)") {
+        fake_millis() += 16;
+        processSignalRequests();
+        return fake_can().sendCount;
+    };
+
+    // One hour of loop passes, outside BENCHMARK so only the scheduler allocates
+    const size_t passes = 3600 * 1000 / 16;
+    const size_t sentBefore = fake_can().sendCount;
+    const size_t allocationsBefore = allocationCount;
+    for (size_t i = 0; i < passes; i++) {
+        fake_millis() += 16;
+        processSignalRequests();
+    }
+    const size_t allocations = allocationCount - allocationsBefore;
+    std::printf("processSignalRequests: %zu loop passes, %zu requests, %zu allocations\n",
+                passes, fake_can().sendCount - sentBefore, allocations);
+    fake_can().record = true;
+    CHECK(allocations == 0);
+}
+
+TEST_CASE("Requests: runRequestSlots tick vs table size", "[bench]") {
+    // The WPL13E table, and the same rows repeated to several hundred slots
+    std::vector<SignalRequest> large;
+    for (int copy = 0; copy < 10; copy++)
+        large.insert(large.end(), signalRequests, signalRequests + SIGNAL_REQUEST_COUNT);
+
+    // A tick with nothing due is the common case: with the esp_random() stub
+    // every first deadline is 42 ms after the build, so tick 0 finds nothing.
+    fake_can().record = false;
+    buildRequestSlots(signalRequests, SIGNAL_REQUEST_COUNT, 0);
+    std::printf("WPL13E: %zu slots\n", requestSlots.size());
+    BENCHMARK("runRequestSlots (nothing due, WPL13E table)") {
+        return runRequestSlots(0);
+    };
+
+    buildRequestSlots(large.data(), large.size(), 0);
+    std::printf("10 x WPL13E: %zu slots\n", requestSlots.size());
+    BENCHMARK("runRequestSlots (nothing due, 10 x WPL13E table)") {
+        return runRequestSlots(0);
+    };
+    fake_can().record = true;
+}
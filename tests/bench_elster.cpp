@@ -0,0 +1,276 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/elster/ElsterTable.h"
+#include "../esphome/ha-stiebel-control/elster/KElsterTable.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+// Host benchmarks — built with -O2 by `make bench`, not part of `make test`.
+
+// ============================================================================
+// FRAME MIX — every non-blacklisted index, in a fixed pseudo-random order
+// ============================================================================
+
+static std::vector<unsigned short> frameIndexes() {
+    std::vector<unsigned short> idx;
+    for (unsigned i = 1; i < ElsterTableCount; i++)
+        if (!ElsterTable[i].isBlacklisted)
+            idx.push_back(ElsterTable[i].Index);
+    unsigned state = 12345;
+    for (size_t i = idx.size() - 1; i > 0; i--) {
+        state = state * 1103515245u + 12345u;
+        std::swap(idx[i], idx[(state >> 8) % (i + 1)]);
+    }
+    return idx;
+}
+
+// ============================================================================
+// TABLE FOOTPRINT
+// ============================================================================
+TEST_CASE("ElsterTable: footprint of wide rows vs hot/cold split", "[bench][footprint]") {
+    unsigned metaRows = 1;  // slot 0 is the empty "no metadata" slot
+    for (unsigned i = 0; i < ElsterTableCount; i++)
+        if (GetElsterMetadata(&ElsterTable[i]))
+            metaRows++;
+
+    size_t wide = sizeof(ElsterTableRows);
+    size_t hot  = ElsterTableCount * sizeof(ElsterIndex);
+    size_t cold = metaRows * sizeof(ElsterMetadata);
+    std::printf("rows: %u, with metadata: %u\n", ElsterTableCount, metaRows - 1);
+    std::printf("wide rows:    %zu bytes (%zu per row)\n", wide, sizeof(ElsterTableRow));
+    std::printf("hot rows:     %zu bytes (%zu per row)\n", hot, sizeof(ElsterIndex));
+    std::printf("metadata:     %zu bytes (%zu per slot)\n", cold, sizeof(ElsterMetadata));
+    std::printf("saved:        %zu bytes\n", wide - hot - cold);
+    CHECK(hot + cold < wide);
+}
+
+// ============================================================================
+// DECODE LOOP — resolve index, skip blacklisted rows, dispatch on type
+// ============================================================================
+TEST_CASE("ElsterTable: decode loop over wide vs compact rows", "[bench]") {
+    const std::vector<unsigned short> frames = frameIndexes();
+
+    BENCHMARK("wide rows (ElsterTableRows)") {
+        unsigned sum = 0;
+        for (unsigned short index : frames) {
+            const ElsterTableRow & row = ElsterTableRows[GetElsterIndex(index) - ElsterTable];
+            if (row.isBlacklisted)
+                continue;
+            sum += row.Type + row.Index + (unsigned char) row.Name[0];
+        }
+        return sum;
+    };
+
+    BENCHMARK("compact rows (ElsterTable)") {
+        unsigned sum = 0;
+        for (unsigned short index : frames) {
+            const ElsterIndex & row = *GetElsterIndex(index);
+            if (row.isBlacklisted)
+                continue;
+            sum += row.Type + row.Index + (unsigned char) row.Name[0];
+        }
+        return sum;
+    };
+}
+
+// ============================================================================
+// VALUE FORMATTING — integer fixed-point vs. the former sprintf calls
+// ============================================================================
+static void sprintfValue(char * val, unsigned char type, unsigned short value) {
+    switch (type) {
+        case et_dec_val:  sprintf(val, "%.1f", ((double)((signed short)value)) / 10.0); break;
+        case et_cent_val: sprintf(val, "%.2f", ((double)((signed short)value)) / 100.0); break;
+        case et_mil_val:  sprintf(val, "%.3f", ((double)((signed short)value)) / 1000.0); break;
+        default:          sprintf(val, "%d", (signed short)value); break;
+    }
+}
+
+TEST_CASE("SetValueType: fixed-point vs sprintf", "[bench]") {
+    const std::vector<unsigned short> frames = frameIndexes();
+    const unsigned char types[] = { et_dec_val, et_default, et_cent_val, et_mil_val };
+
+    BENCHMARK("sprintf") {
+        char val[cElsterValueSize];
+        unsigned sum = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            sprintfValue(val, types[i & 3], frames[i]);
+            sum += (unsigned char) val[0];
+        }
+        return sum;
+    };
+
+    BENCHMARK("SetValueType") {
+        char val[cElsterValueSize];
+        unsigned sum = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            SetValueType(val, types[i & 3], frames[i]);
+            sum += (unsigned char) val[0];
+        }
+        return sum;
+    };
+}
+
+// ============================================================================
+// ENUM-LIKE TYPES — error numbers, Betriebsart, bools and type names
+// ============================================================================
+// The linear scans SetValueType, TranslateString and GetElsterType used
+// before the sorted and indexed tables, for comparison.
+static void scanErrorName(char * val, unsigned short value) {
+    for (const ErrorIndex & err : ErrorList)
+        if (err.Index == value) {
+            strcpy(val, err.Name);
+            return;
+        }
+    sprintf(val, "ERR %d", value);
+}
+
+static int scanBetriebsart(const char * & str) {
+    int s = High(BetriebsartList);
+    for ( ; s >= 0; s--)
+        if (!strncmp(BetriebsartList[s].Name, str, strlen(BetriebsartList[s].Name)))
+            break;
+    if (s < 0)
+        return -1;
+    str += strlen(BetriebsartList[s].Name);
+    return BetriebsartList[s].Index;
+}
+
+static ElsterType scanElsterType(const char * str) {
+    for (unsigned i = 0; i <= High(ElsterTypeStr); i++)
+        if (!strcmp(ElsterTypeStr[i], str))
+            return (ElsterType) i;
+    return et_default;
+}
+
+TEST_CASE("Enum types: decode and encode, scans vs tables", "[bench]") {
+    std::vector<const char *> modes;
+    for (const ErrorIndex & b : BetriebsartList)
+        modes.push_back(b.Name);
+    modes.push_back("Unbekannt");
+
+    std::vector<const char *> types(std::begin(ElsterTypeStr), std::end(ElsterTypeStr));
+    types.push_back("et_unknown");
+
+    BENCHMARK("et_err_nr decode, scan") {
+        char val[cElsterValueSize];
+        unsigned sum = 0;
+        for (const ErrorIndex & err : ErrorList) {
+            scanErrorName(val, err.Index);
+            sum += (unsigned char) val[0];
+        }
+        return sum;
+    };
+    BENCHMARK("et_err_nr decode, SetValueType") {
+        char val[cElsterValueSize];
+        unsigned sum = 0;
+        for (const ErrorIndex & err : ErrorList) {
+            SetValueType(val, et_err_nr, err.Index);
+            sum += (unsigned char) val[0];
+        }
+        return sum;
+    };
+
+    BENCHMARK("et_betriebsart / et_bool / et_little_bool decode, SetValueType") {
+        char val[cElsterValueSize];
+        unsigned sum = 0;
+        for (unsigned short v = 0; v < 0x0700; v += 0x0100) {
+            SetValueType(val, et_betriebsart, v);
+            sum += (unsigned char) val[0];
+            SetValueType(val, et_bool, v >> 8);
+            sum += (unsigned char) val[0];
+            SetValueType(val, et_little_bool, v);
+            sum += (unsigned char) val[0];
+        }
+        return sum;
+    };
+
+    BENCHMARK("et_betriebsart encode, scan") {
+        int sum = 0;
+        for (const char * name : modes) {
+            const char * s = name;
+            sum += scanBetriebsart(s);
+        }
+        return sum;
+    };
+    BENCHMARK("et_betriebsart encode, TranslateString") {
+        int sum = 0;
+        for (const char * name : modes) {
+            const char * s = name;
+            sum += TranslateString(s, et_betriebsart);
+        }
+        return sum;
+    };
+
+    BENCHMARK("et_bool / et_little_bool encode, TranslateString") {
+        int sum = 0;
+        for (const char * name : {"on", "off", "?"}) {
+            const char * s = name;
+            sum += TranslateString(s, et_bool);
+            s = name;
+            sum += TranslateString(s, et_little_bool);
+        }
+        return sum;
+    };
+
+    BENCHMARK("type names, scan") {
+        unsigned sum = 0;
+        for (const char * name : types)
+            sum += scanElsterType(name);
+        return sum;
+    };
+    BENCHMARK("type names, GetElsterType") {
+        unsigned sum = 0;
+        for (const char * name : types)
+            sum += GetElsterType(name);
+        return sum;
+    };
+    BENCHMARK("type names, ElsterTypeToName") {
+        unsigned sum = 0;
+        for (unsigned t = 0; t <= High(ElsterTypeStr) + 1; t++)
+            sum += (unsigned char) ElsterTypeToName(t)[3];
+        return sum;
+    };
+}
+
+// ============================================================================
+// LOOKUPS AND ENCODING — GetElsterIndex by index and by name, TranslateString
+// ============================================================================
+TEST_CASE("GetElsterIndex and TranslateString", "[bench]") {
+    const std::vector<unsigned short> frames = frameIndexes();
+    std::vector<const char *> names;
+    for (unsigned short index : frames)
+        names.push_back(GetElsterIndex(index)->Name);
+
+    BENCHMARK("GetElsterIndex(unsigned short)") {
+        unsigned sum = 0;
+        for (unsigned short index : frames)
+            sum += GetElsterIndex(index)->Type;
+        return sum;
+    };
+
+    BENCHMARK("GetElsterIndex(const char *)") {
+        unsigned sum = 0;
+        for (const char * name : names)
+            sum += GetElsterIndex(name)->Index;
+        return sum;
+    };
+
+    // Inputs as they arrive on the MQTT command topics of writable signals
+    static const struct { const char * text; unsigned char type; } inputs[] = {
+        { "21.5", et_dec_val }, { "-3.0", et_dec_val }, { "1.25", et_cent_val },
+        { "0.125", et_mil_val }, { "42", et_default }, { "7", et_byte },
+        { "on", et_bool }, { "off", et_little_bool }, { "Automatik", et_betriebsart },
+        { "14:30", et_zeit }, { "15.06.", et_datum }, { "06:00-22:00", et_time_domain },
+    };
+
+    BENCHMARK("TranslateString") {
+        int sum = 0;
+        for (const auto & in : inputs) {
+            const char * s = in.text;
+            sum += TranslateString(s, in.type);
+        }
+        return sum;
+    };
+}
@@ -10,6 +10,8 @@
 #pragma once
 #include <cstdio>
 #include <cstdint>
+#include <cstring>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -28,14 +30,22 @@
 
 // ── Arduino / FreeRTOS / ESP-IDF ─────────────────────────────────────────────
 inline void delay(uint32_t) {}
-inline unsigned long millis() { return 0; }
+// millis() reads a settable fake clock; it stays at 0 unless a test advances it.
+inline unsigned long& fake_millis() { static unsigned long t = 0; return t; }
+inline unsigned long millis() { return fake_millis(); }
 inline uint32_t esp_random() { return 42; }
 
 // ── CAN bus stub ─────────────────────────────────────────────────────────────
 struct FakeCanBus {
     std::vector<std::vector<uint8_t>> sent;
-    void send_data(uint32_t /*id*/, bool /*ext*/, const std::vector<uint8_t>& data) {
-        sent.push_back(data);
+    uint32_t lastId = 0;
+    size_t sendCount = 0;
+    bool record = true;     // benchmarks turn this off to keep send_data allocation-free
+    void send_data(uint32_t id, bool /*ext*/, const std::vector<uint8_t>& data) {
+        if (record)
+            sent.push_back(data);
+        lastId = id;
+        sendCount++;
     }
 };
 inline FakeCanBus& fake_can() { static FakeCanBus b; return b; }
@@ -49,9 +59,13 @@ inline FakeCanBus& fake_can() { static FakeCanBus b; return b; }
 struct FakeMqttClient {
     struct Published { std::string topic; std::string payload; };
     std::vector<Published> messages;
+    size_t publishCount = 0;
+    bool record = true;     // benchmarks turn this off to keep publish allocation-free
     // Overloads for const char* and std::string topics (ha-stiebel-control.h uses both)
     void publish(const char* topic, const char* payload, size_t /*len*/, int /*qos*/, bool /*retain*/) {
-        messages.push_back({topic, payload ? payload : ""});
+        if (record)
+            messages.push_back({topic, payload ? payload : ""});
+        publishCount++;
     }
     void publish(const std::string& topic, const char* payload, size_t len, int qos, bool retain) {
         publish(topic.c_str(), payload, len, qos, retain);
@@ -62,16 +76,29 @@ inline FakeMqttClient& mqtt_client_instance() { static FakeMqttClient c; return
 #define mqtt_client mqtt_client_instance()
 
 // ── NVS / Preferences stub ───────────────────────────────────────────────────
-// ESPPreferenceObject is only needed by EspHomeSgReadyIO which we don't test here.
-// Defined as a no-op struct so the header compiles.
+// Preferences are kept per key in fake_nvs() as raw bytes, so a value saved
+// before a simulated reboot can be loaded again. Clear fake_nvs() to wipe it.
+inline std::map<uint32_t, std::vector<uint8_t>>& fake_nvs() {
+    static std::map<uint32_t, std::vector<uint8_t>> nvs; return nvs;
+}
 struct ESPPreferenceObject {
-    template<typename T> bool save(T*) { return true; }
-    template<typename T> bool load(T*) { return false; }
+    uint32_t key = 0;
+    template<typename T> bool save(T* value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(value);
+        fake_nvs()[key].assign(bytes, bytes + sizeof(T));
+        return true;
+    }
+    template<typename T> bool load(T* value) {
+        auto it = fake_nvs().find(key);
+        if (it == fake_nvs().end() || it->second.size() != sizeof(T)) return false;
+        memcpy(value, it->second.data(), sizeof(T));
+        return true;
+    }
 };
 struct ESPPreferences {
     template<typename T>
-    ESPPreferenceObject make_preference(uint32_t /*key*/, bool /*flash*/) {
-        return {};
+    ESPPreferenceObject make_preference(uint32_t key, bool /*flash*/) {
+        return {key};
     }
 };
 inline ESPPreferences* global_preferences_instance() {
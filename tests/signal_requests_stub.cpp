@@ -12,6 +12,8 @@ struct SignalRequest {
     const char* signalName;
     unsigned long frequency;
     int member;
+    int pollGroup;
+    float deadband;
 };
 
 extern const SignalRequest signalRequests[] = {};
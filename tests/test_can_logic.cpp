@@ -74,6 +74,31 @@ TEST_CASE("lookupCanMember: HEIZMODUL (0x500)", "[can]") {
 TEST_CASE("lookupCanMember: unknown ID returns OTHER", "[can]") {
     CHECK(std::string(lookupCanMember(0x999).Name) == "OTHER");
 }
+TEST_CASE("lookupCanMember: direct-mapped table matches a linear scan for all IDs", "[can]") {
+    size_t mismatches = 0;
+    for (uint32_t canId = 0; canId < 0x1000; canId++) {
+        const CanMember* expected = &CanMembers[cm_other];
+        for (const CanMember& cm : CanMembers)
+            if (cm.CanId == canId) { expected = &cm; break; }
+        if (&lookupCanMember(canId) != expected)
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+    CHECK(&lookupCanMember(0x80000480) == &CanMembers[cm_other]);
+}
+TEST_CASE("CanMembers: entries carry their enum and precomputed read/write IDs", "[can]") {
+    for (unsigned i = 0; i < cCanMemberCount; i++) {
+        const CanMember& cm = CanMembers[i];
+        CHECK(cm.Member == (CanMemberType)i);
+        CHECK(cm.ReadId.first   == generate_read_id(cm.CanId).first);
+        CHECK(cm.ReadId.second  == generate_read_id(cm.CanId).second);
+        CHECK(cm.WriteId.first  == generate_write_id(cm.CanId).first);
+        CHECK(cm.WriteId.second == generate_write_id(cm.CanId).second);
+    }
+    CHECK(std::string(CanMembers[cm_kessel].FriendlyName) == "Kessel");
+    CHECK(std::string(CanMembers[cm_manager].FriendlyName) == "Manager");
+    CHECK(std::string(CanMembers[cm_atez].FriendlyName) == "ATEZ");
+}
 
 // ============================================================================
 // getTypeDefaults
@@ -153,25 +178,33 @@ TEST_CASE("getTypeDefaults: unknown type → gauge sensor fallback", "[can]") {
 // processCanMessage
 // ============================================================================
 
-// Helper: build a standard 7-byte frame with single-byte index
-static std::vector<uint8_t> makeFrame(uint8_t readId1, uint8_t readId2,
-                                       uint8_t elsterIdx,
-                                       uint8_t byte1, uint8_t byte2) {
-    return {readId1, readId2, elsterIdx, byte1, byte2, 0x00, 0x00};
+// Helper: build a standard 7-byte frame with single-byte index, sent by MANAGER
+static ElsterFrame makeFrame(uint8_t readId1, uint8_t readId2,
+                             uint8_t elsterIdx,
+                             uint8_t byte1, uint8_t byte2) {
+    return {0x480, 7, {readId1, readId2, elsterIdx, byte1, byte2, 0x00, 0x00}};
+}
+
+// Helper: build a 7-byte frame with 0xFA extended index, sent by MANAGER
+static ElsterFrame makeFrameFA(uint8_t readId1, uint8_t readId2,
+                               uint8_t idxHi, uint8_t idxLo,
+                               uint8_t byte1, uint8_t byte2) {
+    return {0x480, 7, {readId1, readId2, 0xFA, idxHi, idxLo, byte1, byte2}};
 }
 
-// Helper: build a 7-byte frame with 0xFA extended index
-static std::vector<uint8_t> makeFrameFA(uint8_t readId1, uint8_t readId2,
-                                         uint8_t idxHi, uint8_t idxLo,
-                                         uint8_t byte1, uint8_t byte2) {
-    return {readId1, readId2, 0xFA, idxHi, idxLo, byte1, byte2};
+// Helper: the decoded value of a raw 16-bit frame value of signal ei
+static ElsterValue decoded(const ElsterIndex* ei, unsigned short raw) {
+    ElsterValue v;
+    DecodeElsterValue(v, ei->Type, raw);
+    return v;
 }
 
 TEST_CASE("processCanMessage: too short returns ElsterTable[0]", "[can]") {
-    std::vector<uint8_t> msg = {0x01, 0x02, 0x03};
-    std::string val;
+    const uint8_t data[] = {0x01, 0x02, 0x03};
+    ElsterFrame msg = makeElsterFrame(0x480, data, sizeof(data));
+    ElsterValue val;
     const CanMember* cm = nullptr;
-    const ElsterIndex* ei = processCanMessage(msg, 0x480, val, &cm);
+    const ElsterIndex* ei = processCanMessage(msg, val, &cm);
     CHECK(ei == &ElsterTable[0]);
 }
 
@@ -183,13 +216,16 @@ TEST_CASE("processCanMessage: identifies MANAGER CAN member and decodes et_dec_v
     uint8_t idx = (uint8_t)(hs->Index & 0xFF); // 0x22
     auto msg = makeFrame(0x91, 0x00, idx, 0x00, 0xC8); // 200 = 20.0
 
-    std::string val;
+    ElsterValue val;
     const CanMember* cm = nullptr;
-    const ElsterIndex* ei = processCanMessage(msg, 0x480, val, &cm);
+    const ElsterIndex* ei = processCanMessage(msg, val, &cm);
 
     CHECK(std::string(cm->Name) == "MANAGER");
     CHECK(std::string(ei->Name) == "HYSTERESEZEIT");
-    CHECK(val == "20.0");
+    CHECK(val.Raw == 200);
+    CHECK(val.Fixed == 200);
+    CHECK(val.Decimals == 1);
+    CHECK(std::string(ElsterValueText(val)) == "20.0");
 }
 
 TEST_CASE("processCanMessage: FA extended index frame", "[can]") {
@@ -197,7 +233,7 @@ TEST_CASE("processCanMessage: FA extended index frame", "[can]") {
     // be single-byte path. Use UHRZEIT (0x0009). For FA path we need index > 0xFF.
     // Scan for any signal with Index > 0xFF
     const ElsterIndex* ei_test = nullptr;
-    for (int i = 1; i <= (int)(sizeof(ElsterTable)/sizeof(ElsterTable[0]) - 1); i++) {
+    for (int i = 1; i < (int)ElsterTableCount; i++) {
         if (ElsterTable[i].Index > 0xFF && !ElsterTable[i].isBlacklisted) {
             ei_test = &ElsterTable[i];
             break;
@@ -209,9 +245,9 @@ TEST_CASE("processCanMessage: FA extended index frame", "[can]") {
     uint8_t idxLo = (uint8_t)(ei_test->Index & 0xFF);
     auto msg = makeFrameFA(0x91, 0x00, idxHi, idxLo, 0x00, 0x01);
 
-    std::string val;
+    ElsterValue val;
     const CanMember* cm = nullptr;
-    const ElsterIndex* ei = processCanMessage(msg, 0x480, val, &cm);
+    const ElsterIndex* ei = processCanMessage(msg, val, &cm);
 
     // Compare by name, not pointer — ElsterTable is static per-TU so pointers differ
     CHECK(std::string(ei->Name) == std::string(ei_test->Name));
@@ -222,7 +258,7 @@ TEST_CASE("processCanMessage: et_bool signal value 1 → 'on'", "[can]") {
     // UHRZEIT index 0x0009, et_zeit — use any et_bool signal instead
     // Scan for a non-blacklisted et_bool signal
     const ElsterIndex* boolEi = nullptr;
-    for (int i = 1; i <= (int)(sizeof(ElsterTable)/sizeof(ElsterTable[0]) - 1); i++) {
+    for (int i = 1; i < (int)ElsterTableCount; i++) {
         if ((ElsterTable[i].Type == et_bool || ElsterTable[i].Type == et_little_bool)
                 && !ElsterTable[i].isBlacklisted
                 && ElsterTable[i].Index <= 0xFF) {
@@ -233,32 +269,90 @@ TEST_CASE("processCanMessage: et_bool signal value 1 → 'on'", "[can]") {
     if (!boolEi) SKIP("No non-blacklisted et_bool signal with single-byte index found");
 
     auto msg = makeFrame(0x91, 0x00, (uint8_t)boolEi->Index, 0x00, 0x01);
-    std::string val;
+    ElsterValue val;
     const CanMember* cm = nullptr;
-    processCanMessage(msg, 0x480, val, &cm);
-    CHECK((val == "on" || val == "off" || val == "?"));
+    processCanMessage(msg, val, &cm);
+    std::string text = ElsterValueText(val);
+    CHECK((text == "on" || text == "off" || text == "?"));
+    CHECK(val.hasNumber == (text != "?"));
 }
 
 // ============================================================================
-// getOrCreateUID
+// ElsterFrame: makeElsterFrame / buildElsterFrame / readSignal
 // ============================================================================
 
-TEST_CASE("getOrCreateUID: generates lowercase uid", "[can]") {
-    const CanMember& cm = CanMembers[cm_manager];
-    std::string uid = getOrCreateUID(cm, "HYSTERESEZEIT");
-    CHECK(uid == "stiebel_manager_hysteresezeit");
+TEST_CASE("makeElsterFrame: copies payload and caps DLC at 8", "[can]") {
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ElsterFrame f = makeElsterFrame(0x180, data, sizeof(data));
+    CHECK(f.canId == 0x180);
+    CHECK(f.dlc == 8);
+    CHECK(f.data[7] == 8);
 }
-TEST_CASE("getOrCreateUID: cached result equals first result", "[can]") {
+
+TEST_CASE("buildElsterFrame: single-byte index", "[can]") {
+    ElsterFrame f = buildElsterFrame(generate_write_id(0x480), 0x0022, 0x00C8);
+    const uint8_t expected[] = {0x90, 0x00, 0x22, 0x00, 0xC8, 0x00, 0x00};
+    CHECK(f.canId == 0x680);
+    CHECK(f.dlc == 7);
+    CHECK(std::equal(expected, expected + 7, f.data));
+}
+
+TEST_CASE("buildElsterFrame: 0xFA extended index", "[can]") {
+    ElsterFrame f = buildElsterFrame(generate_read_id(0x180), 0x01d6, 0);
+    const uint8_t expected[] = {0x31, 0x00, 0xFA, 0x01, 0xD6, 0x00, 0x00};
+    CHECK(f.dlc == 7);
+    CHECK(std::equal(expected, expected + 7, f.data));
+}
+
+TEST_CASE("readSignal: sends the request frame from the PC address", "[can]") {
+    fake_can().sent.clear();
+    readSignal(&CanMembers[cm_kessel], "WPVORLAUFIST");
+    REQUIRE(fake_can().sent.size() == 1);
+    CHECK(fake_can().lastId == 0x680);
+    CHECK(fake_can().sent[0] == std::vector<uint8_t>({0x31, 0x00, 0xFA, 0x01, 0xD6, 0x00, 0x00}));
+}
+
+// ============================================================================
+// signalEntity
+// ============================================================================
+
+TEST_CASE("signalEntity: interns lowercase uid, state and discovery topic", "[can]") {
+    const SignalEntity* e = signalEntity(CanMembers[cm_manager], GetElsterIndex("HYSTERESEZEIT"));
+    REQUIRE(e != nullptr);
+    CHECK(std::string(e->uid) == "stiebel_manager_hysteresezeit");
+    CHECK(std::string(e->stateTopic) == "heatingpump/MANAGER/HYSTERESEZEIT/state");
+    CHECK(std::string(e->discoveryTopic) == "homeassistant/sensor/heatingpump/stiebel_manager_hysteresezeit/config");
+}
+TEST_CASE("signalEntity: a second call returns the same entity without allocating", "[can]") {
     const CanMember& cm = CanMembers[cm_kessel];
-    std::string a = getOrCreateUID(cm, "HYSTERESEZEIT");
-    std::string b = getOrCreateUID(cm, "HYSTERESEZEIT");
+    const ElsterIndex* ei = GetElsterIndex("HYSTERESEZEIT");
+    const SignalEntity* a = signalEntity(cm, ei);
+    const size_t entities = signalEntities.size();
+    const size_t names = signalNames.size();
+    const SignalEntity* b = signalEntity(cm, ei);
     CHECK(a == b);
+    CHECK(signalEntities.size() == entities);
+    CHECK(signalNames.size() == names);
 }
-TEST_CASE("getOrCreateUID: different members produce different UIDs", "[can]") {
-    std::string a = getOrCreateUID(CanMembers[cm_manager], "HYSTERESEZEIT");
-    std::string b = getOrCreateUID(CanMembers[cm_kessel],  "HYSTERESEZEIT");
+TEST_CASE("signalEntity: different members produce different UIDs", "[can]") {
+    const ElsterIndex* ei = GetElsterIndex("HYSTERESEZEIT");
+    std::string a = signalEntity(CanMembers[cm_manager], ei)->uid;
+    std::string b = signalEntity(CanMembers[cm_kessel], ei)->uid;
     CHECK(a != b);
 }
+TEST_CASE("signalEntity: names stay valid while later entities are added", "[can]") {
+    const SignalEntity* first = signalEntity(CanMembers[cm_heizmodul], GetElsterIndex("AUSSENTEMP"));
+    REQUIRE(first != nullptr);
+    const char* uid = first->uid;
+    for (unsigned row = 1; row < ElsterTableCount && row < 200; row++)
+        signalEntity(CanMembers[cm_heizmodul], &ElsterTable[row]);
+    CHECK(std::string(uid) == "stiebel_heizmodul_aussentemp");
+    CHECK(signalEntity(CanMembers[cm_heizmodul], GetElsterIndex("AUSSENTEMP"))->uid == uid);
+}
+TEST_CASE("signalEntity: a signal outside ElsterTable has no entity", "[can]") {
+    ElsterIndex unlisted = ElsterTable[0];
+    CHECK(signalEntity(CanMembers[cm_manager], &unlisted) == nullptr);
+}
 
 // ============================================================================
 // hash / hash_runtime
@@ -293,21 +387,30 @@ TEST_CASE("hash: empty string does not crash", "[can]") {
 // storeCOPEnergyValue
 // ============================================================================
 
+// Helper: store a COP input as decoded from a frame of the given type
+static void storeCOP(CopEnergyId id, unsigned char type, unsigned short raw) {
+    ElsterValue v;
+    DecodeElsterValue(v, type, raw);
+    storeCOPEnergyValue(id, v);
+}
+
 TEST_CASE("storeCOPEnergyValue: valid numeric accepted", "[can]") {
-    // Reset the map by calling with fresh values
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", "1.234");
-    // If it doesn't crash and accepts the value, we're good.
-    // updateCOPCalculations relies on map state; tested below.
-    CHECK(true);
+    storeCOP(ce_el_ww, et_mil_val, 1234);
+    CHECK(copEnergyValues[ce_el_ww] == Catch::Approx(1.234f));
 }
-TEST_CASE("storeCOPEnergyValue: empty string ignored (no crash)", "[can]") {
-    CHECK_NOTHROW(storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", ""));
+TEST_CASE("storeCOPEnergyValue: value without a number ignored", "[can]") {
+    copEnergyValid[ce_el_ww] = false;
+    storeCOP(ce_el_ww, et_zeit, 0x1e0e);
+    storeCOP(ce_el_ww, et_dev_nr, 0x80);
+    CHECK_FALSE(copEnergyValid[ce_el_ww]);
 }
-TEST_CASE("storeCOPEnergyValue: non-numeric string ignored (no crash)", "[can]") {
-    CHECK_NOTHROW(storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", "abc"));
+TEST_CASE("storeCOPEnergyValue: et_double_val raw value stored", "[can]") {
+    storeCOP(ce_el_ww, et_double_val, 40000);
+    CHECK(copEnergyValues[ce_el_ww] == 40000.0f);
 }
 TEST_CASE("storeCOPEnergyValue: negative value accepted", "[can]") {
-    CHECK_NOTHROW(storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", "-1.0"));
+    storeCOP(ce_el_ww, et_dec_val, (unsigned short)(short)(-10));
+    CHECK(copEnergyValues[ce_el_ww] == Catch::Approx(-1.0f));
 }
 
 // ============================================================================
@@ -317,9 +420,9 @@ TEST_CASE("storeCOPEnergyValue: negative value accepted", "[can]") {
 TEST_CASE("updateCOPCalculations: publishes cop_ww when all WW values present", "[can]") {
     mqtt_client_instance().clear();
 
-    storeCOPEnergyValue("WAERMEERTRAG_WW_SUM_MWH",      "3.0");
-    storeCOPEnergyValue("WAERMEERTRAG_2WE_WW_SUM_MWH",  "1.0");
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", "2.0");
+    storeCOP(ce_waerme_ww, et_double_val, 3);
+    storeCOP(ce_waerme_2we_ww, et_double_val, 1);
+    storeCOP(ce_el_ww, et_double_val, 2);
     updateCOPCalculations();
 
     bool found = false;
@@ -329,9 +432,9 @@ TEST_CASE("updateCOPCalculations: publishes cop_ww when all WW values present",
 }
 TEST_CASE("updateCOPCalculations: cop_ww value = (3+1)/2 = 2.00", "[can]") {
     mqtt_client_instance().clear();
-    storeCOPEnergyValue("WAERMEERTRAG_WW_SUM_MWH",       "3.0");
-    storeCOPEnergyValue("WAERMEERTRAG_2WE_WW_SUM_MWH",   "1.0");
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", "2.0");
+    storeCOP(ce_waerme_ww, et_double_val, 3);
+    storeCOP(ce_waerme_2we_ww, et_double_val, 1);
+    storeCOP(ce_el_ww, et_double_val, 2);
     updateCOPCalculations();
 
     for (auto& m : mqtt_client_instance().messages)
@@ -340,9 +443,9 @@ TEST_CASE("updateCOPCalculations: cop_ww value = (3+1)/2 = 2.00", "[can]") {
 }
 TEST_CASE("updateCOPCalculations: skips cop_ww when el divisor is 0", "[can]") {
     mqtt_client_instance().clear();
-    storeCOPEnergyValue("WAERMEERTRAG_WW_SUM_MWH",       "3.0");
-    storeCOPEnergyValue("WAERMEERTRAG_2WE_WW_SUM_MWH",   "1.0");
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH", "0.0");
+    storeCOP(ce_waerme_ww, et_double_val, 3);
+    storeCOP(ce_waerme_2we_ww, et_double_val, 1);
+    storeCOP(ce_el_ww, et_double_val, 0);
     updateCOPCalculations();
 
     for (auto& m : mqtt_client_instance().messages)
@@ -350,9 +453,9 @@ TEST_CASE("updateCOPCalculations: skips cop_ww when el divisor is 0", "[can]") {
 }
 TEST_CASE("updateCOPCalculations: publishes cop_heiz when all Heiz values present", "[can]") {
     mqtt_client_instance().clear();
-    storeCOPEnergyValue("WAERMEERTRAG_HEIZ_SUM_MWH",       "6.0");
-    storeCOPEnergyValue("WAERMEERTRAG_2WE_HEIZ_SUM_MWH",   "0.0");
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH", "2.0");
+    storeCOP(ce_waerme_heiz, et_double_val, 6);
+    storeCOP(ce_waerme_2we_heiz, et_double_val, 0);
+    storeCOP(ce_el_heiz, et_double_val, 2);
     updateCOPCalculations();
 
     bool found = false;
@@ -362,12 +465,12 @@ TEST_CASE("updateCOPCalculations: publishes cop_heiz when all Heiz values presen
 }
 TEST_CASE("updateCOPCalculations: publishes cop_gesamt when all values present", "[can]") {
     mqtt_client_instance().clear();
-    storeCOPEnergyValue("WAERMEERTRAG_WW_SUM_MWH",          "3.0");
-    storeCOPEnergyValue("WAERMEERTRAG_2WE_WW_SUM_MWH",      "1.0");
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_WW_SUM_MWH",   "2.0");
-    storeCOPEnergyValue("WAERMEERTRAG_HEIZ_SUM_MWH",        "6.0");
-    storeCOPEnergyValue("WAERMEERTRAG_2WE_HEIZ_SUM_MWH",    "0.0");
-    storeCOPEnergyValue("EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH", "2.0");
+    storeCOP(ce_waerme_ww, et_double_val, 3);
+    storeCOP(ce_waerme_2we_ww, et_double_val, 1);
+    storeCOP(ce_el_ww, et_double_val, 2);
+    storeCOP(ce_waerme_heiz, et_double_val, 6);
+    storeCOP(ce_waerme_2we_heiz, et_double_val, 0);
+    storeCOP(ce_el_heiz, et_double_val, 2);
     updateCOPCalculations();
 
     bool found = false;
@@ -404,10 +507,13 @@ static bool mqttTopicPublished(const std::string& topicSubstr) {
 }
 
 static void resetDiscoveryState() {
-    discoveredSignals.clear();
-    discoveredCalculatedSensors.clear();
-    discoveredWritableNumbers.clear();
-    discoveredWritableSelects.clear();
+    std::fill(discoveredSignals.begin(), discoveredSignals.end(), false);
+    discoveredCalculatedSensors.reset();
+    discoveredWritableNumbers.reset();
+    discoveredWritableSelects.reset();
+    copDiscoveryPublished = false;
+    discoveryRepublish = DiscoveryRepublish();
+    forgetPublishedStates();
     mqtt_client_instance().clear();
 }
 
@@ -467,6 +573,15 @@ TEST_CASE("publishMqttDiscovery: payload contains name, unique_id, state_topic",
     CHECK(payload.find("heatingpump/MANAGER/AUSSENTEMP/state") != std::string::npos);
 }
 
+TEST_CASE("publishMqttDiscovery: device name is the member's friendly name", "[mqtt]") {
+    resetDiscoveryState();
+    const ElsterIndex* ei = GetElsterIndex("AUSSENTEMP");
+    REQUIRE(ei != nullptr);
+    publishMqttDiscovery(CanMembers[cm_manager], ei);
+    std::string payload = mqttFindPayload("stiebel_manager_aussentemp");
+    CHECK(payload.find("\"identifiers\":[\"stiebel_MANAGER\"],\"name\":\"Manager\"") != std::string::npos);
+}
+
 TEST_CASE("publishMqttDiscovery: temperature signal has device_class temperature", "[mqtt]") {
     resetDiscoveryState();
     const CanMember& mgr = CanMembers[cm_manager];
@@ -551,7 +666,8 @@ TEST_CASE("updateSensor: publishes discovery and state on first call", "[mqtt]")
     const CanMember& mgr = CanMembers[cm_manager];
     const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
     REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "30.5");
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(mgr, ei, v);
     CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/"));
     CHECK(mqttTopicPublished("heatingpump/MANAGER/RUECKLAUFISTTEMP/state"));
     CHECK(mqttFindPayload("RUECKLAUFISTTEMP/state") == "30.5");
@@ -562,19 +678,129 @@ TEST_CASE("updateSensor: skips discovery on second call (cached)", "[mqtt]") {
     const CanMember& mgr = CanMembers[cm_manager];
     const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
     REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "30.5");
+    ElsterValue first = decoded(ei, 305);
+    updateSensor(mgr, ei, first);
     mqtt_client_instance().clear();
-    updateSensor(mgr, ei, "31.0");
+    ElsterValue second = decoded(ei, 310);
+    updateSensor(mgr, ei, second);
     CHECK(mqtt_client_instance().messages.size() == 1);
     CHECK(mqttFindPayload("RUECKLAUFISTTEMP/state") == "31.0");
 }
 
+TEST_CASE("updateSensor: discovery is published again by republishAllDiscoveries", "[mqtt]") {
+    resetDiscoveryState();
+    const CanMember& mgr = CanMembers[cm_manager];
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(mgr, ei, v);
+    REQUIRE(discoveredSignals[signalEntityKey(mgr, ei)]);
+
+    mqtt_client_instance().clear();
+    republishAllDiscoveries();
+    CHECK_FALSE(mqttTopicPublished("stiebel_manager_ruecklaufisttemp/config"));
+    runDiscoveryRepublish(fake_millis());
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_manager_ruecklaufisttemp/config"));
+    CHECK(discoveredSignals[signalEntityKey(mgr, ei)]);
+}
+
+TEST_CASE("updateSensor: discovery of a signal is tracked per member", "[mqtt]") {
+    resetDiscoveryState();
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(CanMembers[cm_manager], ei, v);
+    mqtt_client_instance().clear();
+    updateSensor(CanMembers[cm_kessel], ei, v);
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_kessel_ruecklaufisttemp/config"));
+    CHECK(discoveredSignals[signalEntityKey(CanMembers[cm_manager], ei)]);
+    CHECK(discoveredSignals[signalEntityKey(CanMembers[cm_kessel], ei)]);
+}
+
+TEST_CASE("updateSensor: an unchanged value is not published again", "[mqtt]") {
+    resetDiscoveryState();
+    const CanMember& mgr = CanMembers[cm_manager];
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(mgr, ei, v);
+    const uint32_t suppressed = stateFilter.suppressedUnchanged();
+    mqtt_client_instance().clear();
+    updateSensor(mgr, ei, v);
+    CHECK_FALSE(mqttTopicPublished("RUECKLAUFISTTEMP/state"));
+    CHECK(stateFilter.suppressedUnchanged() == suppressed + 1);
+}
+
+TEST_CASE("updateSensor: temperatures move by more than 0.1 K before they are published", "[mqtt]") {
+    resetDiscoveryState();
+    const CanMember& mgr = CanMembers[cm_manager];
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    REQUIRE(signalEntity(mgr, ei)->deadband == Catch::Approx(STATE_DEADBAND_TEMPERATURE));
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(mgr, ei, v);
+    mqtt_client_instance().clear();
+    ElsterValue jitter = decoded(ei, 306);
+    updateSensor(mgr, ei, jitter);
+    CHECK_FALSE(mqttTopicPublished("RUECKLAUFISTTEMP/state"));
+    ElsterValue moved = decoded(ei, 307);
+    updateSensor(mgr, ei, moved);
+    CHECK(mqttFindPayload("RUECKLAUFISTTEMP/state") == "30.7");
+}
+
+TEST_CASE("updateSensor: a boolean is published on every change", "[mqtt]") {
+    resetDiscoveryState();
+    const CanMember& mgr = CanMembers[cm_manager];
+    const ElsterIndex* ei = GetElsterIndex("EVU_SPERRE_AKTIV");
+    REQUIRE(signalEntity(mgr, ei)->deadband == 0.0f);
+    ElsterValue off = decoded(ei, ei->Type == et_little_bool ? 0x0100 : 0x0001);
+    ElsterValue on = decoded(ei, 0);
+    updateSensor(mgr, ei, off);
+    mqtt_client_instance().clear();
+    updateSensor(mgr, ei, on);
+    CHECK(mqttFindPayload("EVU_SPERRE_AKTIV/state") == "on");
+}
+
+TEST_CASE("updateSensor: an unchanged value is published again after the heartbeat", "[mqtt]") {
+    resetDiscoveryState();
+    const CanMember& mgr = CanMembers[cm_manager];
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    ElsterValue v = decoded(ei, 305);
+    fake_millis() = 1000;
+    updateSensor(mgr, ei, v);
+    mqtt_client_instance().clear();
+    fake_millis() = 1000 + STATE_HEARTBEAT_INTERVAL * 1000UL;
+    updateSensor(mgr, ei, v);
+    CHECK(mqttFindPayload("RUECKLAUFISTTEMP/state") == "30.5");
+    fake_millis() = 0;
+}
+
+TEST_CASE("updateSensor: forgetPublishedStates publishes the next value again", "[mqtt]") {
+    resetDiscoveryState();
+    const CanMember& mgr = CanMembers[cm_manager];
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(mgr, ei, v);
+    forgetPublishedStates();
+    mqtt_client_instance().clear();
+    updateSensor(mgr, ei, v);
+    CHECK(mqttFindPayload("RUECKLAUFISTTEMP/state") == "30.5");
+}
+
+TEST_CASE("publishStateFilterStats: publishes the filter counters", "[mqtt]") {
+    resetDiscoveryState();
+    publishStateFilterStats();
+    const std::string stats = mqttFindPayload("heatingpump/state_filter/state");
+    CHECK(stats.find("\"published\":" + std::to_string(stateFilter.published())) != std::string::npos);
+    CHECK(stats.find("\"deadband\":" + std::to_string(stateFilter.suppressedDeadband())) != std::string::npos);
+    CHECK(mqttFindPayload("heatingpump/calculated/suppressed_states/state") == std::to_string(stateFilter.suppressed()));
+    CHECK(mqttTopicPublished("stiebel_calculated_suppressed_states/config"));
+}
+
 TEST_CASE("updateSensor: EVU_SPERRE_AKTIV inverts on → off", "[mqtt]") {
     resetDiscoveryState();
     const CanMember& mgr = CanMembers[cm_manager];
     const ElsterIndex* ei = GetElsterIndex("EVU_SPERRE_AKTIV");
     REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "on");
+    ElsterValue v = decoded(ei, ei->Type == et_little_bool ? 0x0100 : 0x0001);
+    REQUIRE(std::string(ElsterValueText(v)) == "on");
+    updateSensor(mgr, ei, v);
     CHECK(mqttFindPayload("EVU_SPERRE_AKTIV/state") == "off");
 }
 
@@ -583,16 +809,16 @@ TEST_CASE("updateSensor: EVU_SPERRE_AKTIV inverts off → on", "[mqtt]") {
     const CanMember& mgr = CanMembers[cm_manager];
     const ElsterIndex* ei = GetElsterIndex("EVU_SPERRE_AKTIV");
     REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "off");
+    ElsterValue v = decoded(ei, 0);
+    REQUIRE(std::string(ElsterValueText(v)) == "off");
+    updateSensor(mgr, ei, v);
     CHECK(mqttFindPayload("EVU_SPERRE_AKTIV/state") == "on");
 }
 
-TEST_CASE("updateSensor: skips empty value", "[mqtt]") {
+TEST_CASE("processAndUpdate: skips frame too short to carry a value", "[mqtt]") {
     resetDiscoveryState();
-    const CanMember& mgr = CanMembers[cm_manager];
-    const ElsterIndex* ei = GetElsterIndex("AUSSENTEMP");
-    REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "");
+    const uint8_t data[] = {0x91, 0x00, 0x0c};
+    processAndUpdate(makeElsterFrame(0x480, data, sizeof(data)));
     CHECK(mqtt_client_instance().messages.empty());
 }
 
@@ -602,7 +828,8 @@ TEST_CASE("updateSensor: JAHR value updates lastJahr global", "[mqtt]") {
     const CanMember& mgr = CanMembers[cm_manager];
     const ElsterIndex* ei = GetElsterIndex("JAHR");
     REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "26");
+    ElsterValue v = decoded(ei, 26 << 8);  // et_little_endian
+    updateSensor(mgr, ei, v);
     CHECK(lastJahr == 26);
 }
 
@@ -612,7 +839,8 @@ TEST_CASE("updateSensor: WPVORLAUFIST value updates lastWpVorlaufIst", "[mqtt]")
     const CanMember& heizmodul = CanMembers[cm_heizmodul];
     const ElsterIndex* ei = GetElsterIndex("WPVORLAUFIST");
     REQUIRE(ei != nullptr);
-    updateSensor(heizmodul, ei, "35.5");
+    ElsterValue v = decoded(ei, 355);
+    updateSensor(heizmodul, ei, v);
     CHECK(lastWpVorlaufIst == Approx(35.5f));
 }
 
@@ -622,7 +850,8 @@ TEST_CASE("updateSensor: RUECKLAUFISTTEMP value updates lastRuecklaufIstTemp", "
     const CanMember& mgr = CanMembers[cm_manager];
     const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
     REQUIRE(ei != nullptr);
-    updateSensor(mgr, ei, "28.3");
+    ElsterValue v = decoded(ei, 283);
+    updateSensor(mgr, ei, v);
     CHECK(lastRuecklaufIstTemp == Approx(28.3f));
 }
 
@@ -632,7 +861,8 @@ TEST_CASE("updateSensor: VERDICHTER value updates lastVerdichterValue", "[mqtt]"
     const CanMember& heizmodul = CanMembers[cm_heizmodul];
     const ElsterIndex* ei = GetElsterIndex("VERDICHTER");
     REQUIRE(ei != nullptr);
-    updateSensor(heizmodul, ei, "50.0");
+    ElsterValue v = decoded(ei, 500);
+    updateSensor(heizmodul, ei, v);
     CHECK(lastVerdichterValue == Approx(50.0f));
 }
 
@@ -720,13 +950,13 @@ TEST_CASE("publishTime: skips when minute out of range", "[calc]") {
 
 TEST_CASE("publishBetriebsart: on → Sommerbetrieb", "[calc]") {
     resetDiscoveryState();
-    publishBetriebsart("on");
+    publishBetriebsart(true);
     CHECK(mqttFindPayload("calculated/betriebsart/state") == "Sommerbetrieb");
 }
 
 TEST_CASE("publishBetriebsart: off → Normalbetrieb", "[calc]") {
     resetDiscoveryState();
-    publishBetriebsart("off");
+    publishBetriebsart(false);
     CHECK(mqttFindPayload("calculated/betriebsart/state") == "Normalbetrieb");
 }
 
@@ -865,10 +1095,7 @@ TEST_CASE("publishCalculatedSensorDiscovery: payload contains name and state_top
 
 TEST_CASE("publishCalculatedSensorDiscovery: cached — second call skips publish", "[mqtt]") {
     resetDiscoveryState();
-    CalculatedSensorConfig cfg{
-        "stiebel_cache_calc", "Cache Calc", "heatingpump/cache/state",
-        "sensor", "", "", "", "", "", "", "", true
-    };
+    const CalculatedSensorConfig& cfg = calculatedSensors[0];
     publishCalculatedSensorDiscovery(cfg);
     mqtt_client_instance().clear();
     publishCalculatedSensorDiscovery(cfg);
@@ -877,16 +1104,25 @@ TEST_CASE("publishCalculatedSensorDiscovery: cached — second call skips publis
 
 TEST_CASE("publishCalculatedSensorDiscovery: forceRepublish bypasses cache", "[mqtt]") {
     resetDiscoveryState();
-    CalculatedSensorConfig cfg{
-        "stiebel_force_calc", "Force Calc", "heatingpump/force/state",
-        "sensor", "", "", "", "", "", "", "", true
-    };
+    const CalculatedSensorConfig& cfg = calculatedSensors[0];
     publishCalculatedSensorDiscovery(cfg);
     mqtt_client_instance().clear();
     publishCalculatedSensorDiscovery(cfg, true);
     CHECK(!mqtt_client_instance().messages.empty());
 }
 
+TEST_CASE("publishCalculatedSensorDiscovery: a config outside calculatedSensors is published every time", "[mqtt]") {
+    resetDiscoveryState();
+    CalculatedSensorConfig cfg{
+        "stiebel_adhoc_calc", "Adhoc Calc", "heatingpump/adhoc/state",
+        "sensor", "", "", "", "", "", "", "", true
+    };
+    publishCalculatedSensorDiscovery(cfg);
+    publishCalculatedSensorDiscovery(cfg);
+    CHECK(mqtt_client_instance().messages.size() == 2);
+    CHECK(discoveredCalculatedSensors.none());
+}
+
 TEST_CASE("publishCalculatedSensorDiscovery: diagnostic entity has entity_category and enabled_by_default=false", "[mqtt]") {
     resetDiscoveryState();
     CalculatedSensorConfig cfg{
@@ -997,6 +1233,1041 @@ TEST_CASE("publishWritableSelectDiscovery: cached — second call skips publish"
     CHECK(mqtt_client_instance().messages.empty());
 }
 
+// ============================================================================
+// Discovery republish
+// ============================================================================
+
+static size_t discoveriesPublished() {
+    size_t n = 0;
+    for (const auto& m : mqtt_client_instance().messages)
+        n += m.topic.rfind("homeassistant/", 0) == 0;
+    return n;
+}
+
+// Run the republish every 100 ms from `now` until it is done; returns the end time
+static uint32_t runDiscoveryRepublishToEnd(uint32_t now) {
+    for (int i = 0; i < 10000 && discoveryRepublish.active; i++, now += 100)
+        runDiscoveryRepublish(now);
+    return now;
+}
+
+TEST_CASE("Discovery republish: publishes at most DISCOVERY_REPUBLISH_PER_SEC per second", "[mqtt]") {
+    resetDiscoveryState();
+    const uint32_t start = 50000;
+    fake_millis() = start;
+    republishAllDiscoveries("test");
+    CHECK(discoveriesPublished() == 0);
+
+    runDiscoveryRepublish(start);
+    CHECK(discoveriesPublished() == 1);
+    runDiscoveryRepublish(start + 100);
+    CHECK(discoveriesPublished() <= 2);
+    runDiscoveryRepublish(start + 1000);
+    CHECK(discoveriesPublished() == 1 + DISCOVERY_REPUBLISH_PER_SEC);
+    CHECK(discoveryRepublish.active);
+    fake_millis() = 0;
+}
+
+TEST_CASE("Discovery republish: covers every published entity once, then reports done", "[mqtt]") {
+    resetDiscoveryState();
+    const ElsterIndex* ei = GetElsterIndex("RUECKLAUFISTTEMP");
+    ElsterValue v = decoded(ei, 305);
+    updateSensor(CanMembers[cm_manager], ei, v);
+    updateSensor(CanMembers[cm_kessel], ei, v);
+    publishCalculatedSensorDiscovery(calculatedSensors[0]);
+    mqtt_client_instance().clear();
+
+    republishAllDiscoveries("test");
+    runDiscoveryRepublishToEnd(0);
+
+    const size_t expected = 3 + WRITABLE_NUMBER_COUNT + WRITABLE_SELECT_COUNT;
+    CHECK(discoveriesPublished() == expected);
+    CHECK(mqttTopicPublished("stiebel_manager_ruecklaufisttemp/config"));
+    CHECK(mqttTopicPublished("stiebel_kessel_ruecklaufisttemp/config"));
+    CHECK(mqttTopicPublished(std::string("heatingpump/") + calculatedSensors[0].uniqueId + "/config"));
+    CHECK_FALSE(mqttTopicPublished("cop_ww/config"));
+
+    const auto& last = mqtt_client_instance().messages.back();
+    CHECK(last.topic == "heatingpump/discovery_republish/state");
+    const std::string& done = last.payload;
+    CHECK(done.find("\"state\":\"done\"") != std::string::npos);
+    CHECK(done.find("\"sent\":" + std::to_string(expected)) != std::string::npos);
+}
+
+TEST_CASE("Discovery republish: COP sensors are republished once published", "[mqtt]") {
+    resetDiscoveryState();
+    publishCOPDiscovery();
+    mqtt_client_instance().clear();
+    republishAllDiscoveries("test");
+    runDiscoveryRepublishToEnd(0);
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/cop_ww/config"));
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/cop_gesamt/config"));
+}
+
+TEST_CASE("Discovery republish: reports progress while running", "[mqtt]") {
+    resetDiscoveryState();
+    republishAllDiscoveries("homeassistant");
+    std::string running = mqttFindPayload("discovery_republish/state");
+    CHECK(running.find("\"state\":\"running\"") != std::string::npos);
+    CHECK(running.find("\"reason\":\"homeassistant\"") != std::string::npos);
+
+    mqtt_client_instance().clear();
+    runDiscoveryRepublish(DISCOVERY_REPUBLISH_PROGRESS_MS - 1);
+    CHECK_FALSE(mqttTopicPublished("discovery_republish/state"));
+    runDiscoveryRepublish(DISCOVERY_REPUBLISH_PROGRESS_MS);
+    running = mqttFindPayload("discovery_republish/state");
+    CHECK(running.find("\"state\":\"running\"") != std::string::npos);
+    CHECK(running.find("\"position\":0") == std::string::npos);
+}
+
+TEST_CASE("Discovery republish: a new trigger starts the walk over", "[mqtt]") {
+    resetDiscoveryState();
+    republishAllDiscoveries("test");
+    runDiscoveryRepublish(0);
+    runDiscoveryRepublish(1000);
+    REQUIRE(discoveryRepublish.position > 0);
+
+    republishAllDiscoveries("interval");
+    CHECK(discoveryRepublish.active);
+    CHECK(discoveryRepublish.position == 0);
+    CHECK(discoveryRepublish.sent == 0);
+    mqtt_client_instance().clear();
+    runDiscoveryRepublishToEnd(0);
+    CHECK(discoveriesPublished() == WRITABLE_NUMBER_COUNT + WRITABLE_SELECT_COUNT);
+}
+
+// ============================================================================
+// buildRequestSlots / runRequestSlots
+// ============================================================================
+
+static const SignalRequest scheduleRequests[] = {
+    {"AUSSENTEMP",          FREQ_30S,   cm_manager},
+    {"DOES_NOT_EXIST_XYZ",  FREQ_30S,   cm_manager},
+    {"SPEICHERISTTEMP",     FREQ_1MIN,  cm_other},
+    {"VERDICHTER",          FREQ_10MIN, cm_heizmodul},
+};
+
+TEST_CASE("buildRequestSlots: resolves names once and expands cm_other into three slots", "[can]") {
+    buildRequestSlots(scheduleRequests, 4, 1000);
+    REQUIRE(requestSlots.size() == 5);
+    CHECK(requestSlots[0].ei == GetElsterIndex("AUSSENTEMP"));
+    CHECK(requestSlots[0].member == &CanMembers[cm_manager]);
+    CHECK(requestSlots[0].intervalMs == 30000);
+    CHECK(requestSlots[0].request == 0);
+    const CanMemberType expanded[] = {cm_kessel, cm_manager, cm_heizmodul};
+    for (size_t m = 0; m < 3; m++) {
+        CHECK(requestSlots[1 + m].ei == GetElsterIndex("SPEICHERISTTEMP"));
+        CHECK(requestSlots[1 + m].member == &CanMembers[expanded[m]]);
+        CHECK(requestSlots[1 + m].request == 2);
+    }
+    CHECK(requestSlots[4].member == &CanMembers[cm_heizmodul]);
+    for (const RequestSlot& slot : requestSlots) {
+        CHECK(slot.deadline >= 1000);
+        CHECK(slot.deadline <= 1000 + slot.intervalMs);
+    }
+}
+
+TEST_CASE("runRequestSlots: sends due slots and reschedules them by interval plus jitter", "[can]") {
+    // esp_random() stub returns 42: every first deadline is 5000 + 42
+    buildRequestSlots(scheduleRequests, 4, 5000);
+    fake_can().sent.clear();
+
+    CHECK(runRequestSlots(5041) == 0);
+    CHECK(fake_can().sent.empty());
+
+    // One frame per call while the inter-frame gap runs, equal deadlines in table order
+    CHECK(runRequestSlots(5042) == 1);
+    CHECK(runRequestSlots(5042) == 0);
+    REQUIRE(fake_can().sent.size() == 1);
+    CHECK(fake_can().sent[0][2] == GetElsterIndex("AUSSENTEMP")->Index);
+    CHECK(requestSlots[0].deadline == 5042 + 30000 + 42);  // jitter: 42 % 501
+
+    int sent = 1;
+    for (uint32_t now = 5042; now < 10000; now++)
+        sent += runRequestSlots(now);
+    CHECK(sent == 5);
+    for (const RequestSlot& slot : requestSlots)
+        CHECK(slot.deadline > 5042);
+}
+
+TEST_CASE("runRequestSlots: paces frames by budget and inter-frame gap", "[can]") {
+    // 20 slots due at once: the bucket starts with one frame, then refills at
+    // REQUEST_BUDGET_FRAMES_PER_SEC; no two frames closer than REQUEST_MIN_GAP_MS
+    std::vector<SignalRequest> many(20, SignalRequest{"AUSSENTEMP", FREQ_10MIN, cm_manager});
+    buildRequestSlots(many.data(), many.size(), 0);
+    fake_can().sent.clear();
+
+    std::vector<uint32_t> sentAt;
+    for (uint32_t now = 0; now < 3000; now++)
+        if (runRequestSlots(now) > 0)
+            sentAt.push_back(now);
+
+    REQUIRE(sentAt.size() >= 3);
+    uint32_t minGap = UINT32_MAX;
+    for (size_t i = 1; i < sentAt.size(); i++)
+        minGap = std::min(minGap, sentAt[i] - sentAt[i - 1]);
+    CHECK(minGap >= REQUEST_MIN_GAP_MS);
+    // once the bucket is drained, frames follow at the budget rate
+    for (size_t i = 2; i < sentAt.size(); i++)
+        CHECK(sentAt[i] - sentAt[i - 1] == 1000 / REQUEST_BUDGET_FRAMES_PER_SEC);
+    // ~3 s of budget after the first deadline at 42 ms
+    CHECK(sentAt.size() <= 1 + 3 * REQUEST_BUDGET_FRAMES_PER_SEC);
+    CHECK(sentAt.size() >= 2 * REQUEST_BUDGET_FRAMES_PER_SEC);
+}
+
+TEST_CASE("runRequestSlots: tracks the achieved request period per slot", "[can]") {
+    const SignalRequest one[] = {{"AUSSENTEMP", FREQ_30S, cm_manager}};
+    buildRequestSlots(one, 1, 0);
+    for (uint32_t now = 0; now < 200000; now += 100)
+        runRequestSlots(now);
+    // interval plus jitter (42 ms), rounded up to the 100 ms call grid
+    CHECK(requestSlots[0].achievedMs >= 30042);
+    CHECK(requestSlots[0].achievedMs <= 30100);
+}
+
+TEST_CASE("runRequestSlots: keeps polling across the millis() wraparound", "[can]") {
+    const uint32_t start = 0xFFFFFFFFu - 20000;
+    buildRequestSlots(scheduleRequests, 4, start);
+    fake_can().sent.clear();
+
+    // Two hours in 1 s ticks: AUSSENTEMP is due every 30 s on either side of the wrap
+    uint32_t now = start;
+    size_t aussentemp = 0;
+    for (int tick = 0; tick < 7200; tick++, now += 1000) {
+        size_t before = fake_can().sent.size();
+        runRequestSlots(now);
+        if (fake_can().sent.size() > before && fake_can().sent.back()[2] == GetElsterIndex("AUSSENTEMP")->Index)
+            aussentemp++;
+    }
+    CHECK(aussentemp >= 7200 / 31);
+    CHECK(aussentemp <= 7200 / 30 + 1);
+}
+
+// ============================================================================
+// Bus load: processAndUpdate / sendElsterFrame / publishBusLoad
+// ============================================================================
+
+TEST_CASE("publishBusLoad: frames seen and sent count towards the bus load", "[mqtt]") {
+    busLoad.configure({CAN_BIT_RATE, BUS_LOAD_WINDOW_MS, BUS_LOAD_HIGH_PERCENT, BUS_LOAD_LOW_PERCENT,
+                       BUS_LOAD_ARB_LOST_LIMIT, REQUEST_BUDGET_MIN_FRAMES_PER_SEC, REQUEST_BUDGET_MAX_FRAMES_PER_SEC},
+                      REQUEST_BUDGET_FRAMES_PER_SEC, 0);
+    const uint8_t data[7] = {0x92, 0x00, 0xFA, 0x00, 0x0C, 0x00, 0x64};
+    for (int i = 0; i < 40; i++)
+        processAndUpdate(makeElsterFrame(0x480, data, 7));
+    for (int i = 0; i < 40; i++)
+        readSignal(&CanMembers[cm_manager], GetElsterIndex("AUSSENTEMP"));
+    REQUIRE(busLoad.update(BUS_LOAD_WINDOW_MS, 0));
+    // 80 seven-byte frames of 121 bits on a 20 kbit/s bus
+    CHECK(busLoad.loadPercent() == 80 * 121 * 100 / CAN_BIT_RATE);
+
+    mqtt_client_instance().clear();
+    discoveredCalculatedSensors.reset();
+    requestPacer.configure(REQUEST_BUDGET_FRAMES_PER_SEC, REQUEST_MIN_GAP_MS, 0);
+    requestPacer.setFramesPerSecond(busLoad.budget());
+    publishBusLoad();
+    CHECK(mqttFindPayload("heatingpump/calculated/can_bus_load/state") == "48");
+    CHECK(mqttFindPayload("heatingpump/calculated/request_budget/state") == std::to_string(REQUEST_BUDGET_FRAMES_PER_SEC));
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_calculated_can_bus_load/config"));
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_calculated_request_budget/config"));
+}
+
+// ============================================================================
+// publishRequestPeriods
+// ============================================================================
+
+TEST_CASE("publishRequestPeriods: achieved vs configured period per signal and worst ratio", "[mqtt]") {
+    const SignalRequest one[] = {{"AUSSENTEMP", FREQ_30S, cm_manager}};
+    buildRequestSlots(one, 1, 0);
+    requestSlots[0].achievedMs = 45000;
+    mqtt_client_instance().clear();
+    discoveredCalculatedSensors.reset();
+
+    publishRequestPeriods();
+    CHECK(mqttFindPayload("heatingpump/request_periods/state") ==
+          "{\"periods\":{\"MANAGER/AUSSENTEMP\":{\"configured\":30,\"achieved\":45}},\"count\":1,\"truncated\":false}");
+    CHECK(mqttFindPayload("heatingpump/calculated/request_period_ratio/state") == "150");
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_calculated_request_period_ratio/config"));
+}
+
+TEST_CASE("publishRequestPeriods: all slots go out as one message", "[mqtt]") {
+    const SignalRequest three[] = {{"AUSSENTEMP", FREQ_30S, cm_manager}, {"VERDICHTER", FREQ_30S, cm_heizmodul},
+                                   {"SPEICHERISTTEMP", FREQ_1MIN, cm_kessel}};
+    buildRequestSlots(three, 3, 0);
+    requestSlots[0].achievedMs = 31200;
+    requestSlots[1].achievedMs = 30000;
+    mqtt_client_instance().clear();
+
+    publishRequestPeriods();
+    size_t messages = 0;
+    for (const auto& m : mqtt_client_instance().messages)
+        if (m.topic.find("period") != std::string::npos && m.topic.find("/config") == std::string::npos)
+            messages++;
+    CHECK(messages == 2);   // the report and the ratio sensor
+    const std::string payload = mqttFindPayload("heatingpump/request_periods/state");
+    CHECK(payload.find("\"MANAGER/AUSSENTEMP\":{\"configured\":30,\"achieved\":31.2}") != std::string::npos);
+    CHECK(payload.find("\"HEIZMODUL/VERDICHTER\"") != std::string::npos);
+    CHECK(payload.find("KESSEL") == std::string::npos);   // not sent yet
+    CHECK(payload.find("\"count\":2") != std::string::npos);
+}
+
+// ============================================================================
+// Request / response correlation
+// ============================================================================
+
+// The answer of `member` to a read request of the PC
+static ElsterFrame responseFrame(CanMemberType member, const char* signal, uint16_t value) {
+    ElsterFrame frame = buildElsterFrame(generate_response_id(CanMembers[cm_pc].CanId), GetElsterIndex(signal)->Index, value);
+    frame.canId = CanMembers[member].CanId;
+    return frame;
+}
+
+static void resetRequestTracking() {
+    const SignalRequest one[] = {{"AUSSENTEMP", FREQ_30S, cm_manager}};
+    buildRequestSlots(one, 1, 0);
+    for (MemberRequestStats& stats : memberRequestStats)
+        stats = MemberRequestStats();
+}
+
+TEST_CASE("isResponseToPc: only responses addressed to the PC", "[can]") {
+    CHECK(isResponseToPc(responseFrame(cm_manager, "AUSSENTEMP", 0)));
+    ElsterFrame write = buildElsterFrame(generate_write_id(CanMembers[cm_pc].CanId), 0x000c, 0);
+    CHECK_FALSE(isResponseToPc(write));
+    ElsterFrame toKessel = buildElsterFrame(generate_response_id(CanMembers[cm_kessel].CanId), 0x000c, 0);
+    CHECK_FALSE(isResponseToPc(toKessel));
+}
+
+TEST_CASE("processAndUpdate: a blacklisted signal is not published", "[can]") {
+    const ElsterIndex* blacklisted = nullptr;
+    for (size_t i = 1; i < ElsterTableCount && !blacklisted; i++)
+        if (ElsterTable[i].isBlacklisted && ElsterTable[i].Index != 0xFFFF)
+            blacklisted = &ElsterTable[i];
+    if (!blacklisted) SKIP("No blacklisted signal in the table");
+
+    mqtt_client_instance().clear();
+    processAndUpdate(responseFrame(cm_manager, blacklisted->Name, 55));
+    CHECK(mqtt_client_instance().messages.empty());
+}
+
+TEST_CASE("processAndUpdate: a response completes the request and records its round-trip time", "[can]") {
+    resetRequestTracking();
+    fake_millis() = 10000;
+    readSignal(&CanMembers[cm_manager], "AUSSENTEMP");
+    CHECK(outstandingRequests.size() == 1);
+
+    // a value the manager sends to someone else does not count
+    ElsterFrame other = buildElsterFrame(generate_write_id(CanMembers[cm_kessel].CanId), GetElsterIndex("AUSSENTEMP")->Index, 55);
+    other.canId = CanMembers[cm_manager].CanId;
+    processAndUpdate(other);
+    CHECK(outstandingRequests.size() == 1);
+
+    // nor does the same index from another member
+    fake_millis() = 10030;
+    processAndUpdate(responseFrame(cm_kessel, "AUSSENTEMP", 55));
+    CHECK(outstandingRequests.size() == 1);
+
+    fake_millis() = 10045;
+    processAndUpdate(responseFrame(cm_manager, "AUSSENTEMP", 55));
+    CHECK(outstandingRequests.empty());
+    CHECK(memberRequestStats[cm_manager].rtt.samples() == 1);
+    CHECK(memberRequestStats[cm_manager].rtt.percentile(50) >= 32);
+    CHECK(memberRequestStats[cm_manager].rtt.percentile(50) < 64);
+    CHECK(memberRequestStats[cm_kessel].rtt.samples() == 0);
+}
+
+TEST_CASE("expireOutstandingRequests: retries an unanswered request, then counts a timeout", "[can]") {
+    resetRequestTracking();
+    fake_millis() = 20000;
+    readSignal(&CanMembers[cm_heizmodul], "VERDICHTER");
+    fake_can().sent.clear();
+
+    expireOutstandingRequests(20000 + REQUEST_TIMEOUT_MS - 1);
+    CHECK(requestRetries.empty());
+
+    // the retry goes out under the frame budget on the next run
+    uint32_t now = 20000 + REQUEST_TIMEOUT_MS;
+    fake_millis() = now;
+    expireOutstandingRequests(now);
+    REQUIRE(requestRetries.size() == 1);
+    CHECK(runRequestSlots(now) == 1);
+    REQUIRE(fake_can().sent.size() == 1);
+    CHECK(fake_can().sent[0][3] == (GetElsterIndex("VERDICHTER")->Index >> 8));
+    CHECK(memberRequestStats[cm_heizmodul].retries == 1);
+    CHECK(outstandingRequests.size() == 1);
+
+    // REQUEST_MAX_RETRIES = 1: the second timeout is final
+    now += REQUEST_TIMEOUT_MS;
+    expireOutstandingRequests(now);
+    CHECK(requestRetries.empty());
+    CHECK(outstandingRequests.empty());
+    CHECK(memberRequestStats[cm_heizmodul].timeouts == 1);
+}
+
+TEST_CASE("publishRequestResponses: p50/p95 round-trip time and timeouts per member", "[mqtt]") {
+    resetRequestTracking();
+    // 100 ms lies in [64, 128): interpolated by rank within the bucket
+    for (int i = 0; i < 20; i++)
+        memberRequestStats[cm_manager].rtt.record(100);
+    memberRequestStats[cm_manager].retries = 3;
+    memberRequestStats[cm_manager].timeouts = 1;
+    memberRequestStats[cm_kessel].timeouts = 2;
+    mqtt_client_instance().clear();
+    discoveredCalculatedSensors.reset();
+
+    publishRequestResponses();
+    CHECK(mqttFindPayload("heatingpump/MANAGER/rtt/state") == "{\"p50\":92,\"p95\":121,\"responses\":20,\"retries\":3,\"timeouts\":1}");
+    CHECK(mqttFindPayload("heatingpump/KESSEL/rtt/state") == "{\"p50\":0,\"p95\":0,\"responses\":0,\"retries\":0,\"timeouts\":2}");
+    CHECK_FALSE(mqttTopicPublished("heatingpump/HEIZMODUL/rtt/state"));
+    CHECK(mqttFindPayload("heatingpump/calculated/request_timeouts/state") == "3");
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_calculated_request_timeouts/config"));
+}
+
+// ============================================================================
+// Learned responders for cm_other signals
+// ============================================================================
+
+static const SignalRequest otherRequest[] = {{"SPEICHERISTTEMP", FREQ_1MIN, cm_other}};
+
+static void resetResponders() {
+    fake_nvs().clear();
+    loadResponderMap();
+    resetRequestTracking();
+}
+
+// Poll otherRequest until `until`; only `responder` answers, with `value`
+static void pollWithResponder(uint32_t from, uint32_t until, CanMemberType responder, uint16_t value) {
+    for (uint32_t now = from; now < until; now += 100) {
+        fake_millis() = now;
+        if (runRequestSlots(now) > 0)
+            processAndUpdate(responseFrame(responder, "SPEICHERISTTEMP", value));
+    }
+}
+
+TEST_CASE("learnResponders: collapses a cm_other signal to the members that answer", "[can]") {
+    resetResponders();
+    buildRequestSlots(otherRequest, 1, 0);
+    REQUIRE(requestSlots.size() == 3);
+    for (const RequestSlot& slot : requestSlots)
+        CHECK(slot.learning);
+
+    // RESPONDER_LEARN_PROBES + 1 requests per member at one per minute
+    pollWithResponder(0, (RESPONDER_LEARN_PROBES + 1) * 61000, cm_manager, 450);
+    const uint16_t index = GetElsterIndex("SPEICHERISTTEMP")->Index;
+    CHECK(responderMap.get(index) == (1u << cm_manager));
+    for (const RequestSlot& slot : requestSlots) {
+        CHECK_FALSE(slot.learning);
+        CHECK(slot.background == (slot.member != &CanMembers[cm_manager]));
+        CHECK(slotIntervalMs(slot) == (slot.background ? RESPONDER_REPROBE_INTERVAL * 1000UL : 60000UL));
+    }
+
+    // The learned map survives a reboot: the schedule starts collapsed
+    responderMap.clear();
+    loadResponderMap();
+    CHECK(responderMap.get(index) == (1u << cm_manager));
+    buildRequestSlots(otherRequest, 1, 0);
+    CHECK_FALSE(requestSlots[1].learning);
+    CHECK_FALSE(requestSlots[1].background);
+    CHECK(requestSlots[0].background);
+    CHECK(requestSlots[2].background);
+}
+
+TEST_CASE("learnResponders: 0x8000 is no answer, a silent signal keeps learning", "[can]") {
+    resetResponders();
+    buildRequestSlots(otherRequest, 1, 0);
+    pollWithResponder(0, (RESPONDER_LEARN_PROBES + 1) * 61000, cm_manager, 0x8000);
+    CHECK(responderMap.get(GetElsterIndex("SPEICHERISTTEMP")->Index) == 0);
+    CHECK(fake_nvs().empty());   // nothing learned, nothing saved
+    for (const RequestSlot& slot : requestSlots) {
+        CHECK(slot.learning);
+        CHECK_FALSE(slot.background);
+    }
+}
+
+TEST_CASE("learnResponders: a signal nobody answers goes to the background after RESPONDER_LEARN_ROUNDS", "[can]") {
+    resetResponders();
+    buildRequestSlots(otherRequest, 1, 0);
+    const uint16_t index = GetElsterIndex("SPEICHERISTTEMP")->Index;
+    for (int round = 1; round <= RESPONDER_LEARN_ROUNDS; round++) {
+        CHECK(requestSlots[0].learning);
+        for (RequestSlot& slot : requestSlots)
+            slot.probes = RESPONDER_LEARN_PROBES + 1;
+        learnResponders(0);
+    }
+    CHECK(responderMap.get(index) == responderMap.NO_RESPONDER);
+    for (const RequestSlot& slot : requestSlots) {
+        CHECK_FALSE(slot.learning);
+        CHECK(slot.background);
+        CHECK(slotIntervalMs(slot) == RESPONDER_REPROBE_INTERVAL * 1000UL);
+    }
+
+    // Persisted: after a reboot every member starts in the background
+    responderMap.clear();
+    loadResponderMap();
+    buildRequestSlots(otherRequest, 1, 0);
+    for (const RequestSlot& slot : requestSlots) {
+        CHECK_FALSE(slot.learning);
+        CHECK(slot.background);
+    }
+
+    // A member that answers a re-probe replaces the marker
+    readSignal(requestSlots[1].member, requestSlots[1].ei, 1, 1);
+    processAndUpdate(responseFrame(cm_manager, "SPEICHERISTTEMP", 450));
+    CHECK_FALSE(requestSlots[1].background);
+    CHECK(responderMap.get(index) == (1u << cm_manager));
+}
+
+TEST_CASE("noteSlotResult: a cm_other signal nobody answers backs off while learning", "[can]") {
+    resetResponders();
+    buildRequestSlots(otherRequest, 1, 0);
+    for (uint32_t now = 0; now < 20 * 60000; now += 100) {
+        fake_millis() = now;
+        expireOutstandingRequests(now);
+        runRequestSlots(now);
+    }
+    for (const RequestSlot& slot : requestSlots) {
+        CHECK(slot.health.quarantined());
+        CHECK(slotIntervalMs(slot) > 60000);
+        CHECK(slotLane(slot) == TX_LANE_PROBE);
+    }
+}
+
+TEST_CASE("noteResponderAnswer: a background member that answers again returns to its interval", "[can]") {
+    resetResponders();
+    const uint16_t index = GetElsterIndex("SPEICHERISTTEMP")->Index;
+    responderMap.set(index, 1u << cm_manager);
+    buildRequestSlots(otherRequest, 1, 0);
+    REQUIRE(requestSlots[2].background);
+
+    // The re-probe of HEIZMODUL is answered
+    readSignal(requestSlots[2].member, requestSlots[2].ei, 1, 2);
+    processAndUpdate(responseFrame(cm_heizmodul, "SPEICHERISTTEMP", 450));
+    CHECK_FALSE(requestSlots[2].background);
+    CHECK(responderMap.get(index) == ((1u << cm_manager) | (1u << cm_heizmodul)));
+    CHECK(requestSlots[0].background);
+}
+
+// ============================================================================
+// Quarantine of slots without a valid answer
+// ============================================================================
+
+TEST_CASE("noteSlotResult: 0x8000 answers back a slot off, the first value restores it", "[can]") {
+    resetRequestTracking();   // slot 0: AUSSENTEMP from MANAGER every 30 s
+    RequestSlot& slot = requestSlots[0];
+    for (int i = 0; i < QUARANTINE_MISSES; i++) {
+        readSignal(slot.member, slot.ei, 1, 0);
+        processAndUpdate(responseFrame(cm_manager, "AUSSENTEMP", 0x8000));
+    }
+    CHECK(slot.health.quarantined());
+    CHECK(slotIntervalMs(slot) == 60000);
+
+    fake_millis() = 50000;
+    slot.deadline = 50000 + 60000;
+    requestScheduler.reset(1);
+    requestScheduler.schedule(0, slot.deadline);
+    readSignal(slot.member, slot.ei, 1, 0);
+    processAndUpdate(responseFrame(cm_manager, "AUSSENTEMP", 55));
+    CHECK_FALSE(slot.health.quarantined());
+    CHECK(slotIntervalMs(slot) == 30000);
+    CHECK(slot.deadline == 50000 + 30000);
+    CHECK(requestScheduler.nextDeadline() == slot.deadline);
+}
+
+TEST_CASE("noteSlotResult: -255 answers count as misses", "[can]") {
+    resetRequestTracking();   // slot 0: AUSSENTEMP (et_dec_val) from MANAGER
+    RequestSlot& slot = requestSlots[0];
+    for (int i = 0; i < QUARANTINE_MISSES; i++) {
+        readSignal(slot.member, slot.ei, 1, 0);
+        processAndUpdate(responseFrame(cm_manager, "AUSSENTEMP", (uint16_t)(int16_t)-2550));
+    }
+    CHECK(slot.health.quarantined());
+
+    // -25.5 is a value
+    readSignal(slot.member, slot.ei, 1, 0);
+    processAndUpdate(responseFrame(cm_manager, "AUSSENTEMP", (uint16_t)(int16_t)-255));
+    CHECK_FALSE(slot.health.quarantined());
+}
+
+TEST_CASE("noteSlotResult: requests unanswered after all retries count as misses", "[can]") {
+    resetRequestTracking();
+    RequestSlot& slot = requestSlots[0];
+    uint32_t now = 1000;
+    for (int i = 0; i < QUARANTINE_MISSES + 2; i++, now += REQUEST_TIMEOUT_MS) {
+        fake_millis() = now;
+        readSignal(slot.member, slot.ei, REQUEST_MAX_RETRIES + 1, 0);
+        expireOutstandingRequests(now + REQUEST_TIMEOUT_MS);
+    }
+    CHECK(slot.health.misses == QUARANTINE_MISSES + 2);
+    CHECK(slotIntervalMs(slot) == 30000u << 3);
+
+    // a request outside the schedule leaves the slot alone
+    fake_millis() = now;
+    readSignal(slot.member, slot.ei, REQUEST_MAX_RETRIES + 1);
+    expireOutstandingRequests(now + REQUEST_TIMEOUT_MS);
+    CHECK(slot.health.misses == QUARANTINE_MISSES + 2);
+}
+
+TEST_CASE("publishRequestQuarantine: lists quarantined slots as JSON and counts them", "[mqtt]") {
+    const SignalRequest two[] = {{"AUSSENTEMP", FREQ_30S, cm_manager}, {"VERDICHTER", FREQ_10MIN, cm_heizmodul}};
+    buildRequestSlots(two, 2, 0);
+    for (int i = 0; i < QUARANTINE_MISSES; i++)
+        requestSlots[1].health.miss(QUARANTINE_MISSES, requestSlots[1].intervalMs, QUARANTINE_MAX_INTERVAL * 1000UL);
+    mqtt_client_instance().clear();
+    discoveredCalculatedSensors.reset();
+
+    publishRequestQuarantine();
+    CHECK(mqttFindPayload("heatingpump/quarantine/state") ==
+          "{\"signals\":[{\"member\":\"HEIZMODUL\",\"signal\":\"VERDICHTER\",\"misses\":3,\"interval\":1200}],"
+          "\"count\":1,\"truncated\":false}");
+    CHECK(mqttFindPayload("heatingpump/calculated/quarantined_signals/state") == "1");
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_calculated_quarantined_signals/config"));
+
+    requestSlots[1].health.answer();
+    mqtt_client_instance().clear();
+    publishRequestQuarantine();
+    CHECK(mqttFindPayload("heatingpump/quarantine/state") == "{\"signals\":[],\"count\":0,\"truncated\":false}");
+}
+
+TEST_CASE("publishRequestQuarantine: stops the list at the first slot that does not fit", "[mqtt]") {
+    std::vector<SignalRequest> many(30, SignalRequest{"EINSTELL_SPEICHERSOLLTEMP", FREQ_10MIN, cm_manager});
+    buildRequestSlots(many.data(), many.size(), 0);
+    for (RequestSlot& slot : requestSlots)
+        for (int i = 0; i < QUARANTINE_MISSES; i++)
+            slot.health.miss(QUARANTINE_MISSES, slot.intervalMs, QUARANTINE_MAX_INTERVAL * 1000UL);
+    mqtt_client_instance().clear();
+
+    publishRequestQuarantine();
+    const std::string payload = mqttFindPayload("heatingpump/quarantine/state");
+    REQUIRE_FALSE(payload.empty());
+    CHECK(payload.find("],\"count\":30,\"truncated\":true}") != std::string::npos);
+    const size_t listed = std::count(payload.begin(), payload.end(), '{') - 1;
+    CHECK(listed > 0);
+    CHECK(listed < 30);
+    CHECK(payload.find(",]") == std::string::npos);
+    CHECK(mqttFindPayload("heatingpump/calculated/quarantined_signals/state") == "30");
+}
+
+// ============================================================================
+// Transmit lanes
+// ============================================================================
+
+static void resetTxLanes() {
+    resetRequestTracking();
+    for (auto& queue : txQueues)
+        queue.clear();
+    commandLatency = RttHistogram();
+    unconfirmedCommands = 0;
+    commandSequencer.configure(SEQUENCE_STEP_TIMEOUT_MS, SEQUENCE_STEP_ATTEMPTS);
+    fake_can().sent.clear();
+}
+
+// True if `frame` is addressed to the write ID of `member`
+static bool isWriteTo(const std::vector<uint8_t>& frame, CanMemberType member) {
+    return frame[0] == CanMembers[member].WriteId.first && frame[1] == CanMembers[member].WriteId.second;
+}
+
+TEST_CASE("queueCommand: queues the write and its readback, refuses bad values", "[can]") {
+    resetTxLanes();
+    fake_millis() = 0;
+    CHECK_FALSE(queueCommand(&CanMembers[cm_manager], "PROGRAMMSCHALTER", "Bogus Value"));
+    CHECK_FALSE(queueCommand(&CanMembers[cm_manager], "DOES_NOT_EXIST_XYZ", "1"));
+    CHECK(txQueues[TX_LANE_COMMAND].empty());
+
+    CHECK(queueCommand(&CanMembers[cm_manager], "EINSTELL_SPEICHERSOLLTEMP", "45.0"));
+    CHECK(fake_can().sent.empty());   // nothing goes out before the scheduler runs
+    CHECK(txQueues[TX_LANE_COMMAND].size() == 1);
+    CHECK(txQueues[TX_LANE_CONFIRM].size() == 1);
+
+    // write first, readback after the inter-frame gap
+    CHECK(runRequestSlots(0) == 1);
+    CHECK(runRequestSlots(REQUEST_MIN_GAP_MS) == 0);   // bucket empty
+    CHECK(runRequestSlots(1000 / REQUEST_BUDGET_FRAMES_PER_SEC) == 1);
+    REQUIRE(fake_can().sent.size() == 2);
+    CHECK(isWriteTo(fake_can().sent[0], cm_manager));
+    CHECK_FALSE(isWriteTo(fake_can().sent[1], cm_manager));
+    CHECK(outstandingRequests.size() == 1);
+}
+
+TEST_CASE("runRequestSlots: a command overtakes a saturated poll table", "[can]") {
+    resetTxLanes();
+    // 40 polls due at 42 ms: a backlog of four seconds at the request budget
+    std::vector<SignalRequest> many(40, SignalRequest{"AUSSENTEMP", FREQ_10MIN, cm_manager});
+    buildRequestSlots(many.data(), many.size(), 0);
+
+    const uint32_t queuedAt = 1000;
+    const uint32_t frameMs = 1000 / REQUEST_BUDGET_FRAMES_PER_SEC;
+    uint32_t writeAt = 0, confirmAt = 0;
+    for (uint32_t now = 0; now < 3000; now++) {
+        fake_millis() = now;
+        if (now == queuedAt)
+            REQUIRE(queueCommand(&CanMembers[cm_manager], "EINSTELL_SPEICHERSOLLTEMP", "45.0"));
+        if (confirmAt && now == confirmAt + 30)
+            processAndUpdate(responseFrame(cm_manager, "EINSTELL_SPEICHERSOLLTEMP", 450));
+        size_t before = fake_can().sent.size();
+        runRequestSlots(now);
+        if (fake_can().sent.size() == before) continue;
+        if (isWriteTo(fake_can().sent.back(), cm_manager)) {
+            writeAt = now;
+        } else if (writeAt && !confirmAt) {
+            confirmAt = now;
+        }
+    }
+    // each waits at most one frame of the request budget
+    REQUIRE(writeAt > 0);
+    REQUIRE(confirmAt > 0);
+    CHECK(writeAt - queuedAt <= frameMs);
+    CHECK(confirmAt - writeAt <= frameMs);
+    // the polls are still backed up
+    CHECK(std::count_if(requestSlots.begin(), requestSlots.end(), [](const RequestSlot& slot) { return !slot.sent; }) > 0);
+
+    // the readback was answered 30 ms after it went out
+    CHECK(pendingConfirms.empty());
+    CHECK(commandLatency.samples() == 1);
+    CHECK(commandLatency.percentile(100) <= 2 * frameMs + 30);
+}
+
+TEST_CASE("runRequestSlots: background members are probes under their own budget", "[can]") {
+    fake_nvs().clear();
+    loadResponderMap();
+    responderMap.set(GetElsterIndex("SPEICHERISTTEMP")->Index, 1u << cm_manager);
+    resetTxLanes();
+    buildRequestSlots(otherRequest, 1, 0);
+    CHECK(requestScheduler.size() == 1);
+    CHECK(probeScheduler.size() == 2);
+
+    // both probes due at once: the probe lane sends one per second
+    fake_can().sent.clear();
+    std::vector<uint32_t> sentAt;
+    for (uint32_t now = 0; now < 2000; now++) {
+        fake_millis() = now;
+        if (runRequestSlots(now) > 0)
+            sentAt.push_back(now);
+    }
+    REQUIRE(sentAt.size() == 3);   // the poll and two probes
+    CHECK(sentAt[2] - sentAt[1] >= 1000 / TX_LANE_PROBE_FRAMES_PER_SEC);
+    responderMap.clear();
+}
+
+TEST_CASE("expireOutstandingRequests: a write without readback is unconfirmed", "[can]") {
+    resetTxLanes();
+    fake_millis() = 100;
+    REQUIRE(queueCommand(&CanMembers[cm_manager], "RAUMSOLLTEMP_I", "21.0"));
+    expireOutstandingRequests(100 + COMMAND_CONFIRM_TIMEOUT_MS - 1);
+    CHECK(unconfirmedCommands == 0);
+    expireOutstandingRequests(100 + COMMAND_CONFIRM_TIMEOUT_MS);
+    CHECK(unconfirmedCommands == 1);
+    CHECK(pendingConfirms.empty());
+}
+
+TEST_CASE("publishCommandLatency: p50/p95 and confirmed vs unconfirmed writes", "[mqtt]") {
+    resetTxLanes();
+    for (int i = 0; i < 20; i++)
+        commandLatency.record(100);
+    unconfirmedCommands = 2;
+    mqtt_client_instance().clear();
+    discoveredCalculatedSensors.reset();
+
+    publishCommandLatency();
+    CHECK(mqttFindPayload("heatingpump/command_latency/state") == "{\"p50\":92,\"p95\":121,\"confirmed\":20,\"unconfirmed\":2}");
+    CHECK(mqttFindPayload("heatingpump/calculated/command_latency/state") == "121");
+    CHECK(mqttTopicPublished("homeassistant/sensor/heatingpump/stiebel_calculated_command_latency/config"));
+}
+
+// ============================================================================
+// Command sequencer
+// ============================================================================
+
+static uint16_t frameIndex(const std::vector<uint8_t>& frame) {
+    return frame[2] == 0xFA ? static_cast<uint16_t>(frame[3] << 8 | frame[4]) : frame[2];
+}
+
+static uint16_t frameValue(const std::vector<uint8_t>& frame) {
+    return frame[2] == 0xFA ? static_cast<uint16_t>(frame[5] << 8 | frame[6])
+                            : static_cast<uint16_t>(frame[3] << 8 | frame[4]);
+}
+
+// Run the command sequencer and the lanes from `from` to `until`. With
+// `answer` the manager reads back each written value 30 ms after the read;
+// the indices of the writes sent are collected in `writes`.
+static void runSequence(uint32_t from, uint32_t until, bool answer, std::vector<uint16_t>& writes) {
+    std::map<uint16_t, uint16_t> written;
+    std::vector<std::pair<uint32_t, uint16_t>> answers;   // (due, index)
+    for (uint32_t now = from; now < until; now++) {
+        fake_millis() = now;
+        for (auto it = answers.begin(); it != answers.end();) {
+            if (it->first != now) { ++it; continue; }
+            ElsterFrame frame = buildElsterFrame(generate_response_id(CanMembers[cm_pc].CanId), it->second, written[it->second]);
+            frame.canId = CanMembers[cm_manager].CanId;
+            processAndUpdate(frame);
+            it = answers.erase(it);
+        }
+        size_t before = fake_can().sent.size();
+        runCommandSequencer(now);
+        runRequestSlots(now);
+        for (size_t i = before; i < fake_can().sent.size(); i++) {
+            const std::vector<uint8_t>& frame = fake_can().sent[i];
+            if (isWriteTo(frame, cm_manager)) {
+                writes.push_back(frameIndex(frame));
+                written[frameIndex(frame)] = frameValue(frame);
+            } else if (answer && written.count(frameIndex(frame))) {
+                answers.push_back({now + 30, frameIndex(frame)});
+            }
+        }
+    }
+}
+
+TEST_CASE("updateDate: the date is written as one transaction, each write after the previous readback", "[can]") {
+    resetTxLanes();
+    mqtt_client_instance().clear();
+    fake_millis() = 0;
+    updateDate(CanMembers[cm_manager], "2026-10-16");
+    CHECK(fake_can().sent.empty());   // updateDate() only submits
+
+    std::vector<uint16_t> writes;
+    runSequence(0, 3000, true, writes);
+
+    REQUIRE(writes.size() == 3);
+    CHECK(writes[0] == GetElsterIndex("JAHR")->Index);
+    CHECK(writes[1] == GetElsterIndex("MONAT")->Index);
+    CHECK(writes[2] == GetElsterIndex("TAG")->Index);
+    // write, readback, write, readback, ...: never two writes back to back
+    std::vector<std::vector<uint8_t>> sent;
+    for (const auto& frame : fake_can().sent)
+        if (std::find(writes.begin(), writes.end(), frameIndex(frame)) != writes.end())
+            sent.push_back(frame);
+    REQUIRE(sent.size() == 6);
+    for (size_t i = 0; i < sent.size(); i++)
+        CHECK(isWriteTo(sent[i], cm_manager) == (i % 2 == 0));
+    const char* year = "26";
+    const char* day = "16";
+    CHECK(frameValue(sent[0]) == TranslateString(year, GetElsterIndex("JAHR")->Type));
+    CHECK(frameValue(sent[4]) == TranslateString(day, GetElsterIndex("TAG")->Type));
+
+    CHECK_FALSE(commandSequencer.busy());
+    const std::string result = mqttFindPayload("heatingpump/command_sequence/state");
+    CHECK(result.find("\"name\":\"Datum\",\"ok\":true,\"confirmed\":3,\"steps\":3") != std::string::npos);
+}
+
+TEST_CASE("updateTime: any value read back confirms the running clock", "[can]") {
+    resetTxLanes();
+    mqtt_client_instance().clear();
+    fake_millis() = 0;
+    updateTime(CanMembers[cm_manager], "12:34:56");
+
+    // Read back one second later than written: still confirmed
+    std::vector<uint16_t> writes;
+    runSequence(0, 3000, true, writes);
+    REQUIRE(writes.size() == 3);
+    CHECK(mqttFindPayload("heatingpump/command_sequence/state").find("\"ok\":true") != std::string::npos);
+}
+
+TEST_CASE("SG Ready: an unconfirmed write fails the transition and drops the writes after it", "[can]") {
+    resetTxLanes();
+    mqtt_client_instance().clear();
+    fake_millis() = 0;
+    REQUIRE(sgReadyController.applyState(SgReadyController::STATE_FORCED));
+    CHECK(commandSequencer.size() == 1);
+
+    std::vector<uint16_t> writes;
+    runSequence(0, SEQUENCE_STEP_ATTEMPTS * SEQUENCE_STEP_TIMEOUT_MS + 100, false, writes);
+
+    // PROGRAMMSCHALTER is sent SEQUENCE_STEP_ATTEMPTS times, the setpoints never
+    REQUIRE(writes.size() == SEQUENCE_STEP_ATTEMPTS);
+    for (uint16_t index : writes)
+        CHECK(index == GetElsterIndex("PROGRAMMSCHALTER")->Index);
+    CHECK_FALSE(commandSequencer.busy());
+    CHECK(mqttFindPayload("heatingpump/command_sequence/state")
+          .find("\"name\":\"4 - Zwang\",\"ok\":false,\"confirmed\":0,\"steps\":3") != std::string::npos);
+    sgReadyController.applyState(SgReadyController::STATE_NORMAL);
+    commandSequencer.configure(SEQUENCE_STEP_TIMEOUT_MS, SEQUENCE_STEP_ATTEMPTS);
+}
+
+TEST_CASE("publishSequenceResult: escapes the name, drops a result that does not fit", "[mqtt]") {
+    mqtt_client_instance().clear();
+    SequenceResult result = {};
+    result.name = "Zeit \"Sommer\"";
+    result.ok = true;
+    result.durationMs = 12345678;
+    publishSequenceResult(result);
+    CHECK(mqttFindPayload("heatingpump/command_sequence/state") ==
+          R"({"name":"Zeit \"Sommer\"","ok":true,"confirmed":0,"steps":0,"duration":12345678})");
+
+    mqtt_client_instance().clear();
+    const std::string longName(200, 'x');
+    result.name = longName.c_str();
+    publishSequenceResult(result);
+    CHECK_FALSE(mqttTopicPublished("heatingpump/command_sequence/state"));
+}
+
+// ============================================================================
+// Poll groups
+// ============================================================================
+
+static const SignalRequest groupedRequests[] = {
+    {"JAHR",       FREQ_1MIN, cm_manager, pg_datetime},
+    {"MONAT",      FREQ_1MIN, cm_manager, pg_datetime},
+    {"TAG",        FREQ_1MIN, cm_manager, pg_datetime},
+    {"STUNDE",     FREQ_1MIN, cm_manager, pg_datetime},
+    {"MINUTE",     FREQ_1MIN, cm_manager, pg_datetime},
+    {"SEKUNDE",    FREQ_1MIN, cm_manager, pg_datetime},
+    {"AUSSENTEMP", FREQ_30S,  cm_manager},
+    {"AUSSENTEMP", FREQ_30S,  cm_kessel},
+    {"AUSSENTEMP", FREQ_30S,  cm_heizmodul},
+};
+static const char* const dateTimeSignals[] = {"JAHR", "MONAT", "TAG", "STUNDE", "MINUTE", "SEKUNDE"};
+
+static void resetDateTime() {
+    lastJahr = lastMonat = lastTag = lastStunde = lastMinute = lastSekunde = -1;
+    forgetPublishedStates();
+    mqtt_client_instance().clear();
+}
+
+// Send the requests due in the first two seconds; returns their Elster indices
+static std::vector<uint16_t> pollFirstRound() {
+    fake_can().sent.clear();
+    for (uint32_t now = 0; now < 2000; now++) {
+        fake_millis() = now;
+        runRequestSlots(now);
+    }
+    std::vector<uint16_t> indices;
+    for (const auto& frame : fake_can().sent)
+        indices.push_back(frameIndex(frame));
+    return indices;
+}
+
+TEST_CASE("buildRequestSlots: only the first slot of a poll group is scheduled", "[can]") {
+    buildRequestSlots(groupedRequests, 9, 0);
+    CHECK(requestSlots.size() == 9);
+    CHECK(requestScheduler.size() == 4);   // JAHR and three AUSSENTEMP
+    CHECK(pollGroups[pg_datetime].first == 0);
+    CHECK(pollGroups[pg_datetime].size == 6);
+    CHECK(pollGroups[pg_cop].size == 0);
+    for (size_t i = 0; i < 6; i++)
+        CHECK(requestSlots[i].pollGroup == pg_datetime);
+    CHECK(requestSlots[6].pollGroup == pg_none);
+}
+
+TEST_CASE("buildRequestSlots: a poll group row away from its group is polled on its own", "[can]") {
+    const SignalRequest split[] = {
+        {"JAHR",       FREQ_1MIN, cm_manager, pg_datetime},
+        {"AUSSENTEMP", FREQ_30S,  cm_manager},
+        {"MONAT",      FREQ_1MIN, cm_manager, pg_datetime},
+        {"TAG",        FREQ_1MIN, cm_kessel,  pg_datetime},
+    };
+    buildRequestSlots(split, 4, 0);
+    CHECK(pollGroups[pg_datetime].size == 1);
+    CHECK(requestScheduler.size() == 4);
+    CHECK(requestSlots[2].pollGroup == pg_none);
+    CHECK(requestSlots[3].pollGroup == pg_none);
+}
+
+TEST_CASE("poll group: its signals are requested back to back ahead of other due polls", "[can]") {
+    resetTxLanes();
+    buildRequestSlots(groupedRequests, 9, 0);
+    const std::vector<uint16_t> indices = pollFirstRound();
+
+    REQUIRE(indices.size() == 9);
+    for (size_t i = 0; i < 6; i++)
+        CHECK(indices[i] == GetElsterIndex(dateTimeSignals[i])->Index);
+    for (size_t i = 6; i < 9; i++)
+        CHECK(indices[i] == GetElsterIndex("AUSSENTEMP")->Index);
+    // the round is not scheduled again before its interval
+    CHECK(requestScheduler.size() == 4);
+    CHECK(requestSlots[0].deadline >= FREQ_1MIN * 1000UL);
+}
+
+TEST_CASE("poll group: values are published together once the round is complete", "[can]") {
+    resetTxLanes();
+    resetDateTime();
+    buildRequestSlots(groupedRequests, 9, 0);
+    pollFirstRound();
+
+    const uint16_t values[] = {26, 10, 16, 12, 34, 56};
+    for (size_t i = 0; i < 5; i++)
+        processAndUpdate(responseFrame(cm_manager, dateTimeSignals[i], values[i] << 8));
+    // nothing of the round is visible before its last value
+    CHECK(lastMinute == -1);
+    CHECK_FALSE(mqttTopicPublished("heatingpump/MANAGER/JAHR/state"));
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/time/state"));
+
+    processAndUpdate(responseFrame(cm_manager, "SEKUNDE", 56 << 8));
+    CHECK(mqttFindPayload("heatingpump/MANAGER/JAHR/state") == "26");
+    CHECK(mqttFindPayload("heatingpump/calculated/date/state") == "2026-10-16");
+    CHECK(mqttFindPayload("heatingpump/calculated/time/state") == "12:34:56");
+}
+
+TEST_CASE("poll group: values from outside a round do not feed its calculated sensors", "[can]") {
+    resetTxLanes();
+    resetDateTime();
+    buildRequestSlots(groupedRequests, 9, 0);
+
+    // MINUTE seen without a request of ours
+    processAndUpdate(responseFrame(cm_manager, "MINUTE", 35 << 8));
+    CHECK(mqttFindPayload("heatingpump/MANAGER/MINUTE/state") == "35");
+    CHECK(lastMinute == -1);
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/time/state"));
+}
+
+TEST_CASE("poll group: an unanswered signal publishes the rest but no calculated sensor", "[can]") {
+    resetTxLanes();
+    resetDateTime();
+    buildRequestSlots(groupedRequests, 9, 0);
+    pollFirstRound();
+
+    const uint16_t values[] = {26, 10, 16, 12, 34};
+    for (size_t i = 0; i < 5; i++)
+        processAndUpdate(responseFrame(cm_manager, dateTimeSignals[i], values[i] << 8));
+    // SEKUNDE stays unanswered, retry included
+    for (uint32_t now = 2000; now < 2000 + (REQUEST_MAX_RETRIES + 2) * REQUEST_TIMEOUT_MS; now += 10) {
+        fake_millis() = now;
+        expireOutstandingRequests(now);
+        runRequestSlots(now);
+    }
+    CHECK(pollGroups[pg_datetime].pending == 0);
+    CHECK(mqttFindPayload("heatingpump/MANAGER/MINUTE/state") == "34");
+    CHECK(lastMinute == -1);   // inputs only come from complete rounds
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/time/state"));
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/date/state"));
+}
+
+TEST_CASE("poll group: a round without MINUTE keeps the time of the last round, also for the timer", "[can]") {
+    resetTxLanes();
+    resetDateTime();
+    buildRequestSlots(groupedRequests, 9, 0);
+    pollFirstRound();
+    const uint16_t first[] = {26, 10, 16, 12, 34, 56};
+    for (size_t i = 0; i < 6; i++)
+        processAndUpdate(responseFrame(cm_manager, dateTimeSignals[i], first[i] << 8));
+    REQUIRE(mqttFindPayload("heatingpump/calculated/time/state") == "12:34:56");
+
+    // Next round at 12:35:02: MINUTE stays unanswered, the others answer at once
+    mqtt_client_instance().clear();
+    const uint16_t second[] = {26, 10, 16, 12, 35, 2};
+    const uint32_t end = FREQ_1MIN * 1000UL + 60000;
+    for (uint32_t now = 2000; now < end; now += 10) {
+        fake_millis() = now;
+        expireOutstandingRequests(now);
+        const size_t before = fake_can().sent.size();
+        runRequestSlots(now);
+        for (size_t f = before; f < fake_can().sent.size(); f++)
+            for (size_t i = 0; i < 6; i++)
+                if (i != 4 && frameIndex(fake_can().sent[f]) == GetElsterIndex(dateTimeSignals[i])->Index)
+                    processAndUpdate(responseFrame(cm_manager, dateTimeSignals[i], second[i] << 8));
+    }
+    CHECK(mqttFindPayload("heatingpump/MANAGER/SEKUNDE/state") == "2");
+    CHECK(lastMinute == 34);
+    CHECK(lastSekunde == 56);
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/time/state"));
+
+    // The calculated sensor timer leaves the polled date and time alone
+    mqtt_client_instance().clear();
+    requestManagerStarted = true;
+    processCalculatedSensors();
+    nextDateTimeUpdate = nextDeltaTUpdate = fake_millis();
+    processCalculatedSensors();
+    requestManagerStarted = false;
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/time/state"));
+    CHECK_FALSE(mqttTopicPublished("heatingpump/calculated/date/state"));
+}
+
 // ============================================================================
 // i18n — LNAME_* macros resolve to non-empty strings
 // ============================================================================
@@ -1072,7 +2343,79 @@ TEST_CASE("i18n: named ElsterTable signals have non-empty friendlyName via LNAME
     for (const char* name : named) {
         const ElsterIndex* ei = GetElsterIndex(name);
         REQUIRE(ei != nullptr);
-        if (ei->hasMetadata && ei->friendlyName)
-            CHECK(std::string(ei->friendlyName).length() > 0);
+        const ElsterMetadata* meta = GetElsterMetadata(ei);
+        if (meta && meta->friendlyName)
+            CHECK(std::string(meta->friendlyName).length() > 0);
     }
 }
+
+// ============================================================================
+// Per-model Elster signal sets (signal_set_*.h)
+// ============================================================================
+// Each model's request table and signal set in its own namespace, so both
+// models can be checked side by side with the stub signalRequests linked.
+namespace wpl13e {
+#include "../esphome/ha-stiebel-control/signal_requests_wpl13e.h"
+#include "../esphome/ha-stiebel-control/signal_set_wpl13e.h"
+}
+namespace wpf10 {
+#include "../esphome/ha-stiebel-control/signal_requests_wpf10.h"
+#include "../esphome/ha-stiebel-control/signal_set_wpf10.h"
+}
+
+template <size_t N>
+static bool inSignalSet(const char* const (&set)[N], const char* name) {
+    for (const char* s : set)
+        if (strcmp(s, name) == 0)
+            return true;
+    return false;
+}
+
+static bool isElsterSignal(const char* name) {
+    return GetElsterIndex(name) != &ElsterTable[0];
+}
+
+template <size_t N, size_t M>
+static void checkSignalSet(const char* const (&set)[N], const SignalRequest (&requests)[M]) {
+    for (const SignalRequest& req : requests)
+        if (isElsterSignal(req.signalName) && !inSignalSet(set, req.signalName))
+            FAIL_CHECK("requested signal missing from signal set: " << req.signalName);
+    for (const char* name : set)
+        if (!isElsterSignal(name))
+            FAIL_CHECK("signal set names unknown signal: " << name);
+    for (size_t i = 0; i < WRITABLE_NUMBER_COUNT; ++i)
+        if (isElsterSignal(writableNumbers[i].signalName) && !inSignalSet(set, writableNumbers[i].signalName))
+            FAIL_CHECK("writable number missing from signal set: " << writableNumbers[i].signalName);
+    for (const WritableSelectConfig& sel : writableSelects)
+        if (isElsterSignal(sel.signalName) && !inSignalSet(set, sel.signalName))
+            FAIL_CHECK("writable select missing from signal set: " << sel.signalName);
+    // updateSensor() inputs of the calculated sensors and COP
+    for (const char* name : {"JAHR", "MONAT", "TAG", "STUNDE", "MINUTE", "SEKUNDE",
+                             "SOMMERBETRIEB", "WPVORLAUFIST", "RUECKLAUFISTTEMP", "VERDICHTER",
+                             "EL_AUFNAHMELEISTUNG_HEIZ_SUM_MWH", "EL_AUFNAHMELEISTUNG_WW_SUM_MWH",
+                             "WAERMEERTRAG_2WE_WW_SUM_MWH", "WAERMEERTRAG_2WE_HEIZ_SUM_MWH",
+                             "WAERMEERTRAG_WW_SUM_MWH", "WAERMEERTRAG_HEIZ_SUM_MWH"})
+        if (!inSignalSet(set, name))
+            FAIL_CHECK("calculated sensor input missing from signal set: " << name);
+    SUCCEED();
+}
+
+TEST_CASE("signal set: WPL13E covers its requests, writables and calculated inputs", "[signalset]") {
+    checkSignalSet(wpl13e::ElsterSignalSet, wpl13e::signalRequests);
+}
+
+TEST_CASE("signal set: WPF10 covers its requests, writables and calculated inputs", "[signalset]") {
+    checkSignalSet(wpf10::ElsterSignalSet, wpf10::signalRequests);
+}
+
+TEST_CASE("signal tables: poll groups are complete in both models", "[can]") {
+    buildRequestSlots(wpl13e::signalRequests, wpl13e::SIGNAL_REQUEST_COUNT_VALUE, 0);
+    CHECK(pollGroups[pg_datetime].size == 6);
+    CHECK(pollGroups[pg_cop].size == 6);
+    CHECK(pollGroups[pg_delta_t].size == 2);
+    buildRequestSlots(wpf10::signalRequests, wpf10::SIGNAL_REQUEST_COUNT_VALUE, 0);
+    CHECK(pollGroups[pg_datetime].size == 6);
+    CHECK(pollGroups[pg_cop].size == 6);
+    CHECK(pollGroups[pg_delta_t].size == 2);
+    resetRequestTracking();
+}
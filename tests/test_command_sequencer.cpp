@@ -0,0 +1,199 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/command_sequencer.h"
+
+namespace {
+
+CommandTransaction transaction(const char* name, uint8_t steps) {
+    CommandTransaction t = {name};
+    for (uint8_t i = 0; i < steps; i++)
+        t.add(1, 0x0100 + i, 10 + i);
+    return t;
+}
+
+}  // namespace
+
+// ============================================================================
+// CommandTransaction
+// ============================================================================
+
+TEST_CASE("CommandTransaction: add stops at MAX_STEPS", "[sequencer]") {
+    CommandTransaction t = {"t"};
+    for (uint8_t i = 0; i < CommandTransaction::MAX_STEPS; i++)
+        CHECK(t.add(1, i, i));
+    CHECK_FALSE(t.add(1, 9, 9));
+    CHECK(t.count == CommandTransaction::MAX_STEPS);
+}
+
+// ============================================================================
+// CommandSequencer
+// ============================================================================
+
+TEST_CASE("CommandSequencer: hands out the next write only after the previous one is confirmed", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(5000, 2);
+    REQUIRE(s.submit(transaction("t", 3)));
+
+    SequenceStep step;
+    REQUIRE(s.nextWrite(100, step));
+    CHECK(step.index == 0x0100);
+    CHECK(step.value == 10);
+    CHECK_FALSE(s.nextWrite(200, step));
+
+    s.onValue(1, 0x0100, 10, 300);
+    REQUIRE(s.nextWrite(300, step));
+    CHECK(step.index == 0x0101);
+    s.onValue(1, 0x0101, 11, 400);
+    REQUIRE(s.nextWrite(400, step));
+    CHECK(step.index == 0x0102);
+
+    SequenceResult result;
+    CHECK_FALSE(s.takeResult(result));
+    s.onValue(1, 0x0102, 12, 600);
+    CHECK_FALSE(s.busy());
+    REQUIRE(s.takeResult(result));
+    CHECK(result.ok);
+    CHECK(result.confirmed == 3);
+    CHECK(result.count == 3);
+    CHECK(result.durationMs == 500);
+    CHECK(std::string(result.name) == "t");
+    CHECK_FALSE(s.takeResult(result));
+}
+
+TEST_CASE("CommandSequencer: other values, signals and members do not confirm a write", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(5000, 2);
+    s.submit(transaction("t", 2));
+    SequenceStep step;
+    s.nextWrite(0, step);
+
+    s.onValue(1, 0x0100, 99, 10);    // old value of a poll sent before the write
+    s.onValue(2, 0x0100, 10, 10);    // other member
+    s.onValue(1, 0x0101, 11, 10);    // next step's signal
+    CHECK_FALSE(s.nextWrite(20, step));
+
+    s.onValue(1, 0x0100, 10, 30);
+    CHECK(s.nextWrite(30, step));
+}
+
+TEST_CASE("CommandSequencer: a step that is not exact is confirmed by any value", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(5000, 2);
+    CommandTransaction t = {"clock"};
+    t.add(1, 0x0124, 30, false);
+    s.submit(t);
+    SequenceStep step;
+    s.nextWrite(0, step);
+    s.onValue(1, 0x0124, 31, 100);
+
+    SequenceResult result;
+    REQUIRE(s.takeResult(result));
+    CHECK(result.ok);
+}
+
+TEST_CASE("CommandSequencer: an unconfirmed write is handed out again, then the transaction fails", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(1000, 2);
+    s.submit(transaction("t", 3));
+    s.submit(transaction("next", 1));
+
+    SequenceStep step;
+    s.nextWrite(0, step);
+    s.onValue(1, 0x0100, 10, 100);
+    REQUIRE(s.nextWrite(100, step));
+    CHECK(step.index == 0x0101);
+
+    CHECK_FALSE(s.nextWrite(1099, step));
+    REQUIRE(s.nextWrite(1100, step));           // second attempt
+    CHECK(step.index == 0x0101);
+
+    // Attempts used up: the transaction fails, its last step is never sent
+    // and the next transaction starts right away
+    REQUIRE(s.nextWrite(2100, step));
+    CHECK(step.index == 0x0100);
+    CHECK(s.size() == 1);
+
+    SequenceResult result;
+    REQUIRE(s.takeResult(result));
+    CHECK(std::string(result.name) == "t");
+    CHECK_FALSE(result.ok);
+    CHECK(result.confirmed == 1);
+    CHECK(result.count == 3);
+    CHECK(result.durationMs == 2100);
+}
+
+TEST_CASE("CommandSequencer: a late confirmation of the first attempt still counts", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(1000, 2);
+    s.submit(transaction("t", 1));
+    SequenceStep step;
+    s.nextWrite(0, step);
+    s.nextWrite(1000, step);
+    s.onValue(1, 0x0100, 10, 1500);
+
+    SequenceResult result;
+    REQUIRE(s.takeResult(result));
+    CHECK(result.ok);
+}
+
+TEST_CASE("CommandSequencer: submit refuses empty transactions and a full queue", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(1000, 1);
+    CHECK_FALSE(s.submit(transaction("empty", 0)));
+    CHECK(s.submit(transaction("a", 1)));
+    CHECK(s.submit(transaction("b", 1)));
+    CHECK_FALSE(s.submit(transaction("c", 1)));
+    CHECK(s.size() == 2);
+}
+
+TEST_CASE("CommandSequencer: runs transactions in order across the queue wraparound", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(1000, 1);
+    const char* names[] = {"a", "b", "c", "d", "e"};
+    uint32_t now = 0;
+    SequenceStep step;
+    SequenceResult result;
+    for (const char* name : names) {
+        REQUIRE(s.submit(transaction(name, 1)));
+        REQUIRE(s.nextWrite(now, step));
+        s.onValue(step.member, step.index, step.value, now += 10);
+        REQUIRE(s.takeResult(result));
+        CHECK(std::string(result.name) == name);
+    }
+    CHECK_FALSE(s.busy());
+}
+
+TEST_CASE("CommandSequencer: with all result slots taken the oldest result is dropped", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(1000, 1);
+    const char* names[] = {"a", "b", "c"};
+    uint32_t now = 0;
+    SequenceStep step;
+    for (const char* name : names) {
+        REQUIRE(s.submit(transaction(name, 1)));
+        REQUIRE(s.nextWrite(now, step));
+        s.onValue(step.member, step.index, step.value, now += 10);
+    }
+
+    SequenceResult result;
+    REQUIRE(s.takeResult(result));
+    CHECK(std::string(result.name) == "b");
+    REQUIRE(s.takeResult(result));
+    CHECK(std::string(result.name) == "c");
+    CHECK_FALSE(s.takeResult(result));
+}
+
+TEST_CASE("CommandSequencer: configure drops queued transactions and results", "[sequencer]") {
+    CommandSequencer<2> s;
+    s.configure(1000, 1);
+    s.submit(transaction("a", 1));
+    SequenceStep step;
+    s.nextWrite(0, step);
+    s.nextWrite(1000, step);    // fails, result pending
+    s.submit(transaction("b", 1));
+
+    s.configure(1000, 1);
+    SequenceResult result;
+    CHECK_FALSE(s.busy());
+    CHECK_FALSE(s.takeResult(result));
+    CHECK_FALSE(s.nextWrite(5000, step));
+}
@@ -0,0 +1,158 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/json_writer.h"
+
+#include <string>
+
+// ============================================================================
+// Structure
+// ============================================================================
+
+TEST_CASE("JsonWriter: places commas between members and array elements", "[json]") {
+    char buf[128];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.field("name", "a");
+    json.beginArray("options").value("x").value("y").endArray();
+    json.beginObject("device").field("id", "d").endObject();
+    json.field("on", true);
+    json.endObject();
+
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) ==
+          R"({"name":"a","options":["x","y"],"device":{"id":"d"},"on":true})");
+    CHECK(json.size() == std::string(json.c_str()).size());
+}
+
+TEST_CASE("JsonWriter: empty objects and arrays", "[json]") {
+    char buf[32];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().beginArray("a").endArray().beginObject("o").endObject().endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == R"({"a":[],"o":{}})");
+}
+
+TEST_CASE("JsonWriter: open or mismatched nesting is not ok", "[json]") {
+    char buf[64];
+    JsonWriter open(buf, sizeof(buf));
+    open.beginObject().field("a", "b");
+    CHECK_FALSE(open.ok());
+    CHECK_FALSE(open.truncated());
+
+    JsonWriter extra(buf, sizeof(buf));
+    extra.beginObject().endObject().endObject();
+    CHECK_FALSE(extra.ok());
+
+    JsonWriter deep(buf, sizeof(buf));
+    for (int i = 0; i <= JsonWriter::MAX_DEPTH; i++)
+        deep.beginArray();
+    for (int i = 0; i <= JsonWriter::MAX_DEPTH; i++)
+        deep.endArray();
+    CHECK_FALSE(deep.ok());
+}
+
+// ============================================================================
+// Values
+// ============================================================================
+
+TEST_CASE("JsonWriter: escapes quotes, backslashes and control characters", "[json]") {
+    char buf[128];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().field("k", "a\"b\\c\nd\te\x01").endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == R"({"k":"a\"b\\c\nd\te\u0001"})");
+}
+
+TEST_CASE("JsonWriter: UTF-8 passes through unchanged", "[json]") {
+    char buf[64];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().field("name", "Wärmepumpe °C").endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == "{\"name\":\"Wärmepumpe °C\"}");
+}
+
+TEST_CASE("JsonWriter: numbers are formatted like std::ostream", "[json]") {
+    char buf[128];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.field("min", 20.0f);
+    json.field("max", 65.5f);
+    json.field("step", 0.1f);
+    json.field("count", 3);
+    json.field("off", false);
+    json.endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == R"({"min":20,"max":65.5,"step":0.1,"count":3,"off":false})");
+}
+
+TEST_CASE("JsonWriter: unsigned long numbers keep all digits", "[json]") {
+    char buf[64];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().field("duration", 12345678UL).field("sent", 0UL).endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == R"({"duration":12345678,"sent":0})");
+}
+
+TEST_CASE("JsonWriter: a null string is written as empty string", "[json]") {
+    char buf[32];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().field("icon", static_cast<const char*>(nullptr)).endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == R"({"icon":""})");
+}
+
+// ============================================================================
+// Truncation
+// ============================================================================
+
+TEST_CASE("JsonWriter: a payload that does not fit is flagged, buffer stays terminated", "[json]") {
+    char buf[16];
+    buf[15] = 'X';
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().field("name", "Außentemperatur").endObject();
+
+    CHECK(json.truncated());
+    CHECK_FALSE(json.ok());
+    CHECK(json.size() == sizeof(buf) - 1);
+    CHECK(buf[sizeof(buf) - 1] == '\0');
+}
+
+TEST_CASE("JsonWriter: a payload that exactly fills the buffer fits", "[json]") {
+    const std::string expected = R"({"a":"b"})";
+    char buf[10];
+    REQUIRE(sizeof(buf) == expected.size() + 1);
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().field("a", "b").endObject();
+    CHECK(json.ok());
+    CHECK(std::string(json.c_str()) == expected);
+}
+
+TEST_CASE("JsonWriter: rewind drops an element that did not fit", "[json]") {
+    char buf[40];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().beginArray("list");
+    json.value("first");
+    JsonWriter::Mark mark = json.mark();
+    json.value("an element far too long for the buffer");
+    CHECK(json.truncated());
+    json.rewind(mark);
+    json.endArray().endObject();
+    REQUIRE(json.ok());
+    CHECK(std::string(json.c_str()) == R"({"list":["first"]})");
+
+    // the first element after a rewind to an empty array gets no comma
+    JsonWriter empty(buf, sizeof(buf));
+    empty.beginArray();
+    mark = empty.mark();
+    empty.value("x");
+    empty.rewind(mark);
+    empty.value("y").endArray();
+    CHECK(std::string(empty.c_str()) == R"(["y"])");
+}
+
+TEST_CASE("JsonWriter: a zero-sized buffer is never written", "[json]") {
+    char buf[1] = {'X'};
+    JsonWriter json(buf, 0);
+    json.beginObject().endObject();
+    CHECK(json.truncated());
+    CHECK(buf[0] == 'X');
+}
@@ -3,6 +3,9 @@
 #include "../esphome/ha-stiebel-control/elster/NUtils.h"
 #include "../esphome/ha-stiebel-control/elster/ElsterTable.h"
 #include "../esphome/ha-stiebel-control/elster/KElsterTable.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 // ============================================================================
 // SetValueType
@@ -124,6 +127,153 @@ TEST_CASE("SetDoubleType: default type uses %g", "[kelster]") {
     CHECK(std::string(val) == "100");
 }
 
+// ============================================================================
+// SetValueType fixed-point paths vs. the former sprintf formatting
+// ============================================================================
+// The sprintf calls SetValueType used before the integer formatter, and the
+// SetDoubleType call processCanMessage made for et_double_val / et_triple_val.
+static void sprintfValueType(char* val, unsigned char type, unsigned short value) {
+    if (type == et_double_val || type == et_triple_val) {
+        SetDoubleType(val, type, static_cast<double>(value));
+        return;
+    }
+    if (value == 0x8000) { strcpy(val, "-255"); return; }
+    switch (type) {
+        case et_byte:          sprintf(val, "%d", (signed char)value); break;
+        case et_dec_val:       sprintf(val, "%.1f", ((double)((signed short)value)) / 10.0); break;
+        case et_cent_val:      sprintf(val, "%.2f", ((double)((signed short)value)) / 100.0); break;
+        case et_mil_val:       sprintf(val, "%.3f", ((double)((signed short)value)) / 1000.0); break;
+        case et_little_endian: sprintf(val, "%d", (value >> 8) + 256*(value & 0xff)); break;
+        case et_dev_nr:
+            if (value >= 0x80) strcpy(val, "--");
+            else sprintf(val, "%d", value + 1);
+            break;
+        default:               sprintf(val, "%d", (signed short)value); break;
+    }
+}
+
+TEST_CASE("SetValueType: numeric types match sprintf for all 16-bit values", "[kelster]") {
+    const unsigned char types[] = { et_default, et_dec_val, et_cent_val, et_mil_val, et_byte,
+                                    et_double_val, et_triple_val, et_little_endian, et_dev_nr };
+    for (unsigned char type : types) {
+        size_t mismatches = 0, longest = 0;
+        for (unsigned value = 0; value <= 0xFFFF; value++) {
+            char expected[32], actual[32];
+            sprintfValueType(expected, type, (unsigned short)value);
+            SetValueType(actual, type, (unsigned short)value);
+            if (strcmp(expected, actual) != 0)
+                mismatches++;
+            longest = std::max(longest, strlen(actual));
+        }
+        INFO("type " << ElsterTypeToName(type));
+        CHECK(mismatches == 0);
+        CHECK(longest < 16);
+    }
+}
+TEST_CASE("SetValueType: et_double_val and et_triple_val have no 0x8000 sentinel", "[kelster]") {
+    char val[32];
+    SetValueType(val, et_double_val, 0x8000);
+    CHECK(std::string(val) == "32768.000");
+    SetValueType(val, et_triple_val, 0xFFFF);
+    CHECK(std::string(val) == "65535.000000");
+}
+TEST_CASE("SetValueType: every type fits cElsterValueSize", "[kelster]") {
+    for (unsigned type = et_default; type <= et_dev_id; type++) {
+        size_t longest = 0;
+        for (unsigned value = 0; value <= 0xFFFF; value++) {
+            char val[64];
+            SetValueType(val, (unsigned char)type, (unsigned short)value);
+            longest = std::max(longest, strlen(val));
+        }
+        INFO("type " << ElsterTypeToName(type));
+        CHECK(longest < cElsterValueSize);
+    }
+}
+
+TEST_CASE("SetValueType: et_err_nr matches ErrorList scan for all 16-bit values", "[kelster]") {
+    size_t mismatches = 0;
+    for (unsigned value = 0; value <= 0xFFFF; value++) {
+        char expected[32], actual[32];
+        sprintf(expected, "ERR %d", value);
+        for (const ErrorIndex& err : ErrorList)
+            if (err.Index == value) {
+                strcpy(expected, err.Name);
+                break;
+            }
+        SetValueType(actual, et_err_nr, (unsigned short)value);
+        if (value != 0x8000 && strcmp(expected, actual) != 0)
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+TEST_CASE("SetValueType: et_betriebsart decodes every BetriebsartList entry", "[kelster]") {
+    char val[32];
+    for (const ErrorIndex& b : BetriebsartList) {
+        SetValueType(val, et_betriebsart, b.Index);
+        CHECK(std::string(val) == b.Name);
+    }
+    SetValueType(val, et_betriebsart, 0x0600);
+    CHECK(std::string(val) == "?");
+    SetValueType(val, et_betriebsart, 0x0201);
+    CHECK(std::string(val) == "?");
+}
+
+// ============================================================================
+// DecodeElsterValue / ElsterValueToFloat / ElsterValueText
+// ============================================================================
+TEST_CASE("DecodeElsterValue: et_dec_val carries fixed-point number", "[kelster]") {
+    ElsterValue v;
+    DecodeElsterValue(v, et_dec_val, (unsigned short)(short)(-55));
+    CHECK(v.Raw == 0xFFC9);
+    CHECK(v.hasNumber);
+    CHECK(v.Fixed == -55);
+    CHECK(v.Decimals == 1);
+    CHECK(ElsterValueToFloat(v) == -5.5f);
+    CHECK(std::string(ElsterValueText(v)) == "-5.5");
+}
+TEST_CASE("DecodeElsterValue: bool types map on/off to 1/0", "[kelster]") {
+    ElsterValue v;
+    DecodeElsterValue(v, et_little_bool, 0x0100);
+    CHECK((v.hasNumber && v.Fixed == 1));
+    DecodeElsterValue(v, et_bool, 0);
+    CHECK((v.hasNumber && v.Fixed == 0));
+    DecodeElsterValue(v, et_bool, 42);
+    CHECK(!v.hasNumber);
+}
+TEST_CASE("DecodeElsterValue: text types have no number", "[kelster]") {
+    ElsterValue v;
+    DecodeElsterValue(v, et_zeit, (unsigned short)(14 | (30 << 8)));
+    CHECK(!v.hasNumber);
+    CHECK(std::isnan(ElsterValueToFloat(v)));
+    CHECK(std::string(ElsterValueText(v)) == "14:30");
+}
+TEST_CASE("DecodeElsterValue: number agrees with the text for all types and 16-bit values", "[kelster]") {
+    for (unsigned type = et_default; type <= et_dev_id; type++) {
+        size_t mismatches = 0;
+        for (unsigned raw = 0; raw <= 0xFFFF; raw++) {
+            char text[32];
+            SetValueType(text, (unsigned char)type, (unsigned short)raw);
+            ElsterValue v;
+            DecodeElsterValue(v, (unsigned char)type, (unsigned short)raw);
+
+            // a number is what the text parses to completely; on/off are 1/0
+            char* end;
+            float parsed = strtof(text, &end);
+            bool numeric = end != text && *end == '\0';
+            if (strcmp(text, "on") == 0)  { numeric = true; parsed = 1; }
+            if (strcmp(text, "off") == 0) { numeric = true; parsed = 0; }
+
+            bool ok = v.hasNumber == numeric && strcmp(ElsterValueText(v), text) == 0;
+            if (ok && numeric)
+                ok = ElsterValueToFloat(v) == parsed;
+            if (!ok)
+                mismatches++;
+        }
+        INFO("type " << ElsterTypeToName(type));
+        CHECK(mismatches == 0);
+    }
+}
+
 // ============================================================================
 // GetElsterType
 // ============================================================================
@@ -136,6 +286,16 @@ TEST_CASE("GetElsterType: unknown name returns et_default", "[kelster]") {
     CHECK(GetElsterType("garbage") == et_default);
     CHECK(GetElsterType(nullptr)   == et_default);
 }
+TEST_CASE("GetElsterType: every type name round-trips", "[kelster]") {
+    for (unsigned i = 0; i <= High(ElsterTypeStr); i++)
+        CHECK(GetElsterType(ElsterTypeStr[i]) == (ElsterType)i);
+}
+TEST_CASE("GetElsterType: prefixes and extensions of a name return et_default", "[kelster]") {
+    CHECK(GetElsterType("et_dec")      == et_default);
+    CHECK(GetElsterType("et_bool_")    == et_default);
+    CHECK(GetElsterType("")            == et_default);
+    CHECK(GetElsterType("et_dev_idx")  == et_default);
+}
 
 // ============================================================================
 // ElsterTypeToName
@@ -159,11 +319,33 @@ TEST_CASE("GetElsterIndex by name: unknown returns INDEX_NOT_FOUND sentinel", "[
     const ElsterIndex* ei = GetElsterIndex("DOES_NOT_EXIST");
     CHECK(std::string(ei->Name) == "INDEX_NOT_FOUND");
 }
-TEST_CASE("GetElsterIndex by name: cache hit returns same pointer", "[kelster]") {
+TEST_CASE("GetElsterIndex by name: repeated lookup returns same pointer", "[kelster]") {
     const ElsterIndex* a = GetElsterIndex("HYSTERESEZEIT");
     const ElsterIndex* b = GetElsterIndex("HYSTERESEZEIT");
     CHECK(a == b);
 }
+TEST_CASE("GetElsterIndex by name: null returns INDEX_NOT_FOUND sentinel", "[kelster]") {
+    CHECK(std::string(GetElsterIndex((const char*)nullptr)->Name) == "INDEX_NOT_FOUND");
+}
+TEST_CASE("GetElsterIndex by name: prefixes and extensions of a name are not found", "[kelster]") {
+    CHECK(std::string(GetElsterIndex("HYSTERESEZEI")->Name)   == "INDEX_NOT_FOUND");
+    CHECK(std::string(GetElsterIndex("HYSTERESEZEITX")->Name) == "INDEX_NOT_FOUND");
+    CHECK(std::string(GetElsterIndex("")->Name)               == "INDEX_NOT_FOUND");
+    CHECK(std::string(GetElsterIndex("hysteresezeit")->Name)  == "INDEX_NOT_FOUND");
+}
+TEST_CASE("GetElsterIndex by name: sorted index matches linear scan for every entry", "[kelster]") {
+    for (size_t i = 0; i < ElsterTableCount; i++) {
+        // First row with this name, as the original linear scan returned it
+        size_t first = 0;
+        while (strcmp(ElsterTable[first].Name, ElsterTable[i].Name) != 0)
+            first++;
+        const ElsterIndex* actual = GetElsterIndex(ElsterTable[i].Name);
+        if (strcmp(actual->Name, ElsterTable[i].Name) != 0 ||
+            actual->Index != ElsterTable[first].Index || actual->Type != ElsterTable[first].Type)
+            FAIL_CHECK("mismatch for name " << ElsterTable[i].Name);
+    }
+    SUCCEED();
+}
 
 // ============================================================================
 // GetElsterIndex by index
@@ -179,6 +361,85 @@ TEST_CASE("GetElsterIndex by index: unknown index returns INDEX_NOT_FOUND sentin
     CHECK(std::string(ei->Name) == "INDEX_NOT_FOUND");
 }
 
+// Reference implementation: the original first-match linear scan
+static const ElsterIndex* linearScanIndex(unsigned short index) {
+    for (size_t i = 0; i < ElsterTableCount; i++)
+        if (ElsterTable[i].Index == index)
+            return &ElsterTable[i];
+    return &ElsterTable[0];
+}
+
+TEST_CASE("GetElsterIndex by index: page table matches linear scan for every entry", "[kelster]") {
+    // Compare by name/type — this TU has its own copy of the static ElsterTable
+    for (size_t i = 0; i < ElsterTableCount; i++) {
+        const ElsterIndex* expected = linearScanIndex(ElsterTable[i].Index);
+        const ElsterIndex* actual = GetElsterIndex(ElsterTable[i].Index);
+        if (strcmp(actual->Name, expected->Name) != 0 || actual->Type != expected->Type)
+            FAIL_CHECK("mismatch for index 0x" << std::hex << ElsterTable[i].Index
+                       << ": " << actual->Name << " != " << expected->Name);
+    }
+    SUCCEED();
+}
+TEST_CASE("GetElsterIndex by index: page table matches linear scan for all 16-bit values", "[kelster]") {
+    std::vector<const ElsterIndex*> expected(0x10000, &ElsterTable[0]);
+    for (size_t i = ElsterTableCount; i-- > 0; )
+        expected[ElsterTable[i].Index] = &ElsterTable[i];  // backwards: first match wins
+
+    size_t mismatches = 0;
+    for (unsigned index = 0; index <= 0xFFFF; index++)
+        if (strcmp(GetElsterIndex((unsigned short)index)->Name, expected[index]->Name) != 0)
+            mismatches++;
+    CHECK(mismatches == 0);
+}
+
+// ============================================================================
+// ElsterTable hot/cold split
+// ============================================================================
+static bool sameString(const char* a, const char* b) {
+    return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+TEST_CASE("ElsterTable: compact rows match source rows", "[kelster]") {
+    REQUIRE(ElsterTableCount == High(ElsterTableRows) + 1);
+    for (size_t i = 0; i < ElsterTableCount; i++) {
+        const ElsterTableRow& src = ElsterTableRows[i];
+        const ElsterIndex& row = ElsterTable[i];
+        if (!sameString(row.Name, src.Name) || row.Index != src.Index ||
+            row.Type != src.Type || row.isBlacklisted != src.isBlacklisted)
+            FAIL_CHECK("row mismatch at " << i << " (" << src.Name << ")");
+    }
+    SUCCEED();
+}
+
+TEST_CASE("GetElsterMetadata: present exactly for rows with hasMetadata", "[kelster]") {
+    for (size_t i = 0; i < ElsterTableCount; i++) {
+        const ElsterTableRow& src = ElsterTableRows[i];
+        const ElsterMetadata* meta = GetElsterMetadata(&ElsterTable[i]);
+        if ((meta != nullptr) != src.hasMetadata) {
+            FAIL_CHECK("metadata presence mismatch for " << src.Name);
+            continue;
+        }
+        if (meta && !(sameString(meta->friendlyName, src.friendlyName) &&
+                      sameString(meta->haComponent, src.haComponent) &&
+                      sameString(meta->haDeviceClass, src.haDeviceClass) &&
+                      sameString(meta->unit, src.unit) &&
+                      sameString(meta->stateClass, src.stateClass) &&
+                      sameString(meta->icon, src.icon) &&
+                      sameString(meta->payloadOn, src.payloadOn) &&
+                      sameString(meta->payloadOff, src.payloadOff)))
+            FAIL_CHECK("metadata mismatch for " << src.Name);
+    }
+    SUCCEED();
+}
+
+TEST_CASE("GetElsterMetadata: null and sentinel rows have no metadata", "[kelster]") {
+    CHECK(GetElsterMetadata(nullptr) == nullptr);
+    CHECK(GetElsterMetadata(GetElsterIndex((unsigned short)0xFFFF)) == nullptr);
+    const ElsterMetadata* meta = GetElsterMetadata(GetElsterIndex("EVU_SPERRE_AKTIV"));
+    REQUIRE(meta != nullptr);
+    CHECK(meta->payloadOn != nullptr);
+}
+
 // ============================================================================
 // TranslateString — round-trip: SetValueType output → TranslateString input
 // ============================================================================
@@ -218,6 +479,25 @@ TEST_CASE("TranslateString: et_betriebsart Automatik", "[kelster]") {
     int result = TranslateString(s, et_betriebsart);
     CHECK(result >= 0); // Valid betriebsart index
 }
+TEST_CASE("TranslateString: et_betriebsart every name round-trips", "[kelster]") {
+    for (unsigned i = 0; i <= High(BetriebsartList); i++) {
+        const char* s = BetriebsartList[i].Name;
+        CHECK(TranslateString(s, et_betriebsart) == BetriebsartList[i].Index);
+        CHECK(*s == '\0');
+    }
+}
+TEST_CASE("TranslateString: et_betriebsart consumes only the name", "[kelster]") {
+    const char* s = "Tagbetrieb 2";
+    CHECK(TranslateString(s, et_betriebsart) == 0x0300);
+    CHECK(std::string(s) == " 2");
+}
+TEST_CASE("TranslateString: et_betriebsart unknown or partial name returns -1", "[kelster]") {
+    for (const char* in : {"", "Auto", "automatik", "Zzz", "Absenk", "Warmwasse"}) {
+        const char* s = in;
+        INFO(in);
+        CHECK(TranslateString(s, et_betriebsart) == -1);
+    }
+}
 TEST_CASE("TranslateString: et_default parses integer", "[kelster]") {
     const char* s = "42";
     CHECK(TranslateString(s, et_default) == 42);
@@ -0,0 +1,97 @@
+/*
+ * Tests for KElsterTable.cpp built with a per-model signal set
+ * (-DELSTER_SIGNAL_SET='"signal_set_wpl13e.h"', see Makefile).
+ * Linked into tests/run_tests_pruned; the full-table tests live in test_kelster.cpp.
+ */
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/elster/ElsterTable.h"
+#include "../esphome/ha-stiebel-control/elster/KElsterTable.h"
+#include "../esphome/ha-stiebel-control/signal_set_wpl13e.h"
+
+#include <string>
+#include <vector>
+
+static bool inSignalSet(const char* name) {
+    for (const char* s : ElsterSignalSet)
+        if (strcmp(s, name) == 0)
+            return true;
+    return false;
+}
+
+// ============================================================================
+// Pruned ElsterTable
+// ============================================================================
+TEST_CASE("pruned: table holds INDEX_NOT_FOUND and the signal set only", "[pruned]") {
+    REQUIRE(ElsterTableCount > 1);
+    CHECK(std::string(ElsterTable[0].Name) == "INDEX_NOT_FOUND");
+    for (unsigned i = 1; i < ElsterTableCount; i++)
+        if (!inSignalSet(ElsterTable[i].Name))
+            FAIL_CHECK("row outside the signal set: " << ElsterTable[i].Name);
+    CHECK(ElsterTableCount < High(ElsterTableRows) / 10);
+}
+
+TEST_CASE("pruned: every signal set name resolves by name", "[pruned]") {
+    for (const char* name : ElsterSignalSet)
+        CHECK(std::string(GetElsterIndex(name)->Name) == name);
+}
+
+TEST_CASE("pruned: names outside the signal set are not found", "[pruned]") {
+    CHECK(std::string(GetElsterIndex("HYSTERESEZEIT")->Name) == "INDEX_NOT_FOUND");
+    CHECK(std::string(GetElsterIndex("PPL")->Name) == "INDEX_NOT_FOUND");
+}
+
+TEST_CASE("pruned: metadata of kept rows matches the source rows", "[pruned]") {
+    const ElsterMetadata* meta = GetElsterMetadata(GetElsterIndex("EVU_SPERRE_AKTIV"));
+    REQUIRE(meta != nullptr);
+    CHECK(std::string(meta->haComponent) == "binary_sensor");
+    CHECK(std::string(meta->payloadOn) == "on");
+}
+
+// ============================================================================
+// Index lookup with type fallback
+// ============================================================================
+// Expected result for every 16-bit value: the first kept row with that index,
+// else a blacklisted UNLISTED row with that index and the type of the first
+// source row, else INDEX_NOT_FOUND (also for unknown and et_default indexes).
+TEST_CASE("pruned: index lookup matches kept rows and type fallback for all 16-bit values", "[pruned]") {
+    std::vector<int> kept(0x10000, -1), source(0x10000, -1);
+    for (size_t i = High(ElsterTableRows) + 1; i-- > 0; ) {
+        source[ElsterTableRows[i].Index] = (int)i;
+        if (i == 0 || inSignalSet(ElsterTableRows[i].Name))
+            kept[ElsterTableRows[i].Index] = (int)i;
+    }
+
+    size_t mismatches = 0;
+    for (unsigned index = 0; index <= 0xFFFF; index++) {
+        const ElsterIndex* ei = GetElsterIndex((unsigned short)index);
+        bool ok;
+        if (kept[index] >= 0 && index != 0)
+            ok = strcmp(ei->Name, ElsterTableRows[kept[index]].Name) == 0
+                 && ei->isBlacklisted == ElsterTableRows[kept[index]].isBlacklisted;
+        else if (source[index] >= 0 && index != 0 && ElsterTableRows[source[index]].Type != et_default)
+            ok = strcmp(ei->Name, "UNLISTED") == 0 && ei->isBlacklisted && ei->Index == index
+                 && ei->Type == ElsterTableRows[source[index]].Type;
+        else
+            ok = ei == &ElsterTable[0];
+        if (!ok)
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE("pruned: unlisted index decodes with its type but is blacklisted", "[pruned]") {
+    // SPEICHER_STATUS: et_little_endian, not in the WPL13E signal set
+    const ElsterIndex* ei = GetElsterIndex("SPEICHER_STATUS");
+    CHECK(ei == &ElsterTable[0]);
+    for (size_t i = 0; i <= High(ElsterTableRows); i++) {
+        if (strcmp(ElsterTableRows[i].Name, "SPEICHER_STATUS") == 0) {
+            const ElsterIndex* unlisted = GetElsterIndex(ElsterTableRows[i].Index);
+            CHECK(std::string(unlisted->Name) == "UNLISTED");
+            CHECK(unlisted->Index == ElsterTableRows[i].Index);
+            CHECK(unlisted->Type == ElsterTableRows[i].Type);
+            CHECK(unlisted->isBlacklisted);
+            CHECK(GetElsterMetadata(unlisted) == nullptr);
+            break;
+        }
+    }
+}
@@ -0,0 +1,456 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/request_scheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+// ============================================================================
+// deadlineReached / deadlineBefore
+// ============================================================================
+
+TEST_CASE("deadlineReached: plain comparison away from the wraparound", "[scheduler]") {
+    CHECK(deadlineReached(1000, 1000));
+    CHECK(deadlineReached(1001, 1000));
+    CHECK_FALSE(deadlineReached(999, 1000));
+}
+
+TEST_CASE("deadlineReached: stays correct across the 49.7 day millis() wraparound", "[scheduler]") {
+    const uint32_t beforeWrap = 0xFFFFFF00u;
+    const uint32_t afterWrap  = beforeWrap + 0x200u;   // wrapped to 0x100
+    CHECK(afterWrap == 0x100u);
+    CHECK_FALSE(deadlineReached(beforeWrap, afterWrap));
+    CHECK(deadlineReached(afterWrap, afterWrap));
+    CHECK(deadlineReached(afterWrap, beforeWrap));
+    CHECK(deadlineBefore(beforeWrap, afterWrap));
+    CHECK_FALSE(deadlineBefore(afterWrap, beforeWrap));
+}
+
+// ============================================================================
+// RequestScheduler
+// ============================================================================
+
+TEST_CASE("RequestScheduler: pops in deadline order, equal deadlines in slot order", "[scheduler]") {
+    RequestScheduler s;
+    s.reset(8);
+    s.schedule(3, 500);
+    s.schedule(1, 200);
+    s.schedule(4, 200);
+    s.schedule(0, 900);
+    s.schedule(2, 100);
+    REQUIRE(s.size() == 5);
+    CHECK(s.nextDeadline() == 100);
+
+    std::vector<uint16_t> order;
+    while (!s.empty())
+        order.push_back(s.pop());
+    CHECK(order == std::vector<uint16_t>{2, 1, 4, 3, 0});
+}
+
+TEST_CASE("RequestScheduler: due() only reports reached deadlines", "[scheduler]") {
+    RequestScheduler s;
+    s.reset(2);
+    CHECK_FALSE(s.due(0));
+    s.schedule(7, 1000);
+    CHECK_FALSE(s.due(999));
+    CHECK(s.due(1000));
+    CHECK(s.pop() == 7);
+    CHECK_FALSE(s.due(5000));
+}
+
+TEST_CASE("RequestScheduler: orders deadlines on both sides of the wraparound", "[scheduler]") {
+    RequestScheduler s;
+    s.reset(3);
+    s.schedule(0, 0x00000100u);   // after the wrap
+    s.schedule(1, 0xFFFFFF00u);   // before the wrap
+    s.schedule(2, 0x00000000u);   // at the wrap
+    CHECK(s.pop() == 1);
+    CHECK(s.pop() == 2);
+    CHECK(s.pop() == 0);
+}
+
+TEST_CASE("RequestScheduler: reschedule() moves a queued slot either way", "[scheduler]") {
+    RequestScheduler s;
+    s.reset(4);
+    s.schedule(0, 100);
+    s.schedule(1, 200);
+    s.schedule(2, 300);
+    s.schedule(3, 90000);
+    CHECK(s.reschedule(3, 150));      // earlier
+    CHECK(s.reschedule(0, 250));      // later
+    CHECK_FALSE(s.reschedule(9, 1));  // not queued
+    std::vector<uint16_t> order;
+    while (!s.empty())
+        order.push_back(s.pop());
+    CHECK(order == std::vector<uint16_t>{3, 1, 0, 2});
+}
+
+TEST_CASE("RequestScheduler: remove() takes a slot out and keeps the order", "[scheduler]") {
+    RequestScheduler s;
+    s.reset(6);
+    for (uint16_t slot = 0; slot < 6; slot++)
+        s.schedule(slot, 1000 - slot * 100);   // slot 5 first
+    CHECK(s.remove(5));
+    CHECK(s.remove(2));
+    CHECK_FALSE(s.remove(2));
+    std::vector<uint16_t> order;
+    while (!s.empty())
+        order.push_back(s.pop());
+    CHECK(order == std::vector<uint16_t>{4, 3, 1, 0});
+}
+
+TEST_CASE("RequestScheduler: matches a sorted reference over random schedule/pop sequences", "[scheduler]") {
+    struct Ref { uint32_t deadline; uint16_t slot; };
+    RequestScheduler s;
+    s.reset(512);
+    std::vector<Ref> ref;
+    uint32_t state = 12345;
+    const uint32_t base = 0xFFFF0000u;   // runs through the wraparound
+    size_t mismatches = 0;
+
+    for (int step = 0; step < 5000; step++) {
+        state = state * 1103515245u + 12345u;
+        if (ref.size() < 400 && (ref.empty() || (state >> 16) % 3 != 0)) {
+            uint32_t deadline = base + ((state >> 8) % 0x20000u);
+            uint16_t slot = static_cast<uint16_t>(step);
+            s.schedule(slot, deadline);
+            ref.push_back({deadline, slot});
+        } else {
+            auto earliest = std::min_element(ref.begin(), ref.end(), [&](const Ref& a, const Ref& b) {
+                if (a.deadline != b.deadline)
+                    return static_cast<int32_t>(a.deadline - b.deadline) < 0;
+                return a.slot < b.slot;
+            });
+            if (s.pop() != earliest->slot)
+                mismatches++;
+            ref.erase(earliest);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(s.size() == ref.size());
+}
+
+// ============================================================================
+// RequestPacer
+// ============================================================================
+
+TEST_CASE("RequestPacer: starts with one frame, then refills at the budget rate", "[scheduler]") {
+    RequestPacer p;
+    p.configure(10, 20, 0);
+    REQUIRE(p.ready(0));
+    p.sent(0);
+    CHECK_FALSE(p.ready(0));
+    CHECK_FALSE(p.ready(99));
+    CHECK(p.ready(100));
+}
+
+TEST_CASE("RequestPacer: bursts up to one second of budget, spaced by the gap", "[scheduler]") {
+    RequestPacer p;
+    p.configure(10, 20, 0);
+    // idle for 5 s: the bucket holds 10 frames, not 50
+    uint32_t now = 5000;
+    int burst = 0;
+    while (p.ready(now)) {
+        p.sent(now);
+        burst++;
+        CHECK_FALSE(p.ready(now + 19));
+        now += 20;
+    }
+    // 10 from the bucket, plus the refill while they were spaced by the gap
+    CHECK(burst >= 10);
+    CHECK(burst <= 13);
+}
+
+TEST_CASE("RequestPacer: zero budget never sends", "[scheduler]") {
+    RequestPacer p;
+    p.configure(0, 20, 0);
+    CHECK_FALSE(p.ready(0));
+    CHECK_FALSE(p.ready(100000));
+}
+
+TEST_CASE("RequestPacer: keeps pacing across the millis() wraparound", "[scheduler]") {
+    RequestPacer p;
+    const uint32_t start = 0xFFFFFFFFu - 1000;
+    p.configure(10, 20, start);
+    int sent = 0;
+    for (uint32_t i = 0; i < 5000; i++) {
+        uint32_t now = start + i;
+        if (p.ready(now)) {
+            p.sent(now);
+            sent++;
+        }
+    }
+    // one initial frame plus 10 per second
+    CHECK(sent >= 49);
+    CHECK(sent <= 51);
+}
+
+// ============================================================================
+// TxQueue
+// ============================================================================
+
+TEST_CASE("TxQueue: first in, first out across the end of the ring", "[scheduler]") {
+    TxQueue<3> q;
+    CHECK(q.empty());
+    for (uint16_t round = 0; round < 4; round++) {
+        CHECK(q.push({0, static_cast<uint16_t>(2 * round), 0, 1, true}));
+        CHECK(q.push({0, static_cast<uint16_t>(2 * round + 1), 0, 1, false}));
+        CHECK(q.front().index == 2 * round);
+        CHECK(q.front().write);
+        q.pop();
+        CHECK(q.front().index == 2 * round + 1);
+        q.pop();
+    }
+    CHECK(q.empty());
+}
+
+TEST_CASE("TxQueue: rejects requests once full", "[scheduler]") {
+    TxQueue<2> q;
+    CHECK(q.push({10, 1, 0, 1, false}));
+    CHECK(q.push({20, 2, 0, 1, false}));
+    CHECK(q.full());
+    CHECK_FALSE(q.push({30, 3, 0, 1, false}));
+    CHECK(q.size() == 2);
+    CHECK(q.front().queuedMs == 10);
+    q.clear();
+    CHECK(q.empty());
+}
+
+// ============================================================================
+// BusLoadLimiter
+// ============================================================================
+
+static const BusLoadLimiter::Config busConfig = {20000, 1000, 50, 30, 3, 2, 30};
+
+TEST_CASE("BusLoadLimiter: frame bits include framing and stuff bits", "[scheduler]") {
+    CHECK(BusLoadLimiter::frameBits(0) == 47 + 6);
+    CHECK(BusLoadLimiter::frameBits(7) == 47 + 56 + 18);
+    CHECK(BusLoadLimiter::frameBits(8) == BusLoadLimiter::frameBits(15));
+}
+
+TEST_CASE("BusLoadLimiter: utilisation of the last window", "[scheduler]") {
+    BusLoadLimiter b;
+    b.configure(busConfig, 10, 0);
+    // 83 seven-byte frames = 10043 bits of 20000 per second
+    for (int i = 0; i < 83; i++)
+        b.frameSeen(7);
+    CHECK_FALSE(b.update(999, 0));
+    CHECK(b.update(1000, 0));
+    CHECK(b.loadPercent() == 50);
+    // the next window starts empty
+    CHECK(b.update(2000, 0));
+    CHECK(b.loadPercent() == 0);
+}
+
+TEST_CASE("BusLoadLimiter: halves the budget under high load, adds one when idle", "[scheduler]") {
+    BusLoadLimiter b;
+    b.configure(busConfig, 10, 0);
+    for (int i = 0; i < 100; i++)
+        b.frameSeen(8);
+    b.update(1000, 0);
+    CHECK(b.loadPercent() > 50);
+    CHECK(b.budget() == 5);
+
+    b.update(2000, 0);   // idle window
+    CHECK(b.budget() == 6);
+
+    for (int i = 0; i < 60; i++)   // ~40 %: between the limits
+        b.frameSeen(8);
+    b.update(3000, 0);
+    CHECK(b.budget() == 6);
+}
+
+TEST_CASE("BusLoadLimiter: backs off on lost arbitrations", "[scheduler]") {
+    BusLoadLimiter b;
+    b.configure(busConfig, 16, 0);
+    b.update(1000, 500);      // first reading of the running count: no delta yet
+    CHECK(b.arbLost() == 0);
+    CHECK(b.budget() == 17);
+    b.update(2000, 502);
+    CHECK(b.arbLost() == 2);
+    CHECK(b.budget() == 18);
+    b.update(3000, 505);
+    CHECK(b.arbLost() == 3);
+    CHECK(b.budget() == 9);
+}
+
+TEST_CASE("BusLoadLimiter: budget stays within its limits", "[scheduler]") {
+    BusLoadLimiter b;
+    b.configure(busConfig, 100, 0);
+    CHECK(b.budget() == 30);
+    for (uint32_t t = 1000; t <= 10000; t += 1000)
+        b.update(t, 0);
+    CHECK(b.budget() == 30);
+
+    for (uint32_t t = 11000; t <= 20000; t += 1000) {
+        for (int i = 0; i < 200; i++)
+            b.frameSeen(8);
+        b.update(t, 0);
+    }
+    CHECK(b.loadPercent() == 100);
+    CHECK(b.budget() == 2);
+}
+
+// ============================================================================
+// OutstandingRequests
+// ============================================================================
+
+TEST_CASE("OutstandingRequests: a response completes its request with the round-trip time", "[scheduler]") {
+    OutstandingRequests t;
+    t.reset(4);
+    REQUIRE(t.add(1, 0x000c, 1000, 1));
+    REQUIRE(t.add(2, 0x000c, 1010, 1, 7));
+    OutstandingRequest req;
+    CHECK_FALSE(t.complete(1, 0x000d, req));   // other index
+    REQUIRE(t.complete(2, 0x000c, req));
+    CHECK(1050 - req.sentMs == 40);
+    CHECK(req.slot == 7);
+    CHECK_FALSE(t.complete(2, 0x000c, req));   // already answered
+    REQUIRE(t.complete(1, 0x000c, req));
+    CHECK(req.slot == OutstandingRequest::NO_SLOT);
+    CHECK(t.empty());
+}
+
+TEST_CASE("OutstandingRequests: a new request for the same pair replaces the old one", "[scheduler]") {
+    OutstandingRequests t;
+    t.reset(4);
+    t.add(1, 0x0126, 1000, 1);
+    t.add(1, 0x0126, 3000, 2);
+    CHECK(t.size() == 1);
+    OutstandingRequest req;
+    REQUIRE(t.complete(1, 0x0126, req));
+    CHECK(req.sentMs == 3000);
+    CHECK(req.attempts == 2);
+}
+
+TEST_CASE("OutstandingRequests: capacity is fixed", "[scheduler]") {
+    OutstandingRequests t;
+    t.reset(2);
+    CHECK(t.add(1, 1, 0, 1));
+    CHECK(t.add(1, 2, 0, 1));
+    CHECK_FALSE(t.add(1, 3, 0, 1));
+    CHECK(t.add(1, 2, 5, 1));   // replacing still works
+    CHECK(t.size() == 2);
+}
+
+TEST_CASE("OutstandingRequests: takeExpired returns each timed out request once", "[scheduler]") {
+    OutstandingRequests t;
+    t.reset(4);
+    const uint32_t start = 0xFFFFFC00u;   // times out after the wraparound
+    t.add(6, 0x0001, start, 1);
+    t.add(6, 0x0002, start + 1500, 2);
+    OutstandingRequest req;
+    CHECK_FALSE(t.takeExpired(start + 1999, 2000, req));
+    REQUIRE(t.takeExpired(start + 2000, 2000, req));
+    CHECK(req.member == 6);
+    CHECK(req.index == 0x0001);
+    CHECK(req.attempts == 1);
+    CHECK_FALSE(t.takeExpired(start + 2000, 2000, req));
+    REQUIRE(t.takeExpired(start + 3500, 2000, req));
+    CHECK(req.attempts == 2);
+    CHECK(t.empty());
+}
+
+// ============================================================================
+// RttHistogram
+// ============================================================================
+
+TEST_CASE("RttHistogram: empty histogram reports 0", "[scheduler]") {
+    RttHistogram h;
+    CHECK(h.samples() == 0);
+    CHECK(h.percentile(50) == 0);
+}
+
+TEST_CASE("RttHistogram: percentiles fall into the right power-of-two bucket", "[scheduler]") {
+    RttHistogram h;
+    for (int i = 0; i < 90; i++)
+        h.record(40);     // [32, 64)
+    for (int i = 0; i < 10; i++)
+        h.record(300);    // [256, 512)
+    CHECK(h.samples() == 100);
+    CHECK(h.percentile(50) >= 32);
+    CHECK(h.percentile(50) < 64);
+    CHECK(h.percentile(90) < 64);
+    CHECK(h.percentile(95) >= 256);
+    CHECK(h.percentile(95) < 512);
+    CHECK(h.percentile(100) < 512);
+}
+
+TEST_CASE("RttHistogram: zero and very long round trips", "[scheduler]") {
+    RttHistogram h;
+    h.record(0);
+    CHECK(h.percentile(50) == 0);
+    h.record(1);
+    CHECK(h.percentile(100) == 1);
+    h.record(0xFFFFFFFFu);   // lands in the last bucket
+    CHECK(h.percentile(100) == 1u << (RttHistogram::BUCKETS - 2));
+}
+
+// ============================================================================
+// ResponderMap
+// ============================================================================
+
+TEST_CASE("ResponderMap: stores and updates the members per index", "[scheduler]") {
+    ResponderMap<4> m = {};
+    CHECK(m.get(0x0126) == 0);
+    CHECK(m.set(0x0126, 0x2));
+    CHECK_FALSE(m.set(0x0126, 0x2));   // unchanged
+    CHECK(m.set(0x0126, 0x3));
+    CHECK(m.get(0x0126) == 0x3);
+    CHECK(m.count == 1);
+}
+
+TEST_CASE("ResponderMap: keeps its size once full and rejects a foreign blob", "[scheduler]") {
+    ResponderMap<2> m = {};
+    CHECK(m.set(1, 1));
+    CHECK(m.set(2, 1));
+    CHECK_FALSE(m.set(3, 1));
+    CHECK(m.get(3) == 0);
+    CHECK(m.set(2, 4));   // known indexes still update
+    CHECK(m.valid());
+    m.count = 3;
+    CHECK_FALSE(m.valid());
+    m.clear();
+    CHECK(m.get(1) == 0);
+}
+
+// ============================================================================
+// SlotHealth
+// ============================================================================
+
+TEST_CASE("SlotHealth: backs off from the threshold on, doubling up to the ceiling", "[scheduler]") {
+    SlotHealth h = {};
+    CHECK_FALSE(h.miss(3, 600000, 3600000));
+    CHECK_FALSE(h.miss(3, 600000, 3600000));
+    CHECK(h.interval(600000, 3600000) == 600000);
+    CHECK(h.miss(3, 600000, 3600000));         // third miss quarantines
+    CHECK(h.quarantined());
+    CHECK(h.interval(600000, 3600000) == 1200000);
+    CHECK_FALSE(h.miss(3, 600000, 3600000));   // already quarantined
+    CHECK(h.interval(600000, 3600000) == 2400000);
+    h.miss(3, 600000, 3600000);
+    CHECK(h.interval(600000, 3600000) == 3600000);
+    const uint8_t backoff = h.backoff;
+    for (int i = 0; i < 300; i++)
+        h.miss(3, 600000, 3600000);
+    CHECK(h.backoff == backoff);               // stops growing at the ceiling
+    CHECK(h.misses == UINT8_MAX);
+}
+
+TEST_CASE("SlotHealth: the first valid answer restores the interval", "[scheduler]") {
+    SlotHealth h = {};
+    for (int i = 0; i < 5; i++)
+        h.miss(2, 30000, 3600000);
+    CHECK(h.answer());
+    CHECK_FALSE(h.quarantined());
+    CHECK(h.interval(30000, 3600000) == 30000);
+    CHECK_FALSE(h.answer());
+    // one miss short of the threshold again
+    CHECK_FALSE(h.miss(2, 30000, 3600000));
+}
+
+TEST_CASE("SlotHealth: an interval at or above the ceiling is kept", "[scheduler]") {
+    SlotHealth h = {};
+    CHECK(h.miss(1, 7200000, 3600000));
+    CHECK(h.quarantined());
+    CHECK(h.interval(7200000, 3600000) == 7200000);
+}
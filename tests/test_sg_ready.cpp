@@ -11,7 +11,7 @@ using Catch::Approx;
 // ============================================================================
 
 struct RecordedCall {
-    std::string type;   // "can", "mqtt", "save", "load"
+    std::string type;   // "can", "mqtt", "save", "load", "begin", "end"
     std::string key;
     std::string value;
 };
@@ -29,6 +29,14 @@ struct FakeIO : ISgReadyIO {
         calls.push_back({"can", signal, value});
     }
 
+    void beginCanWrites(const char* name) override {
+        calls.push_back({"begin", name, ""});
+    }
+
+    void endCanWrites() override {
+        calls.push_back({"end", "", ""});
+    }
+
     void publishMqtt(const char* topic, const char* value) override {
         calls.push_back({"mqtt", topic, value});
     }
@@ -338,3 +346,21 @@ TEST_CASE("boost state is cleared after state 2", "[sg_ready]") {
 
     CHECK(io.savedActive == false);
 }
+
+TEST_CASE("the writes of a state change are bracketed as one transaction", "[sg_ready]") {
+    FakeIO io;
+    SgReadyController ctrl(io);
+
+    ctrl.applyState(SgReadyController::STATE_FORCED);
+
+    // begin, three writes in order, end — nothing written outside the bracket
+    std::vector<std::string> sequence;
+    for (auto& c : io.calls)
+        if (c.type != "mqtt" && c.type != "save") sequence.push_back(c.type + ":" + c.key);
+    REQUIRE(sequence.size() == 5);
+    CHECK(sequence[0] == "begin:4 - Zwang");
+    CHECK(sequence[1] == "can:PROGRAMMSCHALTER");
+    CHECK(sequence[2] == "can:EINSTELL_SPEICHERSOLLTEMP");
+    CHECK(sequence[3] == "can:RAUMSOLLTEMP_I");
+    CHECK(sequence[4] == "end:");
+}
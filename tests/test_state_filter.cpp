@@ -0,0 +1,148 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/state_filter.h"
+
+static const uint32_t HEARTBEAT_MS = 600000;
+
+// ============================================================================
+// Change detection
+// ============================================================================
+
+TEST_CASE("StateFilter: the first value of an entity is published", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    CHECK(filter.check(last, "21.5", true, 215, 1, 0.1f, 1000) == StateFilter::PUBLISH_CHANGED);
+    CHECK(last.valid);
+    CHECK(last.publishedMs == 1000);
+    CHECK(filter.published() == 1);
+}
+
+TEST_CASE("StateFilter: an unchanged value is suppressed", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "on", true, 1, 0, 0.0f, 0);
+    CHECK(filter.check(last, "on", true, 1, 0, 0.0f, 30000) == StateFilter::SUPPRESS_UNCHANGED);
+    CHECK(filter.suppressedUnchanged() == 1);
+    CHECK(last.publishedMs == 0);
+}
+
+TEST_CASE("StateFilter: deadband 0 publishes every change", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "off", true, 0, 0, 0.0f, 0);
+    CHECK(filter.check(last, "on", true, 1, 0, 0.0f, 30000) == StateFilter::PUBLISH_CHANGED);
+    CHECK(filter.check(last, "Tagbetrieb", false, 0, 0, 0.0f, 60000) == StateFilter::PUBLISH_CHANGED);
+}
+
+TEST_CASE("StateFilter: texts without a number are compared as text", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "Tagbetrieb", false, 0, 0, 0.5f, 0);
+    CHECK(filter.check(last, "Tagbetrieb", false, 0, 0, 0.5f, 1000) == StateFilter::SUPPRESS_UNCHANGED);
+    CHECK(filter.check(last, "Absenkbetrieb", false, 0, 0, 0.5f, 2000) == StateFilter::PUBLISH_CHANGED);
+}
+
+// ============================================================================
+// Deadband
+// ============================================================================
+
+TEST_CASE("StateFilter: a change within the deadband is suppressed", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "21.5", true, 215, 1, 0.1f, 0);
+    CHECK(filter.check(last, "21.6", true, 216, 1, 0.1f, 1000) == StateFilter::SUPPRESS_DEADBAND);
+    CHECK(filter.check(last, "21.4", true, 214, 1, 0.1f, 2000) == StateFilter::SUPPRESS_DEADBAND);
+    CHECK(filter.check(last, "21.7", true, 217, 1, 0.1f, 3000) == StateFilter::PUBLISH_CHANGED);
+    CHECK(filter.suppressedDeadband() == 2);
+}
+
+TEST_CASE("StateFilter: the deadband is measured from the last published value", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "20.0", true, 200, 1, 0.1f, 0);
+    CHECK(filter.check(last, "20.1", true, 201, 1, 0.1f, 1000) == StateFilter::SUPPRESS_DEADBAND);
+    // A slow drift is published once it leaves the deadband
+    CHECK(filter.check(last, "20.2", true, 202, 1, 0.1f, 2000) == StateFilter::PUBLISH_CHANGED);
+    CHECK(last.fixed == 202);
+}
+
+TEST_CASE("StateFilter: the deadband is scaled to the decimals of the value", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "1.250", true, 1250, 3, 0.7f, 0);
+    CHECK(filter.check(last, "1.257", true, 1257, 3, 0.7f, 1000) == StateFilter::SUPPRESS_DEADBAND);
+    CHECK(filter.check(last, "1.950", true, 1950, 3, 0.7f, 2000) == StateFilter::SUPPRESS_DEADBAND);
+    CHECK(filter.check(last, "1.951", true, 1951, 3, 0.7f, 3000) == StateFilter::PUBLISH_CHANGED);
+}
+
+TEST_CASE("StateFilter: values with other decimals are always compared as text", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "21.5", true, 215, 1, 0.1f, 0);
+    CHECK(filter.check(last, "21.50", true, 2150, 2, 0.1f, 1000) == StateFilter::PUBLISH_CHANGED);
+}
+
+// ============================================================================
+// Heartbeat
+// ============================================================================
+
+TEST_CASE("StateFilter: an unchanged value is published after the heartbeat interval", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "21.5", true, 215, 1, 0.1f, 5000);
+    CHECK(filter.check(last, "21.5", true, 215, 1, 0.1f, 5000 + HEARTBEAT_MS - 1) == StateFilter::SUPPRESS_UNCHANGED);
+    CHECK(filter.check(last, "21.6", true, 216, 1, 0.1f, 5000 + HEARTBEAT_MS) == StateFilter::PUBLISH_HEARTBEAT);
+    CHECK(last.fixed == 216);
+    CHECK(filter.check(last, "21.6", true, 216, 1, 0.1f, 5000 + HEARTBEAT_MS + 1) == StateFilter::SUPPRESS_UNCHANGED);
+    CHECK(filter.heartbeats() == 1);
+    CHECK(filter.published() == 2);
+}
+
+TEST_CASE("StateFilter: a changed value after the heartbeat interval is a change", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    filter.check(last, "21.5", true, 215, 1, 0.1f, 0);
+    CHECK(filter.check(last, "23.0", true, 230, 1, 0.1f, HEARTBEAT_MS + 1000) == StateFilter::PUBLISH_CHANGED);
+    CHECK(filter.heartbeats() == 0);
+    CHECK(last.fixed == 230);
+}
+
+TEST_CASE("StateFilter: the heartbeat survives the millis() wraparound", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState last;
+    const uint32_t start = 0xFFFFFFFFu - 1000;
+    filter.check(last, "on", true, 1, 0, 0.0f, start);
+    CHECK(filter.check(last, "on", true, 1, 0, 0.0f, start + 2000) == StateFilter::SUPPRESS_UNCHANGED);
+    CHECK(filter.check(last, "on", true, 1, 0, 0.0f, start + HEARTBEAT_MS) == StateFilter::PUBLISH_HEARTBEAT);
+}
+
+TEST_CASE("StateFilter: heartbeat 0 never republishes an unchanged value", "[filter]") {
+    StateFilter filter;
+    PublishedState last;
+    filter.check(last, "on", true, 1, 0, 0.0f, 0);
+    CHECK(filter.check(last, "on", true, 1, 0, 0.0f, 0x7FFFFFFF) == StateFilter::SUPPRESS_UNCHANGED);
+}
+
+// ============================================================================
+// Counters
+// ============================================================================
+
+TEST_CASE("StateFilter: counts published and suppressed values", "[filter]") {
+    StateFilter filter(HEARTBEAT_MS);
+    PublishedState a, b;
+    filter.check(a, "21.5", true, 215, 1, 0.1f, 0);
+    filter.check(b, "on", true, 1, 0, 0.0f, 0);
+    filter.check(a, "21.6", true, 216, 1, 0.1f, 1000);
+    filter.check(b, "on", true, 1, 0, 0.0f, 1000);
+    filter.check(b, "off", true, 0, 0, 0.0f, 2000);
+
+    CHECK(filter.published() == 3);
+    CHECK(filter.suppressedDeadband() == 1);
+    CHECK(filter.suppressedUnchanged() == 1);
+    CHECK(filter.suppressed() == 2);
+    CHECK(StateFilter::publishes(StateFilter::PUBLISH_HEARTBEAT));
+    CHECK_FALSE(StateFilter::publishes(StateFilter::SUPPRESS_DEADBAND));
+
+    filter.resetCounters();
+    CHECK(filter.published() == 0);
+    CHECK(filter.suppressed() == 0);
+}
@@ -0,0 +1,71 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "../esphome/ha-stiebel-control/string_arena.h"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("StringArena: add copies and terminates", "[arena]") {
+    StringArena<64> arena;
+    const char src[] = "AUSSENTEMP-and-more";
+    const char* s = arena.add(src, 10);
+    REQUIRE(s != nullptr);
+    CHECK(std::string(s) == "AUSSENTEMP");
+    CHECK(s != src);
+    CHECK(arena.size() == 11);
+    CHECK(arena.blocks() == 1);
+}
+
+TEST_CASE("StringArena: format writes printf output", "[arena]") {
+    StringArena<64> arena;
+    const char* s = arena.format("heatingpump/%s/%s/state", "MANAGER", "AUSSENTEMP");
+    REQUIRE(s != nullptr);
+    CHECK(std::string(s) == "heatingpump/MANAGER/AUSSENTEMP/state");
+    CHECK(arena.size() == std::string(s).size() + 1);
+}
+
+TEST_CASE("StringArena: nothing is taken from the heap before the first string", "[arena]") {
+    StringArena<64> arena;
+    CHECK(arena.blocks() == 0);
+    CHECK(arena.capacity() == 0);
+}
+
+TEST_CASE("StringArena: opens a new block when one is full, old strings stay valid", "[arena]") {
+    StringArena<16> arena;
+    std::vector<const char*> strings;
+    for (int i = 0; i < 10; i++)
+        strings.push_back(arena.format("name_%d", i));    // 7 bytes each, 2 per block
+    CHECK(arena.blocks() == 5);
+    for (int i = 0; i < 10; i++)
+        CHECK(std::string(strings[i]) == "name_" + std::to_string(i));
+    CHECK(arena.size() == 70);
+    CHECK(arena.capacity() >= 5 * 16);
+}
+
+TEST_CASE("StringArena: a string that exactly fills a block fits", "[arena]") {
+    StringArena<8> arena;
+    const char* s = arena.add("1234567", 7);
+    REQUIRE(s != nullptr);
+    CHECK(std::string(s) == "1234567");
+    CHECK(arena.blocks() == 1);
+}
+
+TEST_CASE("StringArena: a string longer than a block is refused", "[arena]") {
+    StringArena<8> arena;
+    CHECK(arena.add("12345678", 8) == nullptr);
+    CHECK(arena.format("%s", "12345678") == nullptr);
+    CHECK(arena.size() == 0);
+    CHECK(arena.add("ok", 2) != nullptr);
+}
+
+TEST_CASE("StringArena: clear frees all blocks and starts over", "[arena]") {
+    StringArena<16> arena;
+    arena.format("%s", "first");
+    arena.format("%s", "second string");
+    arena.clear();
+    CHECK(arena.blocks() == 0);
+    CHECK(arena.size() == 0);
+    const char* s = arena.format("%s", "again");
+    REQUIRE(s != nullptr);
+    CHECK(std::string(s) == "again");
+    CHECK(arena.blocks() == 1);
+}